@@ -0,0 +1,169 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+
+// AsyncLogProcessor.hpp 异步日志处理器头文件
+
+// include/log/AsyncLogProcessor.hpp
+#pragma once
+
+#include "LogMessage.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Log {
+
+    struct LogDescriptor;
+
+    // 队列满时的处理策略
+    enum class OverflowPolicy : uint8_t {
+        BLOCK,          // 等待后台线程腾出空间（不丢日志）
+        DROP,           // 直接丢弃
+        DROP_AND_COUNT  // 丢弃并计数，后台线程写出一条丢弃条数的警告
+    };
+
+    // 异步日志配置
+    struct AsyncOptions {
+        size_t queue_size{ 8192 };                                  // 环形队列容量（向上取2的幂）
+        OverflowPolicy overflow_policy{ OverflowPolicy::BLOCK };
+        std::chrono::milliseconds idle_wait{ 50 };                  // 队列为空时后台线程的最长休眠时间
+    };
+
+    // steady_clock 当前纳秒数（异步记录与二进制日志的时间戳）
+    inline uint64_t SteadyNanoseconds() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // 队列中的一条日志记录：
+    // 文本记录（descriptor 为空）的内容已在调用线程生成；延迟格式化的记录只保存调用点描述符与
+    // 编码后的参数（编码见 BinaryLog.hpp），由后台线程解码、格式化，调用线程不分配内存。
+    // 时间戳为 steady_clock 纳秒，写出时再换算为系统时间
+    struct AsyncRecord {
+        static constexpr size_t kInlinePayload = 128;                   // 编码超过该长度时改为在调用线程格式化
+
+        Level level{ Level::LVL_INFO };
+        const char* file{ "" };
+        int line{ 0 };
+        const char* function{ "" };
+        const LogDescriptor* descriptor{ nullptr };
+        uint64_t steady_ns{ 0 };
+        std::thread::id thread_id;
+        uint32_t thread_number{ 0 };                                    // 二进制日志中的线程序号
+        std::string text;
+        uint32_t payload_size{ 0 };
+        char payload[kInlinePayload];
+
+        AsyncRecord() = default;
+
+        // 参数缓冲区只复制已使用的部分
+        AsyncRecord(AsyncRecord&& other) noexcept
+            : level(other.level)
+            , file(other.file)
+            , line(other.line)
+            , function(other.function)
+            , descriptor(other.descriptor)
+            , steady_ns(other.steady_ns)
+            , thread_id(other.thread_id)
+            , thread_number(other.thread_number)
+            , text(std::move(other.text))
+            , payload_size(other.payload_size) {
+            std::memcpy(payload, other.payload, payload_size);
+        }
+
+        AsyncRecord& operator=(AsyncRecord&&) = delete;
+
+        std::string_view Payload() const { return { payload, payload_size }; }
+    };
+
+    // 异步日志处理器：
+    // 生产者把日志记录放入有界无锁多生产者单消费者环形队列（Vyukov 算法，每个槽位一个序号，
+    // 入队只有一次 CAS 与一次 release 写），唯一的后台线程取出记录、格式化并写入各 Sink。
+    // 后台线程休眠时生产者才需要加锁唤醒，其余情况下入队不进入内核。
+    class AsyncLogProcessor {
+    public:
+        // 后台线程对每条记录的处理（格式化并写入 Sink），可以移走记录中的文本
+        using Handler = std::function<void(AsyncRecord&)>;
+
+        // 运行统计
+        struct Stats {
+            uint64_t total_processed;
+            uint64_t dropped_messages;
+            size_t queue_size;                                      // 当前队列中的记录数（近似）
+            size_t capacity;
+        };
+
+        explicit AsyncLogProcessor(Handler handler, const AsyncOptions& options = {});
+        ~AsyncLogProcessor();
+
+        AsyncLogProcessor(const AsyncLogProcessor&) = delete;
+        AsyncLogProcessor& operator=(const AsyncLogProcessor&) = delete;
+
+        void Start();
+        // 写完队列中的剩余记录后停止
+        void Stop();
+        bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+
+        // 提交一条日志；force_block 为真时无论策略如何都等待入队（用于 FATAL）。
+        // 未运行时返回 false 且不移动 record，调用方应改为同步写入；按策略丢弃也视为已处理（返回 true）
+        bool Submit(AsyncRecord&& record, bool force_block = false);
+
+        // 等待此前提交的记录全部交给处理函数（在后台线程中调用时直接返回）
+        void Flush();
+
+        Stats GetStats() const;
+        const AsyncOptions& GetOptions() const { return options_; }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            alignas(AsyncRecord) unsigned char storage[sizeof(AsyncRecord)];
+        };
+
+        bool TryPush(AsyncRecord& record);
+        // 入队成功后：唤醒休眠的后台线程；处理器已停止时自行写出队列中的记录
+        void Published();
+        // 处理队列中已发布的记录，返回处理条数
+        size_t Drain();
+        void ReportDropped();
+        void Wake();
+        void WorkerThread();
+
+    private:
+        static constexpr size_t kCacheLine = 64;
+
+        Handler handler_;
+        AsyncOptions options_;
+        size_t capacity_;
+        size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+
+        alignas(kCacheLine) std::atomic<size_t> enqueue_pos_{ 0 };
+        alignas(kCacheLine) std::atomic<size_t> dequeue_pos_{ 0 };  // 只由后台线程写
+        alignas(kCacheLine) std::atomic<bool> worker_sleeping_{ false };
+
+        std::atomic<bool> running_{ false };
+        std::atomic<uint64_t> processed_count_{ 0 };
+        std::atomic<uint64_t> dropped_count_{ 0 };
+        std::atomic<uint64_t> unreported_drops_{ 0 };
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_cv_;
+        bool wake_requested_{ false };
+        std::condition_variable drained_cv_;                        // 通知等待 Flush 的线程
+
+        std::mutex lifecycle_mutex_;                                // 串行化 Start/Stop 与停止后的补充处理
+        std::thread worker_thread_;
+        std::atomic<std::thread::id> worker_id_{};
+    };
+
+} // namespace Log
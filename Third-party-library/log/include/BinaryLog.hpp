@@ -0,0 +1,231 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+
+// include/log/BinaryLog.hpp
+
+
+
+#pragma once
+
+#include "LogLevel.hpp"
+#include "Format.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Log
+{
+
+    // 二进制日志：
+    // 每个调用点有一个静态描述符（级别、位置、格式串、参数类型），第一次执行时注册得到编号；
+    // 每条记录只包含描述符编号、steady_clock 纳秒时间戳、线程序号与原样复制的参数，
+    // 不在写入线程格式化。文本由离线工具 refstorage_logdecode 还原。
+    // 异步模式下 LOG_*_FMT 也使用同样的编码：调用线程只把参数原值放入队列，由后台线程格式化。
+
+    // 调用点描述符（静态存储，由 LOG_*_BIN / LOG_*_FMT 宏定义，常量初始化）
+    struct LogDescriptor
+    {
+        Level level;
+        const char* file;
+        int line;
+        const char* function;
+        const char* format;
+        const char* arg_types{ nullptr };       // 注册时填入，见 binary::Signature
+        std::atomic<uint32_t> id{ 0 };           // 0 表示尚未注册
+
+        constexpr LogDescriptor(Level lvl, const char* f, int l, const char* func, const char* fmt)
+            : level(lvl), file(f), line(l), function(func), format(fmt) {
+        }
+    };
+
+    namespace binary
+    {
+        // 文件格式（本机字节序）：
+        //   文件头：kMagic[8]，u32 kByteOrderMark，u64 打开时的 system_clock 纳秒，u64 打开时的 steady_clock 纳秒
+        //   记录：u8 RecordType，随后
+        //     DESCRIPTOR：u32 编号，u8 级别，u32 行号，字符串 文件、函数、格式串、参数类型
+        //     EVENT：     u32 编号，u64 steady 纳秒，u32 线程序号，u32 参数字节数，参数
+        //     TEXT：      u8 级别，u64 steady 纳秒，u32 线程序号，u32 行号，字符串 文件、函数、内容
+        //   字符串为 u32 长度加字节；描述符在文件中第一次被事件引用之前写出
+        inline constexpr char kMagic[8] = { 'R', 'S', 'B', 'L', 'O', 'G', '1', '\0' };
+        inline constexpr uint32_t kByteOrderMark = 0x01020304;
+
+        enum class RecordType : uint8_t
+        {
+            DESCRIPTOR = 1,
+            EVENT = 2,
+            TEXT = 3
+        };
+
+        // 参数类型码：整数统一扩展为 64 位，float 保持 32 位（还原的文本与直接格式化相同），
+        // 其他浮点数为 double，字符串为长度加字节
+        inline constexpr char kBool = 'b';
+        inline constexpr char kChar = 'c';
+        inline constexpr char kInt = 'i';
+        inline constexpr char kUInt = 'u';
+        inline constexpr char kFloat = 'f';
+        inline constexpr char kDouble = 'd';
+        inline constexpr char kString = 's';
+
+        // 可编码的参数类型（不满足时 TypeCode 编译失败）
+        template<typename T>
+        constexpr bool IsEncodable()
+        {
+            using U = std::remove_cvref_t<std::decay_t<T>>;
+            if constexpr (std::is_enum_v<U>) return IsEncodable<std::underlying_type_t<U>>();
+            else return std::is_integral_v<U> || std::is_floating_point_v<U>
+                || std::is_same_v<U, const char*> || std::is_same_v<U, char*>
+                || std::is_convertible_v<const U&, std::string_view>;
+        }
+
+        // 编码后由 RenderTo 还原的文本与 Format 直接格式化的结果相同（long double 编码时会损失精度）
+        template<typename T>
+        inline constexpr bool kDeferrable = IsEncodable<T>() && !std::is_same_v<std::remove_cvref_t<T>, long double>;
+
+        template<typename T>
+        constexpr char TypeCode()
+        {
+            using U = std::remove_cvref_t<std::decay_t<T>>;
+            if constexpr (std::is_same_v<U, bool>) return kBool;
+            else if constexpr (std::is_same_v<U, char>) return kChar;
+            else if constexpr (std::is_enum_v<U>) return TypeCode<std::underlying_type_t<U>>();
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) return kInt;
+            else if constexpr (std::is_integral_v<U>) return kUInt;
+            else if constexpr (std::is_same_v<U, float>) return kFloat;
+            else if constexpr (std::is_floating_point_v<U>) return kDouble;
+            else if constexpr (IsEncodable<U>()) return kString;
+            else {
+                static_assert(!std::is_same_v<U, U>, "二进制日志只支持整数、浮点数、bool、字符与字符串参数");
+                return '\0';
+            }
+        }
+
+        // 参数类型串，每种参数组合一份静态常量
+        template<typename... Args>
+        struct Signature
+        {
+            static constexpr char value[] = { TypeCode<Args>()..., '\0' };
+        };
+
+        inline void AppendRaw(std::string& out, const void* data, size_t size)
+        {
+            out.append(static_cast<const char*>(data), size);
+        }
+
+        inline void AppendString(std::string& out, std::string_view text)
+        {
+            auto size = static_cast<uint32_t>(text.size());
+            AppendRaw(out, &size, sizeof(size));
+            out.append(text);
+        }
+
+        template<typename T>
+        void Encode(std::string& out, const T& value)
+        {
+            constexpr char code = TypeCode<T>();
+            if constexpr (code == kBool || code == kChar) {
+                char raw = static_cast<char>(value);
+                AppendRaw(out, &raw, 1);
+            }
+            else if constexpr (code == kInt) {
+                auto raw = static_cast<int64_t>(value);
+                AppendRaw(out, &raw, sizeof(raw));
+            }
+            else if constexpr (code == kUInt) {
+                auto raw = static_cast<uint64_t>(value);
+                AppendRaw(out, &raw, sizeof(raw));
+            }
+            else if constexpr (code == kFloat) {
+                auto raw = static_cast<float>(value);
+                AppendRaw(out, &raw, sizeof(raw));
+            }
+            else if constexpr (code == kDouble) {
+                auto raw = static_cast<double>(value);
+                AppendRaw(out, &raw, sizeof(raw));
+            }
+            else if constexpr (std::is_pointer_v<std::remove_cvref_t<T>>) {
+                // 只有指针可能为空；字符数组（字符串字面量）直接按字符串处理
+                AppendString(out, value ? std::string_view(value) : std::string_view());
+            }
+            else {
+                AppendString(out, std::string_view(value));
+            }
+        }
+
+        // 当前线程复用的参数编码缓冲区
+        std::string& ThreadPayload();
+
+        // 当前线程的序号（进程内从 1 开始），比 std::thread::id 更短且可写入文件
+        uint32_t ThreadNumber();
+
+        // 按类型串解码参数为文本，数据不完整时返回 false
+        bool DecodeArgs(std::string_view types, std::string_view payload, std::vector<std::string>& args);
+
+        // 用解码后的参数填充格式串
+        std::string Render(std::string_view format, const std::vector<std::string>& args);
+
+        // 按类型串解码参数并直接按格式串追加到 out（后台线程使用，参数不逐个转成字符串），数据不完整时返回 false
+        bool RenderTo(std::string& out, std::string_view format, std::string_view types, std::string_view payload);
+    }
+
+    // 注册调用点描述符，返回编号（多个线程同时注册同一调用点时只分配一次）
+    uint32_t RegisterDescriptor(LogDescriptor& descriptor, const char* arg_types);
+
+    // 按编号查找已注册的描述符，不存在时返回 nullptr
+    const LogDescriptor* FindDescriptor(uint32_t id);
+
+    // 写入一条二进制日志（由 LOG_*_BIN 宏调用，级别已检查）
+    void DispatchBinary(const LogDescriptor& descriptor, std::string_view payload);
+
+    // 异步模式下把编码后的参数放入队列（由 LOG_*_FMT 调用，级别已检查）；
+    // 未处于异步模式或编码过长时返回 false，调用方改为在本线程格式化
+    bool AsyncEnabled();
+    bool SubmitEncoded(const LogDescriptor& descriptor, std::string_view payload);
+
+    // 写入在本线程格式化好的文本（级别已检查）
+    void DispatchText(const LogDescriptor& descriptor, std::string&& text);
+
+    template<typename... Args>
+    void LogBinary(LogDescriptor& descriptor, FormatStr<Args...>, const Args&... args)
+    {
+        if (descriptor.id.load(std::memory_order_acquire) == 0) {
+            RegisterDescriptor(descriptor, binary::Signature<Args...>::value);
+        }
+
+        std::string& payload = binary::ThreadPayload();
+        payload.clear();
+        (binary::Encode(payload, args), ...);
+        DispatchBinary(descriptor, payload);
+    }
+
+    // 带格式化的日志（LOG_*_FMT）：异步模式下参数都可编码时只复制原值入队，格式化在后台线程进行；
+    // 同步模式、含其他类型的参数或编码过长时在本线程格式化
+    template<typename... Args>
+    void LogFormatted(LogDescriptor& descriptor, FormatStr<Args...> fmt, const Args&... args)
+    {
+        if constexpr ((binary::kDeferrable<Args> && ...))
+        {
+            if (AsyncEnabled())
+            {
+                if (descriptor.id.load(std::memory_order_acquire) == 0) {
+                    RegisterDescriptor(descriptor, binary::Signature<Args...>::value);
+                }
+
+                std::string& payload = binary::ThreadPayload();
+                payload.clear();
+                (binary::Encode(payload, args), ...);
+                if (SubmitEncoded(descriptor, payload)) {
+                    return;
+                }
+            }
+        }
+        DispatchText(descriptor, Format(fmt, args...));
+    }
+
+} // namespace Log
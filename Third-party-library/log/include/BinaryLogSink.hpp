@@ -0,0 +1,50 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+// include/log/BinaryLogSink.hpp
+
+
+
+#pragma once
+
+#include "LogSink.hpp"
+#include "BinaryLog.hpp"
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace Log
+{
+
+    // 二进制文件输出（格式见 BinaryLog.hpp）：
+    // LOG_*_BIN 的记录只复制描述符编号、时间戳与参数；普通文本日志以 TEXT 记录写入同一文件，
+    // 用 refstorage_logdecode 还原为文本
+    class BinaryLogSink : public Sink
+    {
+    public:
+        explicit BinaryLogSink(const std::string& filename, Level min_level = Level::LVL_TRACE);
+        ~BinaryLogSink();
+
+        void Write(const Message& msg) override;
+        bool WriteBinary(const LogDescriptor& descriptor, uint32_t thread, uint64_t steady_ns,
+            std::string_view payload) override;
+        void Flush() override;
+        bool ShouldLog(Level level) const override;
+        // 二进制格式不使用格式化器
+        void SetFormatter(std::unique_ptr<Formatter> formatter) override;
+
+    private:
+        void EnsureFileOpen();
+        // 描述符第一次出现在本文件中时写出（调用方持有 mutex_）
+        void EmitDescriptor(const LogDescriptor& descriptor, uint32_t id);
+
+    private:
+        mutable std::mutex mutex_;
+        std::ofstream file_;
+        std::string filename_;
+        Level min_level_;
+        std::string record_;                    // 复用的记录缓冲区（由 mutex_ 保护）
+        std::vector<bool> emitted_;             // 已写出的描述符编号
+    };
+
+} // namespace Log
@@ -45,20 +45,21 @@ namespace Log {
 
         // ��ʽ����Ϣ������ɫ����
         std::string Format(const Message& msg) const override;
+        void FormatTo(const Message& msg, std::string& out) const override;
 
         // �����Ƿ�ʹ����ɫ
         void SetUseColors(bool use_colors) { use_colors_ = use_colors; }
 
         // ��ȡ��ɫ����
-        static std::string GetColorCode(Level level);
-        static std::string GetResetCode();
+        static const char* GetColorCode(Level level);
+        static const char* GetResetCode();
 
     private:
         // ��ɫ�����ʵ��
-        std::string ApplyColoring(const Message& msg) const;
+        void ApplyColoring(const Message& msg, std::string& out) const;
 
         // �������ͻ�ȡ�ı�
-        std::string GetTextForRegion(const ColorRegion& region, const Message& msg) const;
+        void AppendRegion(const ColorRegion& region, const Message& msg, std::string& out) const;
 
     private:
         std::vector<ColorRegion> regions_;
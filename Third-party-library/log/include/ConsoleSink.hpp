@@ -9,20 +9,36 @@
 
 #include "LogSink.hpp"
 #include "ColoredFormatter.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <iostream>
+#include <thread>
 
 namespace Log
 {
 
+    // 控制台批量输出的配置
+    struct ConsoleBatchOptions
+    {
+        size_t max_bytes{ 64 * 1024 };  // 缓冲达到该字节数时立即写出（0 表示每条日志直接写出）
+        uint32_t max_delay_ms{ 100 };   // 缓冲中最早一条日志最多等待的毫秒数
+    };
+
+    // 控制台输出：
+    // ERROR 以下的日志格式化后追加到批量缓冲区，达到 max_bytes 或等待超过 max_delay_ms（由后台线程检查）时
+    // 用一次 write 写到标准输出，不再每条日志 flush 一次；ERROR 及以上先写出已缓冲的内容再直接写到标准错误，
+    // 保证顺序且不延迟。颜色由 ColoredFormatter 写入缓冲区，与逐条输出时相同。
     class ConsoleSink : public Sink
     {
     public:
         ConsoleSink(Level min_level = Level::LVL_INFO,
             bool use_colors = true,
-            const std::string& pattern = "");
+            const std::string& pattern = "",
+            const ConsoleBatchOptions& batch = {});
 
-        ~ConsoleSink() = default;
+        ~ConsoleSink();
 
         void Write(const Message& msg) override;
         void Flush() override;
@@ -37,12 +53,26 @@ namespace Log
         void EnableANSIColorSupport() const;
 #endif
 
+        // 写出批量缓冲区（调用方持有 mutex_）
+        void FlushPending();
+
+        // 后台线程：缓冲区非空时等待到期后写出
+        void FlushThread();
+
     private:
         mutable std::mutex mutex_;
         Level min_level_;
         bool use_colors_;
         std::unique_ptr<ColoredFormatter> colored_formatter_;
         std::unique_ptr<Formatter> formatter_;
+        std::string buffer_;                    // 复用的格式化缓冲区（由 mutex_ 保护）
+
+        ConsoleBatchOptions batch_;
+        std::string pending_;                   // 等待写到标准输出的日志（由 mutex_ 保护）
+        std::chrono::steady_clock::time_point pending_since_;
+        std::condition_variable flush_cv_;
+        bool stopping_{ false };
+        std::thread flush_thread_;              // 第一次缓冲日志时启动
     };
 
 } // namespace Log
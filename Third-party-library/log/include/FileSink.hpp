@@ -9,19 +9,36 @@
 
 #include "LogSink.hpp"
 #include "LogFormatter.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <mutex>
 #include <filesystem>
+#include <thread>
 
 namespace Log
 {
 
+    // 按大小轮转的配置
+    struct RotationOptions
+    {
+        uint64_t max_size{ 0 };     // 当前文件超过该字节数后轮转（0 表示不轮转）
+        int max_files{ 0 };         // 最多保留的已轮转文件数（0 表示全部保留）
+        bool compress{ true };      // 后台压缩已轮转文件（需要 zlib，即定义了 LOG_HAS_ZLIB）
+    };
+
+    // 文件输出：
+    // 已写字节数由原子计数器累计（打开文件时读取一次文件大小），超过 max_size 时在锁内关闭、
+    // 改名为 <文件名>.<时间>.<序号><扩展名> 并重新打开，写入线程只等待这一次改名；
+    // 压缩与按 max_files 清理旧文件在后台线程中进行。
     class FileSink : public Sink
     {
     public:
         explicit FileSink(const std::string& filename,
             Level min_level = Level::LVL_INFO,
-            const std::string& pattern = "");
+            const std::string& pattern = "",
+            const RotationOptions& rotation = {});
         ~FileSink();
 
         void Write(const Message& msg) override;
@@ -29,16 +46,41 @@ namespace Log
         bool ShouldLog(Level level) const override;
         void SetFormatter(std::unique_ptr<Formatter> formatter) override;
 
+        // 当前文件已写入的字节数
+        uint64_t GetWrittenBytes() const { return written_bytes_.load(std::memory_order_relaxed); }
+
     private:
         // ȷ���ļ���
         void EnsureFileOpen();
 
+        // 轮转当前文件（调用方持有 mutex_）
+        void Rotate();
+        std::filesystem::path NextRotatedPath();
+        // 判断是否为本 Sink 轮转出的文件名
+        bool IsRotatedFile(const std::string& name) const;
+
+        // 后台线程：压缩已轮转的文件并清理超出保留数的旧文件
+        void MaintenanceThread();
+        void CompressFile(const std::filesystem::path& path) const;
+        void EnforceRetention() const;
+
     private:
         mutable std::mutex mutex_;
         std::ofstream file_;
         std::string filename_;
         Level min_level_;
         std::unique_ptr<Formatter> formatter_;
+        std::string buffer_;                    // 复用的格式化缓冲区（由 mutex_ 保护）
+
+        RotationOptions rotation_;
+        std::atomic<uint64_t> written_bytes_{ 0 };
+        uint64_t rotation_seq_{ 0 };
+
+        std::mutex maintenance_mutex_;
+        std::condition_variable maintenance_cv_;
+        std::deque<std::filesystem::path> pending_files_;
+        bool stopping_{ false };
+        std::thread maintenance_thread_;        // 第一次轮转时启动
     };
 
 } // namespace Log
@@ -8,67 +8,250 @@
 
 #pragma once
 
-#include <string>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 namespace Log
 {
 
+    // 格式化核心：占位符语法与 std::format 相同的子集——顺序占位符 {} 或位置占位符 {0} {1}（同一格式串中不能混用），
+    // {{ 与 }} 为转义。格式串在编译期检查（占位符越界、花括号不匹配、混用都会编译失败），
+    // 参数按类型擦除后交给非模板的格式化函数，整数与浮点数用 to_chars 直接写入线程本地缓冲区，不经过 ostringstream。
+    // 标准库提供 <format> 后可以把 VFormatTo 换成 std::vformat_to，调用方不需要改动。
+
     namespace detail
     {
+        // 编译期格式串检查失败：在常量求值中调用非 constexpr 函数，编译器报告此处
+        void FormatStringError(const char* reason);
+
+        // 检查格式串，返回是否通过（失败时在编译期报错）
+        consteval bool CheckFormatString(std::string_view fmt, size_t arg_count)
+        {
+            bool sequential = false;
+            bool positional = false;
+            size_t next_index = 0;
+
+            for (size_t i = 0; i < fmt.size(); ++i)
+            {
+                char c = fmt[i];
+                if (c == '}')
+                {
+                    if (i + 1 < fmt.size() && fmt[i + 1] == '}')
+                    {
+                        ++i;
+                        continue;
+                    }
+                    FormatStringError("格式串中有未配对的 '}'");
+                }
+                if (c != '{')
+                {
+                    continue;
+                }
+                if (i + 1 < fmt.size() && fmt[i + 1] == '{')
+                {
+                    ++i;
+                    continue;
+                }
+
+                size_t close = fmt.find('}', i + 1);
+                if (close == std::string_view::npos)
+                {
+                    FormatStringError("格式串中有未闭合的 '{'");
+                }
+
+                std::string_view field = fmt.substr(i + 1, close - i - 1);
+                size_t index = 0;
+                if (field.empty())
+                {
+                    sequential = true;
+                    index = next_index++;
+                }
+                else
+                {
+                    positional = true;
+                    for (char digit : field)
+                    {
+                        if (digit < '0' || digit > '9')
+                        {
+                            FormatStringError("占位符只能是 {} 或 {序号}");
+                        }
+                        index = index * 10 + static_cast<size_t>(digit - '0');
+                    }
+                }
+
+                if (sequential && positional)
+                {
+                    FormatStringError("同一格式串不能混用 {} 与 {序号}");
+                }
+                if (index >= arg_count)
+                {
+                    FormatStringError("占位符序号超出参数个数");
+                }
+                i = close;
+            }
+            return true;
+        }
+
+        // 类型擦除后的参数：对象地址加追加函数
+        struct FormatArg
+        {
+            const void* value;
+            void (*append)(std::string& out, const void* value);
+        };
+
+        template<typename T>
+        concept StreamInsertable = requires(std::ostream & os, const T & value) { os << value; };
+
         template<typename T>
-        std::string ToString(const T& value)
+        void AppendValue(std::string& out, const void* value)
         {
-            if constexpr (std::is_same_v<T, std::string>)
+            const T& ref = *static_cast<const T*>(value);
+
+            if constexpr (std::is_same_v<T, bool>)
             {
-                return value;
+                out += ref ? "true" : "false";
             }
-            else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+            else if constexpr (std::is_same_v<T, char>)
             {
-                return value ? std::string(value) : "";
+                out += ref;
             }
             else if constexpr (std::is_arithmetic_v<T>)
             {
-                return std::to_string(value);
+                char buffer[64];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), ref);
+                out.append(buffer, result.ptr);
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                auto underlying = static_cast<std::underlying_type_t<T>>(ref);
+                AppendValue<std::underlying_type_t<T>>(out, &underlying);
+            }
+            else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+            {
+                if (ref)
+                {
+                    out += ref;
+                }
             }
-            else {
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                out += std::string_view(ref);
+            }
+            else if constexpr (std::is_same_v<T, std::filesystem::path>)
+            {
+                // 与 std::format 一致：路径不能直接格式化（operator<< 会加引号），调用方传 path.string()
+                static_assert(!std::is_same_v<T, T>, "std::filesystem::path 请传 .string()");
+            }
+            else if constexpr (StreamInsertable<T>)
+            {
+                // 其他可输出到流的类型（如 std::thread::id），走 ostringstream
                 std::ostringstream oss;
-                oss << value;
-                return oss.str();
+                oss << ref;
+                out += oss.str();
+            }
+            else
+            {
+                static_assert(!std::is_same_v<T, T>, "不支持格式化该类型");
+            }
+        }
+
+        // 字符数组（字符串字面量）：value 直接指向字符数据
+        inline void AppendCharArray(std::string& out, const void* value)
+        {
+            out += static_cast<const char*>(value);
+        }
+
+        template<typename T>
+        FormatArg MakeArg(const T& value)
+        {
+            if constexpr (std::is_array_v<T>)
+            {
+                static_assert(std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>, "不支持格式化该类型");
+                return FormatArg{ value, &AppendCharArray };
+            }
+            else
+            {
+                return FormatArg{ &value, &AppendValue<T> };
             }
         }
+
+        // 按格式串把参数追加到 out；运行期遇到无效占位符时原样输出
+        void VFormatTo(std::string& out, std::string_view fmt, const FormatArg* args, size_t arg_count);
+
+        // 当前线程复用的格式化缓冲区
+        std::string& ThreadBuffer();
     }
 
-    // ������ʽ������
+    // 编译期检查的格式串，只能由常量表达式（字符串字面量）构造
     template<typename... Args>
-    std::string FormatString(const std::string& fmt, Args... args)
+    class BasicFormatString
     {
-        std::ostringstream oss;
-        size_t pos = 0;
+    public:
+        template<typename S>
+            requires std::convertible_to<const S&, std::string_view>
+        consteval BasicFormatString(const S& fmt)
+            : fmt_(fmt)
+        {
+            detail::CheckFormatString(fmt_, sizeof...(Args));
+        }
 
-        std::string args_str[] = { detail::ToString(args)... };
-        size_t arg_count = sizeof...(args);
+        constexpr std::string_view get() const { return fmt_; }
 
-        for (size_t i = 0; i < arg_count; ++i) {
-            std::string placeholder = "{" + std::to_string(i) + "}";
-            size_t placeholder_pos = fmt.find(placeholder, pos);
+    private:
+        std::string_view fmt_;
+    };
 
-            if (placeholder_pos != std::string::npos) {
-                oss << fmt.substr(pos, placeholder_pos - pos);
-                oss << args_str[i];
-                pos = placeholder_pos + placeholder.length();
-            }
-        }
+    template<typename... Args>
+    using FormatStr = BasicFormatString<std::type_identity_t<Args>...>;
 
-        oss << fmt.substr(pos);
+    // 追加到调用方提供的字符串（复用其容量）
+    template<typename... Args>
+    void FormatTo(std::string& out, FormatStr<Args...> fmt, const Args&... args)
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            detail::VFormatTo(out, fmt.get(), nullptr, 0);
+        }
+        else
+        {
+            const detail::FormatArg format_args[] = { detail::MakeArg(args)... };
+            detail::VFormatTo(out, fmt.get(), format_args, sizeof...(Args));
+        }
+    }
 
-        return oss.str();
+    // 格式化为新字符串：先写入线程本地缓冲区，结果只分配一次
+    template<typename... Args>
+    std::string Format(FormatStr<Args...> fmt, const Args&... args)
+    {
+        std::string& buffer = detail::ThreadBuffer();
+        buffer.clear();
+        FormatTo(buffer, fmt, args...);
+        return std::string(buffer);
     }
 
-    // �ػ����޲����汾
-    inline std::string FormatString(const std::string& fmt) {
-        return fmt;
+    // 兼容旧接口：格式串在运行期解析，不做编译期检查（新代码使用 Format / LOG_*_FMT）
+    template<typename... Args>
+    std::string FormatString(std::string_view fmt, const Args&... args)
+    {
+        std::string& buffer = detail::ThreadBuffer();
+        buffer.clear();
+        if constexpr (sizeof...(Args) == 0)
+        {
+            detail::VFormatTo(buffer, fmt, nullptr, 0);
+        }
+        else
+        {
+            const detail::FormatArg format_args[] = { detail::MakeArg(args)... };
+            detail::VFormatTo(buffer, fmt, format_args, sizeof...(Args));
+        }
+        return std::string(buffer);
     }
 
 } // namespace Log
@@ -0,0 +1,77 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+// include/log/LogCallSite.hpp
+
+
+#pragma once
+
+#include "LogLevel.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace Log
+{
+
+    // 构建系统定义的源码根目录（CMake 中为 logging 目标的 PUBLIC 定义），推导模块名时不越过该目录
+#ifdef LOG_SOURCE_ROOT
+    inline constexpr std::string_view kSourceRoot = LOG_SOURCE_ROOT;
+#else
+    inline constexpr std::string_view kSourceRoot{};
+#endif
+
+    // 由源文件路径推导模块名：取所在目录名，目录为 src / include 时取上一级
+    // 例如 src/database/src/database_connector.cpp -> database，src/common/chunk_table.cpp -> common；
+    // 上一级已在源码根目录之外（如 src/main.cpp）时取文件名去掉扩展名（main）
+    constexpr std::string_view ModuleName(std::string_view path, std::string_view root = kSourceRoot)
+    {
+        auto is_separator = [](char c) { return c == '/' || c == '\\'; };
+
+        // 去掉源码根目录前缀（分隔符 / 与 \\ 视为相同），之后的目录都在源码树内
+        if (!root.empty() && path.size() > root.size() && is_separator(path[root.size()])) {
+            bool inside = true;
+            for (size_t i = 0; i < root.size() && inside; ++i) {
+                inside = path[i] == root[i] || (is_separator(path[i]) && is_separator(root[i]));
+            }
+            if (inside) {
+                path.remove_prefix(root.size() + 1);
+            }
+        }
+
+        // 文件名（不含扩展名），用作越出源码树时的模块名
+        size_t end = path.size();
+        while (end > 0 && !is_separator(path[end - 1])) {
+            --end;
+        }
+        std::string_view stem = path.substr(end);
+        stem = stem.substr(0, stem.find('.'));
+
+        // 从末尾向前依次取出目录名（跳过文件名）
+        for (int depth = 0; depth < 2 && end > 0; ++depth) {
+            size_t stop = end - 1;
+            size_t begin = stop;
+            while (begin > 0 && !is_separator(path[begin - 1])) {
+                --begin;
+            }
+            std::string_view directory = path.substr(begin, stop - begin);
+            if (directory != "src" && directory != "include") {
+                return directory;
+            }
+            end = begin;
+        }
+        return stem;
+    }
+
+    // 日志调用点：每个日志宏展开处一个静态实例（常量初始化，无首次调用开销），
+    // 缓存该调用点所属模块的生效级别；配置变化时全局代数递增，调用点下次执行时重新解析
+    struct CallSite
+    {
+        std::string_view module;
+        std::atomic<uint32_t> generation{ 0 };   // 0 表示尚未解析
+        std::atomic<Level> level{ Level::LVL_TRACE };
+
+        constexpr explicit CallSite(std::string_view module_name) : module(module_name) {}
+    };
+
+} // namespace Log
@@ -8,8 +8,10 @@
 #pragma once
 
 #include "LogLevel.hpp"
+#include "AsyncLogProcessor.hpp"
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <map>
 
 namespace Log
@@ -18,7 +20,7 @@ namespace Log
     // Sink����
     struct SinkConfig
     {
-        std::string type;  // "console", "file"
+        std::string type;  // "console", "file", "binary"
         Level min_level{ Level::LVL_INFO };
 
         // ͨ������
@@ -26,11 +28,14 @@ namespace Log
 
         // ����̨����
         bool use_colors{ true };
+        size_t batch_size{ 64 * 1024 };      // 批量输出：缓冲达到该字节数时写出（0 表示逐条写出）
+        uint32_t batch_delay_ms{ 100 };      // 批量输出：缓冲最长等待毫秒数
 
         // �ļ�����
         std::string filename;
         size_t max_size{ 100 * 1024 * 1024 };  // 100MB
         int max_files{ 10 };
+        bool compress{ true };  // 后台压缩已轮转的文件
 
         SinkConfig() = default;
         SinkConfig(const std::string& t) : type(t) {}
@@ -41,7 +46,14 @@ namespace Log
     {
         Level global_level{ Level::LVL_INFO };
         std::vector<SinkConfig> sinks;
-        std::map<std::string, Level> module_levels;
+        std::map<std::string, Level> module_levels;   // [modules] 段：模块名 = 级别
+
+        // 异步写入（async = true，async_queue_size，async_overflow = block / drop / drop_count）
+        bool async{ false };
+        AsyncOptions async_options;
+
+        // 解析级别名，接受 DEBUG 与 LVL_DEBUG 两种写法；无法识别时返回 false
+        static bool ParseLevel(const std::string& text, Level& level);
 
         // ���ļ�����
         static Config LoadFromFile(const std::string& path);
@@ -7,7 +7,9 @@
 #pragma once
 
 #include "LogMessage.hpp"
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 #include <map>
 
@@ -48,6 +50,9 @@ namespace Log {
         // ��ʽ����Ϣ
         virtual std::string Format(const Message& msg) const;
 
+        // 格式化并追加到调用方提供的缓冲区（Sink 复用同一缓冲区，稳定后不再分配内存）
+        virtual void FormatTo(const Message& msg, std::string& out) const;
+
         // ��ȡ��ǰģʽ
         std::string GetPattern() const { return pattern_; }
 
@@ -56,7 +61,13 @@ namespace Log {
         void ParsePattern(const std::string& pattern);
 
         // �滻ռλ��
-        virtual std::string ReplaceToken(FormatToken token, const Message& msg) const;
+        virtual void AppendToken(FormatToken token, const Message& msg, std::string& out) const;
+
+        // 各格式化器共用的字段输出
+        // 时间戳：按秒缓存 "YYYY-MM-DD HH:MM:SS"（每个线程一份），只追加毫秒
+        static void AppendTimestamp(std::chrono::system_clock::time_point timestamp, std::string& out);
+        // 线程ID：每个线程缓存最近遇到的线程ID字符串
+        static void AppendThreadId(std::thread::id id, std::string& out);
 
     protected:
         std::string pattern_;
@@ -8,48 +8,226 @@
 
 #include "Logger.hpp"
 #include "Format.hpp"
-
-// ������־��
-#define LOG_TRACE(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_TRACE, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-#define LOG_DEBUG(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_DEBUG, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-#define LOG_INFO(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_INFO, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-#define LOG_WARN(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_WARN, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-#define LOG_ERROR(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_ERROR, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-#define LOG_FATAL(msg) \
-    Log::Logger::Instance().Log(Log::Level::LVL_FATAL, \
-                                          __FILE__, __LINE__, __func__, std::string(msg))
-
-// ����ʽ������־��
-#define LOG_TRACE_FMT(fmt, ...) \
-    LOG_TRACE(Log::FormatString(fmt, ##__VA_ARGS__))
-
-#define LOG_DEBUG_FMT(fmt, ...) \
-    LOG_DEBUG(Log::FormatString(fmt, ##__VA_ARGS__))
-
-#define LOG_INFO_FMT(fmt, ...) \
-    LOG_INFO(Log::FormatString(fmt, ##__VA_ARGS__))
-
-#define LOG_WARN_FMT(fmt, ...) \
-    LOG_WARN(Log::FormatString(fmt, ##__VA_ARGS__))
-
-#define LOG_ERROR_FMT(fmt, ...) \
-    LOG_ERROR(Log::FormatString(fmt, ##__VA_ARGS__))
-
-#define LOG_FATAL_FMT(fmt, ...) \
-    LOG_FATAL(Log::FormatString(fmt, ##__VA_ARGS__))
-                                 
+#include "BinaryLog.hpp"
+#include "LogRateLimit.hpp"
+
+// 编译期级别：低于该级别的日志语句整体移除（0 TRACE，1 DEBUG，2 INFO，3 WARN，4 ERROR，5 FATAL）
+// 例如发布构建定义 LOG_ACTIVE_LEVEL=2 去掉全部 TRACE / DEBUG
+#ifndef LOG_ACTIVE_LEVEL
+#define LOG_ACTIVE_LEVEL 0
+#endif
+
+// 调用点所属模块：在包含 Log.hpp 之前 #define LOG_MODULE "名称" 可显式指定，否则由 __FILE__ 推导
+#ifdef LOG_MODULE
+#define LOG_CALL_SITE_MODULE std::string_view(LOG_MODULE)
+#else
+#define LOG_CALL_SITE_MODULE Log::ModuleName(__FILE__)
+#endif
+
+// 运行期按调用点缓存的模块级别检查（配置未变化时为三次原子读取与两次比较，见 Logger::IsEnabled），启用时才构造消息、格式化；
+// 文件名在编译期从 __FILE__ 中截取，格式化时不再逐条处理路径
+#define LOG_AT_LEVEL(level, msg) \
+    do { \
+        static constinit Log::CallSite log_call_site_(LOG_CALL_SITE_MODULE); \
+        if (Log::Logger::IsEnabled(level, log_call_site_)) { \
+            static constexpr const char* log_file_name_ = Log::SourceFileName(__FILE__); \
+            Log::Logger::Instance().Write(level, log_file_name_, __LINE__, __func__, std::string(msg)); \
+        } \
+    } while (0)
+
+// 编译期移除：表达式仍参与类型检查，但不会求值
+#define LOG_DISABLED(msg) \
+    do { \
+        if (false) { \
+            (void)(msg); \
+        } \
+    } while (0)
+
+// 基本日志宏
+#if LOG_ACTIVE_LEVEL <= 0
+#define LOG_TRACE(msg) LOG_AT_LEVEL(Log::Level::LVL_TRACE, msg)
+#else
+#define LOG_TRACE(msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 1
+#define LOG_DEBUG(msg) LOG_AT_LEVEL(Log::Level::LVL_DEBUG, msg)
+#else
+#define LOG_DEBUG(msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 2
+#define LOG_INFO(msg) LOG_AT_LEVEL(Log::Level::LVL_INFO, msg)
+#else
+#define LOG_INFO(msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 3
+#define LOG_WARN(msg) LOG_AT_LEVEL(Log::Level::LVL_WARN, msg)
+#else
+#define LOG_WARN(msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 4
+#define LOG_ERROR(msg) LOG_AT_LEVEL(Log::Level::LVL_ERROR, msg)
+#else
+#define LOG_ERROR(msg) LOG_DISABLED(msg)
+#endif
+
+#define LOG_FATAL(msg) LOG_AT_LEVEL(Log::Level::LVL_FATAL, msg)
+
+// 带格式化的日志宏：格式串须为字面量，占位符在编译期检查（见 Format.hpp）；
+// 格式化在级别检查之后进行，被禁用的语句不产生任何格式化与分配。
+// 每个调用点有一个常量初始化的描述符：异步模式下参数为整数、浮点数、bool、字符或字符串时
+// 只把原值编码进队列记录，格式化在后台线程进行（见 Log::LogFormatted）
+#define LOG_FMT_AT_LEVEL(level, fmt, ...) \
+    do { \
+        static constinit Log::CallSite log_call_site_(LOG_CALL_SITE_MODULE); \
+        if (Log::Logger::IsEnabled(level, log_call_site_)) { \
+            static constinit Log::LogDescriptor log_descriptor_(level, Log::SourceFileName(__FILE__), __LINE__, __func__, fmt); \
+            Log::LogFormatted(log_descriptor_, fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_FMT_DISABLED(fmt, ...) LOG_DISABLED(Log::Format(fmt, ##__VA_ARGS__))
+
+#if LOG_ACTIVE_LEVEL <= 0
+#define LOG_TRACE_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_TRACE, fmt, ##__VA_ARGS__)
+#else
+#define LOG_TRACE_FMT(fmt, ...) LOG_FMT_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 1
+#define LOG_DEBUG_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG_FMT(fmt, ...) LOG_FMT_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 2
+#define LOG_INFO_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO_FMT(fmt, ...) LOG_FMT_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 3
+#define LOG_WARN_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN_FMT(fmt, ...) LOG_FMT_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 4
+#define LOG_ERROR_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR_FMT(fmt, ...) LOG_FMT_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#define LOG_FATAL_FMT(fmt, ...) LOG_FMT_AT_LEVEL(Log::Level::LVL_FATAL, fmt, ##__VA_ARGS__)
+
+// 限流与采样日志宏（见 LogRateLimit.hpp）：级别检查通过后再由调用点的限流器判断，放行时才构造消息，
+// 消息末尾附带此前被丢弃的条数；msg 可以是 Log::Format(...) 表达式。
+//   LOG_INFO_EVERY_N(n, msg)                 每 n 条输出一条
+//   LOG_INFO_EVERY_MS(ms, msg)               每 ms 毫秒最多输出一条
+//   LOG_INFO_RATE(per_second, burst, msg)    令牌桶：平均每秒 per_second 条，允许突发 burst 条
+#define LOG_LIMITED_AT_LEVEL(level, limiter, msg, ...) \
+    do { \
+        static constinit Log::CallSite log_call_site_(LOG_CALL_SITE_MODULE); \
+        if (Log::Logger::IsEnabled(level, log_call_site_)) { \
+            static constexpr const char* log_file_name_ = Log::SourceFileName(__FILE__); \
+            static constinit limiter log_limiter_(level, log_file_name_, __LINE__, __func__); \
+            uint64_t log_suppressed_ = 0; \
+            if (log_limiter_.Allow(log_suppressed_, __VA_ARGS__)) { \
+                Log::Logger::Instance().Write(level, log_file_name_, __LINE__, __func__, \
+                    Log::WithSuppressed(std::string(msg), log_suppressed_)); \
+            } \
+        } \
+    } while (0)
+
+#if LOG_ACTIVE_LEVEL <= 1
+#define LOG_DEBUG_EVERY_N(n, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_DEBUG, Log::EveryN, msg, n)
+#define LOG_DEBUG_EVERY_MS(ms, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_DEBUG, Log::EveryMs, msg, ms)
+#define LOG_DEBUG_RATE(per_second, burst, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_DEBUG, Log::TokenBucket, msg, per_second, burst)
+#else
+#define LOG_DEBUG_EVERY_N(n, msg) LOG_DISABLED(msg)
+#define LOG_DEBUG_EVERY_MS(ms, msg) LOG_DISABLED(msg)
+#define LOG_DEBUG_RATE(per_second, burst, msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 2
+#define LOG_INFO_EVERY_N(n, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_INFO, Log::EveryN, msg, n)
+#define LOG_INFO_EVERY_MS(ms, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_INFO, Log::EveryMs, msg, ms)
+#define LOG_INFO_RATE(per_second, burst, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_INFO, Log::TokenBucket, msg, per_second, burst)
+#else
+#define LOG_INFO_EVERY_N(n, msg) LOG_DISABLED(msg)
+#define LOG_INFO_EVERY_MS(ms, msg) LOG_DISABLED(msg)
+#define LOG_INFO_RATE(per_second, burst, msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 3
+#define LOG_WARN_EVERY_N(n, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_WARN, Log::EveryN, msg, n)
+#define LOG_WARN_EVERY_MS(ms, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_WARN, Log::EveryMs, msg, ms)
+#define LOG_WARN_RATE(per_second, burst, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_WARN, Log::TokenBucket, msg, per_second, burst)
+#else
+#define LOG_WARN_EVERY_N(n, msg) LOG_DISABLED(msg)
+#define LOG_WARN_EVERY_MS(ms, msg) LOG_DISABLED(msg)
+#define LOG_WARN_RATE(per_second, burst, msg) LOG_DISABLED(msg)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 4
+#define LOG_ERROR_EVERY_N(n, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_ERROR, Log::EveryN, msg, n)
+#define LOG_ERROR_EVERY_MS(ms, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_ERROR, Log::EveryMs, msg, ms)
+#define LOG_ERROR_RATE(per_second, burst, msg) LOG_LIMITED_AT_LEVEL(Log::Level::LVL_ERROR, Log::TokenBucket, msg, per_second, burst)
+#else
+#define LOG_ERROR_EVERY_N(n, msg) LOG_DISABLED(msg)
+#define LOG_ERROR_EVERY_MS(ms, msg) LOG_DISABLED(msg)
+#define LOG_ERROR_RATE(per_second, burst, msg) LOG_DISABLED(msg)
+#endif
+
+// 二进制日志宏：每个调用点一个静态描述符，记录只保存参数原值，由 refstorage_logdecode 还原为文本；
+// 参数限于整数、浮点数、bool、字符与字符串，格式串同样在编译期检查
+#define LOG_BIN_AT_LEVEL(level, fmt, ...) \
+    do { \
+        static constinit Log::CallSite log_call_site_(LOG_CALL_SITE_MODULE); \
+        if (Log::Logger::IsEnabled(level, log_call_site_)) { \
+            static constinit Log::LogDescriptor log_descriptor_(level, Log::SourceFileName(__FILE__), __LINE__, __func__, fmt); \
+            Log::LogBinary(log_descriptor_, fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_BIN_DISABLED(fmt, ...) \
+    do { \
+        if (false) { \
+            (void)Log::Format(fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#if LOG_ACTIVE_LEVEL <= 0
+#define LOG_TRACE_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_TRACE, fmt, ##__VA_ARGS__)
+#else
+#define LOG_TRACE_BIN(fmt, ...) LOG_BIN_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 1
+#define LOG_DEBUG_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG_BIN(fmt, ...) LOG_BIN_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 2
+#define LOG_INFO_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO_BIN(fmt, ...) LOG_BIN_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 3
+#define LOG_WARN_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN_BIN(fmt, ...) LOG_BIN_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= 4
+#define LOG_ERROR_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR_BIN(fmt, ...) LOG_BIN_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#define LOG_FATAL_BIN(fmt, ...) LOG_BIN_AT_LEVEL(Log::Level::LVL_FATAL, fmt, ##__VA_ARGS__)
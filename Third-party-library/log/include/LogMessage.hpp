@@ -7,19 +7,34 @@
 #include "LogLevel.hpp"
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <thread>
 
 namespace Log
 {
 
+    // 源文件路径中的文件名部分；常量求值时每个调用点只计算一次（见 LOG_AT_LEVEL）
+    constexpr const char* SourceFileName(const char* path)
+    {
+        const char* name = path;
+        for (const char* p = path; *p != '\0'; ++p)
+        {
+            if (*p == '/' || *p == '\\')
+            {
+                name = p + 1;
+            }
+        }
+        return name;
+    }
+
     // ��־��Ϣ�ṹ
     struct Message
     {
         std::chrono::system_clock::time_point timestamp;
         Level level;
-        std::string file;
+        const char* file;       // __FILE__ / __func__ 为静态存储，只保存指针，异步队列中的记录无需复制
         int line;
-        std::string function;
+        const char* function;
         std::thread::id thread_id;
         std::string content;
 
@@ -28,12 +43,29 @@ namespace Log
             const char* func, std::string_view msg)
             : timestamp(std::chrono::system_clock::now())
             , level(lvl)
-            , file(f)
+            , file(f ? f : "")
             , line(l)
             , function(func ? func : "")
             , thread_id(std::this_thread::get_id())
             , content(msg) {
         }
+
+        Message(Level lvl, const char* f, int l,
+            const char* func, const char* msg)
+            : Message(lvl, f, l, func, std::string_view(msg ? msg : "")) {
+        }
+
+        // 接管已构造好的消息内容，不再复制
+        Message(Level lvl, const char* f, int l,
+            const char* func, std::string&& msg)
+            : timestamp(std::chrono::system_clock::now())
+            , level(lvl)
+            , file(f ? f : "")
+            , line(l)
+            , function(func ? func : "")
+            , thread_id(std::this_thread::get_id())
+            , content(std::move(msg)) {
+        }
     };
 
 } // namespace Log
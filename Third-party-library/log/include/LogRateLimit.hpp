@@ -0,0 +1,173 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+// include/log/LogRateLimit.hpp
+
+
+#pragma once
+
+#include "LogLevel.hpp"
+#include "Format.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace Log
+{
+
+    // 限流与采样：每个 LOG_*_EVERY_N / LOG_*_EVERY_MS / LOG_*_RATE 调用点一个静态（常量初始化）限流器，
+    // 状态只有几个原子变量，判断不加锁。被丢弃的条数累计在调用点上，下一条放行的日志末尾附带
+    // “（此前抑制 N 条）”；Logger 析构时（或调用 ReportSuppressedLogs）对仍有未报告计数的调用点各输出一条汇总。
+
+    // 限流调用点的公共部分：位置信息与丢弃计数
+    class RateLimitSite
+    {
+    public:
+        constexpr RateLimitSite(Level level, const char* file, int line, const char* function)
+            : level_(level), file_(file), line_(line), function_(function)
+        {
+        }
+
+        RateLimitSite(const RateLimitSite&) = delete;
+        RateLimitSite& operator=(const RateLimitSite&) = delete;
+
+    protected:
+        static int64_t NowNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // 丢弃一条：计数加一，第一次丢弃时登记到全局链表以便汇总
+        void Suppress()
+        {
+            if (suppressed_.fetch_add(1, std::memory_order_relaxed) == 0 && !registered_.load(std::memory_order_relaxed))
+            {
+                Register();
+            }
+        }
+
+        // 放行一条：取出并清零累计的丢弃条数
+        uint64_t TakeSuppressed()
+        {
+            return suppressed_.exchange(0, std::memory_order_relaxed);
+        }
+
+    private:
+        void Register();
+
+        friend void ReportSuppressedLogs();
+
+        Level level_;
+        const char* file_;
+        int line_;
+        const char* function_;
+        std::atomic<uint64_t> suppressed_{ 0 };
+        std::atomic<bool> registered_{ false };
+        RateLimitSite* next_{ nullptr };        // 登记时写入一次，之后只读
+    };
+
+    // 每 n 条放行一条（第 1、n+1、2n+1…… 条）
+    class EveryN : public RateLimitSite
+    {
+    public:
+        using RateLimitSite::RateLimitSite;
+
+        bool Allow(uint64_t& suppressed, uint64_t n)
+        {
+            if (count_.fetch_add(1, std::memory_order_relaxed) % (n > 0 ? n : 1) == 0)
+            {
+                suppressed = TakeSuppressed();
+                return true;
+            }
+            Suppress();
+            return false;
+        }
+
+    private:
+        std::atomic<uint64_t> count_{ 0 };
+    };
+
+    // 每 interval_ms 毫秒最多放行一条；多个线程同时到期时只有 CAS 成功的一个放行
+    class EveryMs : public RateLimitSite
+    {
+    public:
+        using RateLimitSite::RateLimitSite;
+
+        bool Allow(uint64_t& suppressed, int64_t interval_ms)
+        {
+            int64_t now = NowNanoseconds();
+            int64_t next = next_ns_.load(std::memory_order_relaxed);
+            if (now >= next && next_ns_.compare_exchange_strong(next, now + interval_ms * 1000000, std::memory_order_relaxed))
+            {
+                suppressed = TakeSuppressed();
+                return true;
+            }
+            Suppress();
+            return false;
+        }
+
+    private:
+        std::atomic<int64_t> next_ns_{ std::numeric_limits<int64_t>::min() };
+    };
+
+    // 令牌桶：每秒补充 per_second 个令牌，最多积攒 burst 个。
+    // 按 GCRA 的形式实现，只保存“理论到达时间”一个原子变量（与令牌桶等价），CAS 失败时重试
+    class TokenBucket : public RateLimitSite
+    {
+    public:
+        using RateLimitSite::RateLimitSite;
+
+        bool Allow(uint64_t& suppressed, double per_second, uint32_t burst)
+        {
+            if (per_second <= 0)
+            {
+                Suppress();
+                return false;
+            }
+
+            int64_t interval = static_cast<int64_t>(1e9 / per_second);
+            if (interval < 1)
+            {
+                interval = 1;
+            }
+            int64_t tolerance = interval * static_cast<int64_t>(burst > 0 ? burst - 1 : 0);
+
+            int64_t now = NowNanoseconds();
+            int64_t arrival = arrival_ns_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                int64_t start = arrival > now ? arrival : now;
+                if (start - now > tolerance)
+                {
+                    Suppress();
+                    return false;
+                }
+                if (arrival_ns_.compare_exchange_weak(arrival, start + interval, std::memory_order_relaxed))
+                {
+                    suppressed = TakeSuppressed();
+                    return true;
+                }
+            }
+        }
+
+    private:
+        std::atomic<int64_t> arrival_ns_{ std::numeric_limits<int64_t>::min() };
+    };
+
+    // 放行的日志附带此前被丢弃的条数
+    inline std::string WithSuppressed(std::string msg, uint64_t suppressed)
+    {
+        if (suppressed > 0)
+        {
+            FormatTo(msg, "（此前抑制 {} 条）", suppressed);
+        }
+        return msg;
+    }
+
+    // 对仍有未报告丢弃计数的限流调用点各输出一条汇总（级别与位置取自调用点）
+    void ReportSuppressedLogs();
+
+} // namespace Log
@@ -7,13 +7,16 @@
 #pragma once
 
 #include "LogMessage.hpp"
+#include <cstdint>
 #include <memory>
+#include <string_view>
 
 namespace Log
 {
 
     // ǰ������
     class Formatter;
+    struct LogDescriptor;
 
     // ���Ŀ��������
     class Sink
@@ -32,6 +35,13 @@ namespace Log
 
         // ���ø�ʽ����
         virtual void SetFormatter(std::unique_ptr<Formatter> formatter) = 0;
+
+        // 写入一条二进制日志（LOG_*_BIN）；不支持二进制格式的 Sink 返回 false，由 Logger 还原为文本后调用 Write
+        virtual bool WriteBinary(const LogDescriptor& descriptor, uint32_t thread, uint64_t steady_ns,
+            std::string_view payload) {
+            (void)descriptor; (void)thread; (void)steady_ns; (void)payload;
+            return false;
+        }
     };
 
 } // namespace Log
@@ -11,10 +11,17 @@
 
 #include "LogLevel.hpp"
 #include "LogSink.hpp"
+#include "FileSink.hpp"
+#include "ConsoleSink.hpp"
+#include "AsyncLogProcessor.hpp"
+#include "LogCallSite.hpp"
+#include <map>
 #include <string>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <string_view>
 
 namespace Log
 {
@@ -41,11 +48,48 @@ namespace Log
         Level GetLevel() const;
 
         // ��־��¼��ͬ����
+        // 宏在格式化之前调用：一次 relaxed 读取与一次比较，不加锁
+        static bool IsEnabled(Level level)
+        {
+            return level >= current_level_.load(std::memory_order_relaxed);
+        }
+
+        // 按调用点所属模块检查（日志宏使用）：调用点缓存生效级别，代数未变时为调用点代数的一次 acquire 读取、
+        // 全局代数的一次 relaxed 读取、调用点级别的一次 relaxed 读取与两次比较，不加锁
+        static bool IsEnabled(Level level, CallSite& site)
+        {
+            if (site.generation.load(std::memory_order_acquire) != level_generation_.load(std::memory_order_relaxed))
+            {
+                ResolveCallSite(site);
+            }
+            return level >= site.level.load(std::memory_order_relaxed);
+        }
+
+        // 模块级别：优先于全局级别（模块名见 LogCallSite.hpp 中的 ModuleName，或源文件中的 LOG_MODULE）
+        void SetModuleLevel(const std::string& module, Level level);
+        void ClearModuleLevels();
+
+        // 按全局级别检查后写入（直接调用时使用）
         void Log(Level level,
             const char* file,
             int line,
             const char* function,
-            const std::string& message);
+            std::string message);
+
+        // 写入已由调用方检查过级别的日志（日志宏按模块级别检查后调用）
+        void Write(Level level,
+            const char* file,
+            int line,
+            const char* function,
+            std::string message);
+
+        // 二进制日志（LOG_*_BIN）：支持二进制格式的 Sink 直接写入原始参数，其余 Sink 写入还原后的文本；
+        // 异步模式下与其他日志一样入队，由后台线程写出
+        void LogBinary(const LogDescriptor& descriptor, std::string_view payload);
+
+        // 异步模式下把调用点描述符与编码后的参数放入队列（LOG_*_FMT / LOG_*_BIN），由后台线程格式化；
+        // 未处于异步模式或参数编码超过 AsyncRecord::kInlinePayload 时返回 false
+        bool SubmitEncoded(const LogDescriptor& descriptor, std::string_view payload);
 
         // �������Ŀ��?
         void AddSink(std::unique_ptr<Sink> sink);
@@ -53,12 +97,14 @@ namespace Log
         // ��ݷ��������ӿ���̨���
         void AddConsoleSink(Level min_level = Level::LVL_INFO,
             bool use_colors = true,
-            const std::string& pattern = "");
+            const std::string& pattern = "",
+            const ConsoleBatchOptions& batch = {});
 
         // ��ݷ����������ļ����
         void AddFileSink(const std::string& filename,
             Level min_level = Level::LVL_INFO,
-            const std::string& pattern = "");
+            const std::string& pattern = "",
+            const RotationOptions& rotation = {});
 
         // ���ýӿ�
         void Initialize(const Config& config);
@@ -68,6 +114,13 @@ namespace Log
         // ˢ���������Ŀ��?
         void Flush();
 
+        // 异步模式：日志记录放入无锁队列，由后台线程格式化并写入 Sink；FATAL 日志提交后等待写出
+        void StartAsync(const AsyncOptions& options = {});
+        // 写完队列中的日志后恢复同步写入
+        void StopAsync();
+        bool IsAsync() const { return async_.load(std::memory_order_acquire) != nullptr; }
+        AsyncLogProcessor::Stats GetAsyncStats() const;
+
         // �ݹ������Է���
         void RecursiveTest(int depth = 3);
 
@@ -81,14 +134,41 @@ namespace Log
         // д������sink
         void WriteToSinks(const Message& msg);
 
+        // 把编码后的参数写入各 Sink：二进制 Sink 写入原值，其余 Sink 共用一次格式化的文本
+        void DispatchEncoded(const LogDescriptor& descriptor, uint32_t thread, uint64_t steady_ns,
+            std::chrono::system_clock::time_point timestamp, std::thread::id thread_id, std::string_view payload);
+
+        // 后台线程处理一条队列记录
+        void ProcessRecord(AsyncRecord& record);
+
         // �������ô���Sink
         std::unique_ptr<Sink> CreateSink(const struct SinkConfig& config);
 
     private:
-        mutable std::recursive_mutex mutex_;
-        std::vector<std::unique_ptr<Sink>> sinks_;
-        Level current_level_{ Level::LVL_INFO };
+        // Sink 列表是只读快照（RCU）：AddSink / Initialize 在 mutex_ 下复制出新列表，整体替换后递增代数；
+        // 写日志的线程各自缓存快照，代数不变时只需一次 acquire 读取，不加锁也不修改共享引用计数。
+        // 旧快照在各线程下次写日志时释放，各 Sink 自行处理并发
+        using SinkList = std::vector<std::shared_ptr<Sink>>;
+        class SinkSnapshot;
+        void PublishSinks(std::shared_ptr<const SinkList> sinks);
+
+        mutable std::recursive_mutex mutex_;    // 只串行化配置修改（Sink 列表、异步模式），不在写日志路径上
+        std::atomic<std::shared_ptr<const SinkList>> sinks_{ std::make_shared<const SinkList>() };
+        std::atomic<uint64_t> sinks_generation_{ 0 };
+        inline static std::atomic<Level> current_level_{ Level::LVL_INFO };
+
+        // 级别配置（全局或模块）每次变化时递增，使各调用点缓存的级别失效；从 1 开始，0 表示调用点未解析
+        inline static std::atomic<uint32_t> level_generation_{ 1 };
+        static void ResolveCallSite(CallSite& site);
+        void InvalidateCallSites();
+
+        std::mutex module_mutex_;
+        std::map<std::string, Level, std::less<>> module_levels_;
         bool initialized_{ false };
+
+        // 处理器创建后保留到 Logger 析构，生产者读到的指针始终有效
+        std::unique_ptr<AsyncLogProcessor> async_processor_;
+        std::atomic<AsyncLogProcessor*> async_{ nullptr };
     };
 
 } // namespace Log
@@ -11,9 +11,12 @@
 #include "include/LogSink.hpp"
 #include "include/Logger.hpp"
 #include "include/LogMacros.hpp"
+#include "include/LogRateLimit.hpp"
 #include "include/ConsoleSink.hpp"
 #include "include/FileSink.hpp"
+#include "include/BinaryLog.hpp"
+#include "include/BinaryLogSink.hpp"
 #include "include/ColoredFormatter.hpp"
-//#include "include/AsyncLogProcessor.hpp" - �첽��־δ���
+#include "include/AsyncLogProcessor.hpp"
 #include "include/LogConfig.hpp"
 #include "include/Format.hpp"
\ No newline at end of file
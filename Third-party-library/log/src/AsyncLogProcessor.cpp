@@ -0,0 +1,266 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//	src/log/AsyncLogProcessor.cpp
+
+
+#include "AsyncLogProcessor.hpp"
+#include <new>
+#include <string>
+
+namespace Log {
+
+    namespace {
+
+        // 队列满时生产者先自旋让出若干次，再短暂休眠
+        constexpr int kBlockSpins = 64;
+        constexpr auto kBlockSleep = std::chrono::microseconds(50);
+
+        size_t RoundUpPowerOfTwo(size_t value) {
+            size_t result = 2;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+    }
+
+    AsyncLogProcessor::AsyncLogProcessor(Handler handler, const AsyncOptions& options)
+        : handler_(std::move(handler))
+        , options_(options)
+        , capacity_(RoundUpPowerOfTwo(options.queue_size))
+        , mask_(capacity_ - 1)
+        , slots_(std::make_unique<Slot[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    AsyncLogProcessor::~AsyncLogProcessor() {
+        Stop();
+        // 停止后仍可能有竞争入队的记录：交给处理函数并析构
+        Drain();
+    }
+
+    void AsyncLogProcessor::Start() {
+        std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+        if (running_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        running_.store(true, std::memory_order_release);
+        worker_thread_ = std::thread(&AsyncLogProcessor::WorkerThread, this);
+    }
+
+    void AsyncLogProcessor::Stop() {
+        std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+        if (!running_.exchange(false, std::memory_order_seq_cst)) {
+            return;
+        }
+        Wake();
+        if (worker_thread_.joinable()) {
+            worker_thread_.join();
+        }
+
+        // 后台线程最后一次检查队列之后才发布的记录；此后才发布的由生产者自己写出（见 Published）
+        Drain();
+        ReportDropped();
+    }
+
+    bool AsyncLogProcessor::Submit(AsyncRecord&& record, bool force_block) {
+        if (!IsRunning()) {
+            return false;
+        }
+
+        if (TryPush(record)) {
+            Published();
+            return true;
+        }
+
+        auto policy = force_block ? OverflowPolicy::BLOCK : options_.overflow_policy;
+        if (policy != OverflowPolicy::BLOCK) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            if (policy == OverflowPolicy::DROP_AND_COUNT) {
+                unreported_drops_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // 阻塞策略：唤醒后台线程，等待腾出空间
+        for (int spins = 0;; ++spins) {
+            Wake();
+            if (spins < kBlockSpins) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(kBlockSleep);
+            }
+            if (TryPush(record)) {
+                Published();
+                return true;
+            }
+            if (!IsRunning()) {
+                return false;
+            }
+        }
+    }
+
+    void AsyncLogProcessor::Published() {
+        // 与后台线程“置休眠标记 -> 检查队列”、Stop“清除运行标记 -> 处理队列”配对的全序栅栏：
+        // 入队的 release 存储不能与之后读取标记重排，否则双方可能都读到旧值，记录留在队列中
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (worker_sleeping_.load(std::memory_order_relaxed)) {
+            Wake();
+        }
+
+        // 入队前检查时仍在运行，但 Stop 可能已处理完队列：在 lifecycle_mutex_ 下由本线程写出。
+        // 后台线程自己提交的记录在它当前这次 Drain 中处理，不能在这里等待 Stop 持有的锁
+        if (!running_.load(std::memory_order_relaxed)
+            && std::this_thread::get_id() != worker_id_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            if (!running_.load(std::memory_order_relaxed)) {
+                Drain();
+            }
+        }
+    }
+
+    bool AsyncLogProcessor::TryPush(AsyncRecord& record) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (slot.storage) AsyncRecord(std::move(record));
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                // 槽位仍被上一轮占用：队列已满
+                return false;
+            }
+            else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t AsyncLogProcessor::Drain() {
+        size_t count = 0;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+
+            auto* record = std::launder(reinterpret_cast<AsyncRecord*>(slot.storage));
+            try {
+                handler_(*record);
+            }
+            catch (...) {
+                // 单条日志写入失败不影响后续日志
+            }
+            record->~AsyncRecord();
+
+            slot.sequence.store(pos + capacity_, std::memory_order_release);
+            ++pos;
+            ++count;
+            dequeue_pos_.store(pos, std::memory_order_release);
+        }
+
+        if (count > 0) {
+            processed_count_.fetch_add(count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    void AsyncLogProcessor::ReportDropped() {
+        auto dropped = unreported_drops_.exchange(0, std::memory_order_relaxed);
+        if (dropped == 0) {
+            return;
+        }
+        AsyncRecord record;
+        record.level     = Level::LVL_WARN;
+        record.file      = __FILE__;
+        record.line      = __LINE__;
+        record.function  = __func__;
+        record.steady_ns = SteadyNanoseconds();
+        record.thread_id = std::this_thread::get_id();
+        record.text      = "异步日志队列已满，丢弃 " + std::to_string(dropped) + " 条日志";
+        handler_(record);
+    }
+
+    void AsyncLogProcessor::Flush() {
+        if (!IsRunning() || std::this_thread::get_id() == worker_id_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // 已占用的槽位终将发布，等后台线程处理到此刻的入队位置即可
+        size_t target = enqueue_pos_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        while (dequeue_pos_.load(std::memory_order_acquire) < target && IsRunning()) {
+            wake_requested_ = true;
+            wake_cv_.notify_one();
+            drained_cv_.wait_for(lock, options_.idle_wait);
+        }
+    }
+
+    void AsyncLogProcessor::Wake() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_requested_ = true;
+        }
+        wake_cv_.notify_one();
+    }
+
+    void AsyncLogProcessor::WorkerThread() {
+        worker_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+        for (;;) {
+            size_t processed = Drain();
+            ReportDropped();
+            if (processed > 0) {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                drained_cv_.notify_all();
+                continue;
+            }
+
+            if (!IsRunning()) {
+                break;
+            }
+
+            // 队列为空：标记休眠后再检查一次，避免错过休眠前刚入队的记录；
+            // 生产者读到休眠标记才加锁唤醒，漏掉的唤醒最多延迟 idle_wait
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            worker_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            if (slots_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1) {
+                worker_sleeping_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            wake_cv_.wait_for(lock, options_.idle_wait, [this] { return wake_requested_; });
+            wake_requested_ = false;
+            worker_sleeping_.store(false, std::memory_order_relaxed);
+        }
+
+        worker_id_.store(std::thread::id(), std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        drained_cv_.notify_all();
+    }
+
+    AsyncLogProcessor::Stats AsyncLogProcessor::GetStats() const {
+        size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        return Stats{
+            processed_count_.load(std::memory_order_relaxed),
+            dropped_count_.load(std::memory_order_relaxed),
+            enqueued > dequeued ? enqueued - dequeued : 0,
+            capacity_
+        };
+    }
+
+} // namespace Log
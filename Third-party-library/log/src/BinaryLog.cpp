@@ -0,0 +1,223 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//	src/log/BinaryLog.cpp
+
+
+#include "BinaryLog.hpp"
+#include "Logger.hpp"
+#include <mutex>
+
+namespace Log {
+
+    namespace {
+
+        std::mutex& RegistryMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        // 下标 + 1 为描述符编号
+        std::vector<LogDescriptor*>& Registry() {
+            static std::vector<LogDescriptor*> descriptors;
+            return descriptors;
+        }
+
+        std::atomic<uint32_t> next_thread_number{ 1 };
+
+        template<typename T>
+        bool ReadRaw(std::string_view& payload, T& value) {
+            if (payload.size() < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, payload.data(), sizeof(T));
+            payload.remove_prefix(sizeof(T));
+            return true;
+        }
+
+    }
+
+    namespace binary {
+
+        std::string& ThreadPayload() {
+            thread_local std::string payload;
+            return payload;
+        }
+
+        uint32_t ThreadNumber() {
+            thread_local uint32_t number = next_thread_number.fetch_add(1, std::memory_order_relaxed);
+            return number;
+        }
+
+        bool DecodeArgs(std::string_view types, std::string_view payload, std::vector<std::string>& args) {
+            args.clear();
+            for (char type : types) {
+                switch (type) {
+                case kBool: {
+                    char raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.emplace_back(raw ? "true" : "false");
+                    break;
+                }
+                case kChar: {
+                    char raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.emplace_back(1, raw);
+                    break;
+                }
+                case kInt: {
+                    int64_t raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.push_back(FormatString("{0}", raw));
+                    break;
+                }
+                case kUInt: {
+                    uint64_t raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.push_back(FormatString("{0}", raw));
+                    break;
+                }
+                case kFloat: {
+                    float raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.push_back(FormatString("{0}", raw));
+                    break;
+                }
+                case kDouble: {
+                    double raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    args.push_back(FormatString("{0}", raw));
+                    break;
+                }
+                case kString: {
+                    uint32_t size;
+                    if (!ReadRaw(payload, size) || payload.size() < size) return false;
+                    args.emplace_back(payload.substr(0, size));
+                    payload.remove_prefix(size);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return payload.empty();
+        }
+
+        std::string Render(std::string_view format, const std::vector<std::string>& args) {
+            std::vector<detail::FormatArg> format_args;
+            format_args.reserve(args.size());
+            for (const auto& arg : args) {
+                format_args.push_back(detail::MakeArg(arg));
+            }
+
+            std::string result;
+            detail::VFormatTo(result, format, format_args.data(), format_args.size());
+            return result;
+        }
+
+        bool RenderTo(std::string& out, std::string_view format, std::string_view types, std::string_view payload) {
+            // 解码后的参数原值，FormatArg 指向其中对应类型的成员；字符串指向 payload 内部
+            struct Value {
+                bool             b;
+                char             c;
+                int64_t          i;
+                uint64_t         u;
+                float            f;
+                double           d;
+                std::string_view s;
+            };
+            thread_local std::vector<Value> values;
+            thread_local std::vector<detail::FormatArg> format_args;
+            values.resize(types.size());
+            format_args.clear();
+
+            for (size_t k = 0; k < types.size(); ++k) {
+                Value& value = values[k];
+                switch (types[k]) {
+                case kBool: {
+                    char raw;
+                    if (!ReadRaw(payload, raw)) return false;
+                    value.b = raw != 0;
+                    format_args.push_back(detail::MakeArg(value.b));
+                    break;
+                }
+                case kChar:
+                    if (!ReadRaw(payload, value.c)) return false;
+                    format_args.push_back(detail::MakeArg(value.c));
+                    break;
+                case kInt:
+                    if (!ReadRaw(payload, value.i)) return false;
+                    format_args.push_back(detail::MakeArg(value.i));
+                    break;
+                case kUInt:
+                    if (!ReadRaw(payload, value.u)) return false;
+                    format_args.push_back(detail::MakeArg(value.u));
+                    break;
+                case kFloat:
+                    if (!ReadRaw(payload, value.f)) return false;
+                    format_args.push_back(detail::MakeArg(value.f));
+                    break;
+                case kDouble:
+                    if (!ReadRaw(payload, value.d)) return false;
+                    format_args.push_back(detail::MakeArg(value.d));
+                    break;
+                case kString: {
+                    uint32_t size;
+                    if (!ReadRaw(payload, size) || payload.size() < size) return false;
+                    value.s = payload.substr(0, size);
+                    payload.remove_prefix(size);
+                    format_args.push_back(detail::MakeArg(value.s));
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            if (!payload.empty()) {
+                return false;
+            }
+
+            detail::VFormatTo(out, format, format_args.data(), format_args.size());
+            return true;
+        }
+
+    } // namespace binary
+
+    uint32_t RegisterDescriptor(LogDescriptor& descriptor, const char* arg_types) {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        uint32_t id = descriptor.id.load(std::memory_order_relaxed);
+        if (id != 0) {
+            return id;
+        }
+
+        auto& descriptors = Registry();
+        descriptor.arg_types = arg_types;
+        descriptors.push_back(&descriptor);
+        id = static_cast<uint32_t>(descriptors.size());
+        descriptor.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    const LogDescriptor* FindDescriptor(uint32_t id) {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        auto& descriptors = Registry();
+        return id == 0 || id > descriptors.size() ? nullptr : descriptors[id - 1];
+    }
+
+    void DispatchBinary(const LogDescriptor& descriptor, std::string_view payload) {
+        Logger::Instance().LogBinary(descriptor, payload);
+    }
+
+    bool AsyncEnabled() {
+        return Logger::Instance().IsAsync();
+    }
+
+    bool SubmitEncoded(const LogDescriptor& descriptor, std::string_view payload) {
+        return Logger::Instance().SubmitEncoded(descriptor, payload);
+    }
+
+    void DispatchText(const LogDescriptor& descriptor, std::string&& text) {
+        Logger::Instance().Write(descriptor.level, descriptor.file, descriptor.line, descriptor.function, std::move(text));
+    }
+
+} // namespace Log
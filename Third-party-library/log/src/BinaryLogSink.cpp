@@ -0,0 +1,181 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//	src/log/BinaryLogSink.cpp
+
+
+#include "BinaryLogSink.hpp"
+#include <chrono>
+#include <iostream>
+
+namespace Log
+{
+
+    namespace
+    {
+        uint64_t SteadyNanoseconds(std::chrono::steady_clock::time_point time)
+        {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+        }
+
+        template<typename T>
+        void Put(std::string& out, const T& value)
+        {
+            binary::AppendRaw(out, &value, sizeof(T));
+        }
+    }
+
+    BinaryLogSink::BinaryLogSink(const std::string& filename, Level min_level)
+        : filename_(filename), min_level_(min_level)
+    {
+        EnsureFileOpen();
+    }
+
+    BinaryLogSink::~BinaryLogSink()
+    {
+        if (file_.is_open())
+        {
+            file_.close();
+        }
+    }
+
+    void BinaryLogSink::Write(const Message& msg)
+    {
+        if (!ShouldLog(msg.level))
+        {
+            return;
+        }
+
+        // 文本日志的时间戳是 system_clock：换算到 steady_clock，与二进制记录共用同一时间基准
+        auto system_now = std::chrono::system_clock::now();
+        auto steady = std::chrono::steady_clock::now()
+            - std::chrono::duration_cast<std::chrono::steady_clock::duration>(system_now - msg.timestamp);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        EnsureFileOpen();
+        if (!file_.is_open())
+        {
+            return;
+        }
+
+        record_.clear();
+        Put(record_, binary::RecordType::TEXT);
+        Put(record_, msg.level);
+        Put(record_, SteadyNanoseconds(steady));
+        Put(record_, binary::ThreadNumber());
+        Put(record_, static_cast<uint32_t>(msg.line));
+        binary::AppendString(record_, msg.file);
+        binary::AppendString(record_, msg.function);
+        binary::AppendString(record_, msg.content);
+        file_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+    }
+
+    bool BinaryLogSink::WriteBinary(const LogDescriptor& descriptor, uint32_t thread, uint64_t steady_ns,
+        std::string_view payload)
+    {
+        if (!ShouldLog(descriptor.level))
+        {
+            return true;
+        }
+
+        uint32_t id = descriptor.id.load(std::memory_order_acquire);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        EnsureFileOpen();
+        if (!file_.is_open())
+        {
+            return true;
+        }
+
+        EmitDescriptor(descriptor, id);
+
+        // 固定长度的记录头加参数原样复制，文件流缓冲满时才进入内核
+        char header[1 + 4 + 8 + 4 + 4];
+        char* cursor = header;
+        auto put = [&cursor](const auto& value) {
+            std::memcpy(cursor, &value, sizeof(value));
+            cursor += sizeof(value);
+        };
+        put(binary::RecordType::EVENT);
+        put(id);
+        put(steady_ns);
+        put(thread);
+        put(static_cast<uint32_t>(payload.size()));
+        file_.write(header, sizeof(header));
+        file_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        return true;
+    }
+
+    void BinaryLogSink::EmitDescriptor(const LogDescriptor& descriptor, uint32_t id)
+    {
+        if (id < emitted_.size() && emitted_[id])
+        {
+            return;
+        }
+        if (id >= emitted_.size())
+        {
+            emitted_.resize(id + 1, false);
+        }
+        emitted_[id] = true;
+
+        record_.clear();
+        Put(record_, binary::RecordType::DESCRIPTOR);
+        Put(record_, id);
+        Put(record_, descriptor.level);
+        Put(record_, static_cast<uint32_t>(descriptor.line));
+        binary::AppendString(record_, descriptor.file);
+        binary::AppendString(record_, descriptor.function);
+        binary::AppendString(record_, descriptor.format);
+        binary::AppendString(record_, descriptor.arg_types ? descriptor.arg_types : "");
+        file_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+    }
+
+    void BinaryLogSink::Flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_.is_open())
+        {
+            file_.flush();
+        }
+    }
+
+    bool BinaryLogSink::ShouldLog(Level level) const
+    {
+        return level >= min_level_;
+    }
+
+    void BinaryLogSink::SetFormatter(std::unique_ptr<Formatter> formatter)
+    {
+        (void)formatter;
+    }
+
+    void BinaryLogSink::EnsureFileOpen()
+    {
+        if (file_.is_open()) {
+            return;
+        }
+
+        std::filesystem::path path(filename_);
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        // 每次打开都追加一个新文件头：之后的记录使用新的时间基准与描述符编号
+        file_.open(filename_, std::ios::binary | std::ios::app);
+        if (!file_.is_open()) {
+            std::cerr << "文件打开失败 " << filename_ << std::endl;
+            return;
+        }
+
+        record_.clear();
+        binary::AppendRaw(record_, binary::kMagic, sizeof(binary::kMagic));
+        Put(record_, binary::kByteOrderMark);
+        Put(record_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()));
+        Put(record_, SteadyNanoseconds(std::chrono::steady_clock::now()));
+        file_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+        emitted_.clear();
+    }
+
+} // namespace Log
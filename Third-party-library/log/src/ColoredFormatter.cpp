@@ -7,8 +7,7 @@
 
 #include "ColoredFormatter.hpp"
 #include "LogLevel.hpp"
-#include <sstream>
-#include <iomanip>
+#include <charconv>
 
 namespace Log {
 
@@ -65,85 +64,78 @@ namespace Log {
     }
 
     std::string ColoredFormatter::Format(const Message& msg) const {
+        std::string result;
+        FormatTo(msg, result);
+        return result;
+    }
+
+    void ColoredFormatter::FormatTo(const Message& msg, std::string& out) const {
         if (!use_colors_) {
-            return Formatter::Format(msg);
+            Formatter::FormatTo(msg, out);
+            return;
         }
 
-        return ApplyColoring(msg);
+        ApplyColoring(msg, out);
     }
 
-    std::string ColoredFormatter::ApplyColoring(const Message& msg) const {
-        std::ostringstream result;
+    void ColoredFormatter::ApplyColoring(const Message& msg, std::string& out) const {
+        size_t begin = out.size();
 
         for (const auto& region : regions_) {
-            std::string text = GetTextForRegion(region, msg);
-
             if (region.colorize) {
-                result << GetColorCode(msg.level) << text << GetResetCode();
+                out += GetColorCode(msg.level);
+                AppendRegion(region, msg, out);
+                out += GetResetCode();
             }
             else {
-                result << text;
+                AppendRegion(region, msg, out);
             }
         }
 
-        std::string formatted = result.str();
-        if (!formatted.empty() && formatted.back() != '\n') {
-            formatted.push_back('\n');
+        if (out.size() > begin && out.back() != '\n') {
+            out.push_back('\n');
         }
-
-        return formatted;
     }
 
-    std::string ColoredFormatter::GetTextForRegion(const ColorRegion& region, const Message& msg) const {
+    void ColoredFormatter::AppendRegion(const ColorRegion& region, const Message& msg, std::string& out) const {
         switch (region.type) {
-        case ColorRegion::Type::TIMESTAMP: {
-            auto time = std::chrono::system_clock::to_time_t(msg.timestamp);
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                msg.timestamp.time_since_epoch()) % 1000;
-
-            std::tm tm_buf;
-#ifdef _WIN32
-            localtime_s(&tm_buf, &time);
-#else
-            localtime_r(&time, &tm_buf);
-#endif
-
-            std::ostringstream oss;
-            oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-            oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-            return oss.str();
-        }
+        case ColorRegion::Type::TIMESTAMP:
+            AppendTimestamp(msg.timestamp, out);
+            break;
 
         case ColorRegion::Type::LEVEL:
-            return LevelToString(msg.level);
+            out += LevelToString(msg.level);
+            break;
 
-        case ColorRegion::Type::THREAD_ID: {
-            std::ostringstream oss;
-            oss << msg.thread_id;
-            return oss.str();
-        }
+        case ColorRegion::Type::THREAD_ID:
+            AppendThreadId(msg.thread_id, out);
+            break;
 
         case ColorRegion::Type::LOCATION: {
-            std::string filename = msg.file;
-            size_t pos = filename.find_last_of("/\\");
-            if (pos != std::string::npos) {
-                filename = filename.substr(pos + 1);
-            }
-            return filename + ":" + std::to_string(msg.line) + ":" + msg.function;
+            out += SourceFileName(msg.file);
+            out += ':';
+            char buffer[16];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), msg.line);
+            out.append(buffer, result.ptr);
+            out += ':';
+            out += msg.function;
+            break;
         }
 
         case ColorRegion::Type::MESSAGE:
-            return msg.content;
+            out += msg.content;
+            break;
 
         case ColorRegion::Type::CUSTOM_TEXT:
-            return region.custom_text;
+            out += region.custom_text;
+            break;
 
         default:
-            return "";
+            break;
         }
     }
 
-    std::string ColoredFormatter::GetColorCode(Level level) {
+    const char* ColoredFormatter::GetColorCode(Level level) {
         switch (level) {
         case Level::LVL_TRACE: return "\033[90m";    // ��ɫ
         case Level::LVL_DEBUG: return "\033[36m";    // ��ɫ
@@ -155,7 +147,7 @@ namespace Log {
         }
     }
 
-    std::string ColoredFormatter::GetResetCode() {
+    const char* ColoredFormatter::GetResetCode() {
         return "\033[0m";
     }
 
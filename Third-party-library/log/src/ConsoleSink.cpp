@@ -5,13 +5,62 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <unistd.h>
 #endif
 
 namespace Log
 {
 
-    ConsoleSink::ConsoleSink(Level min_level, bool use_colors, const std::string& pattern)
-        : min_level_(min_level), use_colors_(use_colors)
+    namespace
+    {
+        // 绕过 iostream 直接写到标准输出 / 标准错误，写不完时继续写剩余部分；出错（如管道已关闭）时丢弃
+        void WriteToConsole(bool to_stderr, const std::string& data)
+        {
+            const char* cursor = data.data();
+            size_t remaining = data.size();
+
+#ifdef _WIN32
+            HANDLE handle = GetStdHandle(to_stderr ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
+            if (handle == INVALID_HANDLE_VALUE || handle == nullptr)
+            {
+                return;
+            }
+            while (remaining > 0)
+            {
+                DWORD written = 0;
+                DWORD chunk = static_cast<DWORD>(remaining > (1u << 30) ? (1u << 30) : remaining);
+                if (!WriteFile(handle, cursor, chunk, &written, nullptr) || written == 0)
+                {
+                    return;
+                }
+                cursor += written;
+                remaining -= written;
+            }
+#else
+            int fd = to_stderr ? STDERR_FILENO : STDOUT_FILENO;
+            while (remaining > 0)
+            {
+                ssize_t written = ::write(fd, cursor, remaining);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return;
+                }
+                cursor += written;
+                remaining -= static_cast<size_t>(written);
+            }
+#endif
+        }
+    }
+
+    ConsoleSink::ConsoleSink(Level min_level, bool use_colors, const std::string& pattern,
+        const ConsoleBatchOptions& batch)
+        : min_level_(min_level), use_colors_(use_colors), batch_(batch)
     {
 
         if (pattern.empty())
@@ -42,18 +91,88 @@ namespace Log
 
         std::lock_guard<std::mutex> lock(mutex_);
 
-        std::string formatted = colored_formatter_->Format(msg);
-
         // ѡ�������
         if (msg.level >= Level::LVL_ERROR)
         {
-            std::cerr << formatted;
-            std::cerr.flush();
+            // 先写出已缓冲的普通日志，保持与错误日志的先后顺序
+            FlushPending();
+
+            buffer_.clear();
+            colored_formatter_->FormatTo(msg, buffer_);
+            WriteToConsole(true, buffer_);
+            return;
         }
-        else
+
+        bool was_empty = pending_.empty();
+        colored_formatter_->FormatTo(msg, pending_);
+
+        if (pending_.size() >= batch_.max_bytes)
         {
-            std::cout << formatted;
-            std::cout.flush();
+            FlushPending();
+        }
+        else if (was_empty)
+        {
+            // 缓冲区从空变为非空时记录时间并唤醒后台线程，之后的日志只追加
+            pending_since_ = std::chrono::steady_clock::now();
+            if (!flush_thread_.joinable())
+            {
+                flush_thread_ = std::thread(&ConsoleSink::FlushThread, this);
+            }
+            flush_cv_.notify_one();
+        }
+    }
+
+    ConsoleSink::~ConsoleSink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        flush_cv_.notify_all();
+        if (flush_thread_.joinable())
+        {
+            flush_thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        FlushPending();
+    }
+
+    void ConsoleSink::FlushPending()
+    {
+        if (pending_.empty())
+        {
+            return;
+        }
+
+        // 程序自己通过 std::cout 输出、尚在缓冲中的内容先写出，避免被日志插到前面
+        std::cout.flush();
+        WriteToConsole(false, pending_);
+        pending_.clear();
+    }
+
+    void ConsoleSink::FlushThread()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            flush_cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (stopping_)
+            {
+                break;
+            }
+
+            // 等待期间缓冲区可能已因达到大小上限被写出并重新开始，到期后按最新的起始时间重新判断
+            auto deadline = pending_since_ + std::chrono::milliseconds(batch_.max_delay_ms);
+            if (flush_cv_.wait_until(lock, deadline, [this] { return stopping_; }))
+            {
+                break;
+            }
+            if (!pending_.empty()
+                && std::chrono::steady_clock::now() >= pending_since_ + std::chrono::milliseconds(batch_.max_delay_ms))
+            {
+                FlushPending();
+            }
         }
     }
 
@@ -66,6 +185,7 @@ namespace Log
     void ConsoleSink::Flush()
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        FlushPending();
         std::cout.flush();
         std::cerr.flush();
     }
@@ -5,15 +5,34 @@
 
 
 #include "FileSink.hpp"
+#include "LogFormatter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#ifdef LOG_HAS_ZLIB
+#include <zlib.h>
+#endif
 
 
 namespace Log
 {
 
-    FileSink::FileSink(const std::string& filename, Level min_level, const std::string& pattern)
-        : filename_(filename), min_level_(min_level)
+    namespace
+    {
+        // 轮转文件名中时间与序号部分的格式：YYYYMMDD-HHMMSS.NNNNNN
+        constexpr size_t kRotatedStampLength = 15 + 1 + 6;
+        constexpr const char* kCompressedExtension = ".gz";
+    }
+
+    FileSink::FileSink(const std::string& filename, Level min_level, const std::string& pattern,
+        const RotationOptions& rotation)
+        : filename_(filename), min_level_(min_level), rotation_(rotation)
     {
 
         if (pattern.empty())
@@ -30,6 +49,17 @@ namespace Log
 
     FileSink::~FileSink()
     {
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex_);
+            stopping_ = true;
+        }
+        maintenance_cv_.notify_all();
+        // 等待已排队的压缩完成，避免留下半写的压缩文件
+        if (maintenance_thread_.joinable())
+        {
+            maintenance_thread_.join();
+        }
+
         if (file_.is_open())
         {
             file_.close();
@@ -48,8 +78,17 @@ namespace Log
         EnsureFileOpen();
         if (file_.is_open())
         {
-            file_ << formatter_->Format(msg);
+            buffer_.clear();
+            formatter_->FormatTo(msg, buffer_);
+            file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
             //file_.flush();                                           //显示刷新，解决写入日志时的缓冲问题
+
+            // 只累加计数，不查询文件大小
+            auto written = written_bytes_.fetch_add(buffer_.size(), std::memory_order_relaxed) + buffer_.size();
+            if (rotation_.max_size > 0 && written >= rotation_.max_size)
+            {
+                Rotate();
+            }
         }
     }
 
@@ -85,7 +124,192 @@ namespace Log
             file_.open(filename_, std::ios::app);
             if (!file_.is_open()) {
                 std::cerr << "文件打开失败 " << filename_ << std::endl;
+                return;
+            }
+
+            // 追加到已有文件时从其当前大小开始计数
+            std::error_code ec;
+            auto size = std::filesystem::file_size(path, ec);
+            written_bytes_.store(ec ? 0 : size, std::memory_order_relaxed);
+        }
+    }
+
+    void FileSink::Rotate()
+    {
+        file_.close();
+
+        std::error_code ec;
+        auto rotated = NextRotatedPath();
+        std::filesystem::rename(filename_, rotated, ec);
+        if (ec) {
+            // 改名失败时继续写原文件，再写满 max_size 后重试
+            std::cerr << "日志文件轮转失败 " << filename_ << "：" << ec.message() << std::endl;
+        }
+
+        EnsureFileOpen();
+        if (ec) {
+            written_bytes_.store(0, std::memory_order_relaxed);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex_);
+            pending_files_.push_back(std::move(rotated));
+            if (!maintenance_thread_.joinable()) {
+                maintenance_thread_ = std::thread(&FileSink::MaintenanceThread, this);
+            }
+        }
+        maintenance_cv_.notify_one();
+    }
+
+    std::filesystem::path FileSink::NextRotatedPath()
+    {
+        // app.log -> app.20261019-064335.000001.log；时间与序号定宽，按文件名排序即按轮转先后排序
+        std::filesystem::path path(filename_);
+        auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm tm_buf;
+#ifdef _WIN32
+        localtime_s(&tm_buf, &time);
+#else
+        localtime_r(&time, &tm_buf);
+#endif
+
+        // 同一秒内重启后序号从头开始，跳过已存在的文件名
+        std::filesystem::path rotated;
+        std::error_code ec;
+        do {
+            std::ostringstream name;
+            name << path.stem().string() << '.'
+                << std::put_time(&tm_buf, "%Y%m%d-%H%M%S") << '.'
+                << std::setfill('0') << std::setw(6) << (++rotation_seq_ % 1000000)
+                << path.extension().string();
+            rotated = path.parent_path() / name.str();
+        } while (std::filesystem::exists(rotated, ec)
+            || std::filesystem::exists(std::filesystem::path(rotated) += kCompressedExtension, ec));
+        return rotated;
+    }
+
+    bool FileSink::IsRotatedFile(const std::string& name) const
+    {
+        std::filesystem::path path(filename_);
+        std::string prefix = path.stem().string() + ".";
+        std::string extension = path.extension().string();
+
+        std::string_view rest(name);
+        if (rest.size() >= 3 && rest.substr(rest.size() - 3) == kCompressedExtension) {
+            rest.remove_suffix(3);
+        }
+        if (rest.size() != prefix.size() + kRotatedStampLength + extension.size()
+            || rest.substr(0, prefix.size()) != prefix
+            || rest.substr(rest.size() - extension.size()) != extension) {
+            return false;
+        }
+
+        auto stamp = rest.substr(prefix.size(), kRotatedStampLength);
+        for (size_t i = 0; i < stamp.size(); ++i) {
+            bool separator = (i == 8 && stamp[i] == '-') || (i == 15 && stamp[i] == '.');
+            if (!separator && !std::isdigit(static_cast<unsigned char>(stamp[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void FileSink::MaintenanceThread()
+    {
+        std::unique_lock<std::mutex> lock(maintenance_mutex_);
+        for (;;) {
+            maintenance_cv_.wait(lock, [this] { return stopping_ || !pending_files_.empty(); });
+            if (pending_files_.empty()) {
+                break;
             }
+
+            auto path = std::move(pending_files_.front());
+            pending_files_.pop_front();
+            lock.unlock();
+
+            if (rotation_.compress) {
+                CompressFile(path);
+            }
+            EnforceRetention();
+
+            lock.lock();
+        }
+    }
+
+    void FileSink::CompressFile(const std::filesystem::path& path) const
+    {
+#ifdef LOG_HAS_ZLIB
+        auto target = path;
+        target += kCompressedExtension;
+        auto temporary = target;
+        temporary += ".tmp";
+
+        std::ifstream input(path, std::ios::binary);
+        gzFile output = gzopen(temporary.string().c_str(), "wb");
+        if (!input.is_open() || output == nullptr) {
+            if (output != nullptr) {
+                gzclose(output);
+            }
+            std::cerr << "日志文件压缩失败 " << path.string() << std::endl;
+            return;
+        }
+
+        std::vector<char> chunk(64 * 1024);
+        bool ok = true;
+        while (ok && input) {
+            input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            auto count = input.gcount();
+            if (count > 0) {
+                ok = gzwrite(output, chunk.data(), static_cast<unsigned>(count)) == count;
+            }
+        }
+        ok = (gzclose(output) == Z_OK) && ok;
+        input.close();
+
+        // 压缩文件完整写出后再改名并删除原文件，中途失败只会留下未压缩的原文件
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(temporary, target, ec);
+        }
+        if (!ok || ec) {
+            std::filesystem::remove(temporary, ec);
+            std::cerr << "日志文件压缩失败 " << path.string() << std::endl;
+            return;
+        }
+        std::filesystem::remove(path, ec);
+#else
+        (void)path;
+#endif
+    }
+
+    void FileSink::EnforceRetention() const
+    {
+        if (rotation_.max_files <= 0) {
+            return;
+        }
+
+        std::filesystem::path path(filename_);
+        auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+
+        std::vector<std::filesystem::path> rotated;
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && IsRotatedFile(it->path().filename().string())) {
+                rotated.push_back(it->path());
+            }
+        }
+        if (rotated.size() <= static_cast<size_t>(rotation_.max_files)) {
+            return;
+        }
+
+        // 文件名中的时间与序号定宽，按文件名排序后删除最早的
+        std::sort(rotated.begin(), rotated.end(), [](const auto& a, const auto& b) {
+            return a.filename().string() < b.filename().string();
+        });
+        size_t excess = rotated.size() - static_cast<size_t>(rotation_.max_files);
+        for (size_t i = 0; i < excess; ++i) {
+            std::filesystem::remove(rotated[i], ec);
         }
     }
 
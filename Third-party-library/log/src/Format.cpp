@@ -0,0 +1,78 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//	src/log/Format.cpp
+
+
+#include "Format.hpp"
+
+namespace Log {
+    namespace detail {
+
+        void FormatStringError(const char*) {
+            // 只在常量求值中被引用，用于产生编译错误；运行期不会调用
+        }
+
+        std::string& ThreadBuffer() {
+            thread_local std::string buffer;
+            return buffer;
+        }
+
+        void VFormatTo(std::string& out, std::string_view fmt, const FormatArg* args, size_t arg_count) {
+            size_t next_index = 0;
+            size_t literal_begin = 0;
+
+            for (size_t i = 0; i < fmt.size(); ++i) {
+                char c = fmt[i];
+                if (c != '{' && c != '}') {
+                    continue;
+                }
+
+                // 转义 {{ / }}
+                if (i + 1 < fmt.size() && fmt[i + 1] == c) {
+                    out.append(fmt, literal_begin, i + 1 - literal_begin);
+                    literal_begin = i + 2;
+                    ++i;
+                    continue;
+                }
+                if (c == '}') {
+                    continue;
+                }
+
+                size_t close = fmt.find('}', i + 1);
+                if (close == std::string_view::npos) {
+                    break;
+                }
+
+                std::string_view field = fmt.substr(i + 1, close - i - 1);
+                size_t index = 0;
+                bool valid = true;
+                if (field.empty()) {
+                    index = next_index++;
+                }
+                else {
+                    for (char digit : field) {
+                        if (digit < '0' || digit > '9') {
+                            valid = false;
+                            break;
+                        }
+                        index = index * 10 + static_cast<size_t>(digit - '0');
+                    }
+                }
+
+                // 运行期格式串（旧接口）中的无效占位符原样保留
+                if (!valid || index >= arg_count) {
+                    continue;
+                }
+
+                out.append(fmt, literal_begin, i - literal_begin);
+                args[index].append(out, args[index].value);
+                literal_begin = close + 1;
+                i = close;
+            }
+
+            out.append(fmt, literal_begin, std::string_view::npos);
+        }
+
+    } // namespace detail
+} // namespace Log
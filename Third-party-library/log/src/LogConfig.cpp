@@ -10,9 +10,26 @@
 #include <sstream>
 #include <algorithm>
 #include <cstdlib>
+#include <string_view>
 
 namespace Log {
 
+    bool Config::ParseLevel(const std::string& text, Level& level) {
+        std::string_view name(text);
+        if (name.substr(0, 4) == "LVL_") {
+            name.remove_prefix(4);
+        }
+
+        if (name == "TRACE") level = Level::LVL_TRACE;
+        else if (name == "DEBUG") level = Level::LVL_DEBUG;
+        else if (name == "INFO") level = Level::LVL_INFO;
+        else if (name == "WARN") level = Level::LVL_WARN;
+        else if (name == "ERROR") level = Level::LVL_ERROR;
+        else if (name == "FATAL") level = Level::LVL_FATAL;
+        else return false;
+        return true;
+    }
+
     Config Config::LoadFromFile(const std::string& path) {
         Config config;
         std::ifstream file(path);
@@ -23,6 +40,7 @@ namespace Log {
 
         std::string line;
         SinkConfig* current_sink = nullptr;
+        bool in_modules = false;
 
         while (std::getline(file, line)) {
             // �Ƴ�ע��
@@ -42,7 +60,11 @@ namespace Log {
             // ����������
             size_t eq_pos = line.find('=');
             if (eq_pos == std::string::npos) {
-                if (line == "[console]") {
+                in_modules = (line == "[modules]");
+                if (in_modules) {
+                    current_sink = nullptr;
+                }
+                else if (line == "[console]") {
                     config.sinks.emplace_back("console");
                     current_sink = &config.sinks.back();
                 }
@@ -50,6 +72,10 @@ namespace Log {
                     config.sinks.emplace_back("file");
                     current_sink = &config.sinks.back();
                 }
+                else if (line == "[binary]") {
+                    config.sinks.emplace_back("binary");
+                    current_sink = &config.sinks.back();
+                }
                 continue;
             }
 
@@ -61,22 +87,29 @@ namespace Log {
             value.erase(0, value.find_first_not_of(" \t"));
             value.erase(value.find_last_not_of(" \t") + 1);
 
-            if (key == "level") {
-                if (value == "TRACE") config.global_level = Level::LVL_TRACE;
-                else if (value == "DEBUG") config.global_level = Level::LVL_DEBUG;
-                else if (value == "INFO") config.global_level = Level::LVL_INFO;
-                else if (value == "WARN") config.global_level = Level::LVL_WARN;
-                else if (value == "ERROR") config.global_level = Level::LVL_ERROR;
-                else if (value == "FATAL") config.global_level = Level::LVL_FATAL;
+            if (in_modules) {
+                Level level;
+                if (ParseLevel(value, level)) {
+                    config.module_levels[key] = level;
+                }
+            }
+            else if (key == "level" && !current_sink) {
+                ParseLevel(value, config.global_level);
+            }
+            else if (key == "async" && !current_sink) {
+                config.async = (value == "true" || value == "1");
+            }
+            else if (key == "async_queue_size" && !current_sink) {
+                config.async_options.queue_size = std::stoull(value);
+            }
+            else if (key == "async_overflow" && !current_sink) {
+                if (value == "block") config.async_options.overflow_policy = OverflowPolicy::BLOCK;
+                else if (value == "drop") config.async_options.overflow_policy = OverflowPolicy::DROP;
+                else if (value == "drop_count") config.async_options.overflow_policy = OverflowPolicy::DROP_AND_COUNT;
             }
             else if (current_sink) {
                 if (key == "level") {
-                    if (value == "TRACE") current_sink->min_level = Level::LVL_TRACE;
-                    else if (value == "DEBUG") current_sink->min_level = Level::LVL_DEBUG;
-                    else if (value == "INFO") current_sink->min_level = Level::LVL_INFO;
-                    else if (value == "WARN") current_sink->min_level = Level::LVL_WARN;
-                    else if (value == "ERROR") current_sink->min_level = Level::LVL_ERROR;
-                    else if (value == "FATAL") current_sink->min_level = Level::LVL_FATAL;
+                    ParseLevel(value, current_sink->min_level);
                 }
                 else if (key == "pattern") {
                     current_sink->pattern = value;
@@ -84,7 +117,13 @@ namespace Log {
                 else if (key == "colors" && current_sink->type == "console") {
                     current_sink->use_colors = (value == "true" || value == "1");
                 }
-                else if (key == "filename" && current_sink->type == "file") {
+                else if (key == "batch_size" && current_sink->type == "console") {
+                    current_sink->batch_size = std::stoull(value);
+                }
+                else if (key == "batch_delay_ms" && current_sink->type == "console") {
+                    current_sink->batch_delay_ms = static_cast<uint32_t>(std::stoul(value));
+                }
+                else if (key == "filename" && (current_sink->type == "file" || current_sink->type == "binary")) {
                     current_sink->filename = value;
                 }
                 else if (key == "max_size" && current_sink->type == "file") {
@@ -93,6 +132,9 @@ namespace Log {
                 else if (key == "max_files" && current_sink->type == "file") {
                     current_sink->max_files = std::stoi(value);
                 }
+                else if (key == "compress" && current_sink->type == "file") {
+                    current_sink->compress = (value == "true" || value == "1");
+                }
             }
         }
 
@@ -105,13 +147,7 @@ namespace Log {
 
         const char* level = std::getenv("LOG_LEVEL");
         if (level) {
-            std::string level_str = level;
-            if (level_str == "TRACE") config.global_level = Level::LVL_TRACE;
-            else if (level_str == "DEBUG") config.global_level = Level::LVL_DEBUG;
-            else if (level_str == "INFO") config.global_level = Level::LVL_INFO;
-            else if (level_str == "WARN") config.global_level = Level::LVL_WARN;
-            else if (level_str == "ERROR") config.global_level = Level::LVL_ERROR;
-            else if (level_str == "FATAL") config.global_level = Level::LVL_FATAL;
+            ParseLevel(level, config.global_level);
         }
 
         const char* file = std::getenv("LOG_FILE");
@@ -6,7 +6,11 @@
 
 #include "LogFormatter.hpp"
 #include "LogLevel.hpp"
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <ctime>
 #include <sstream>
 
 namespace Log {
@@ -26,23 +30,25 @@ namespace Log {
     }
 
     std::string Formatter::Format(const Message& msg) const {
-        std::ostringstream oss;
+        std::string result;
+        FormatTo(msg, result);
+        return result;
+    }
 
+    void Formatter::FormatTo(const Message& msg, std::string& out) const {
+        size_t begin = out.size();
         for (const auto& part : parts_) {
             if (part.token == FormatToken::TEXT) {
-                oss << part.text;
+                out += part.text;
             }
             else {
-                oss << ReplaceToken(part.token, msg);
+                AppendToken(part.token, msg, out);
             }
         }
 
-        std::string result = oss.str();
-        if (!result.empty() && result.back() != '\n') {
-            result.push_back('\n');
+        if (out.size() > begin && out.back() != '\n') {
+            out.push_back('\n');
         }
-
-        return result;
     }
 
     void Formatter::ParsePattern(const std::string& pattern) {
@@ -90,62 +96,113 @@ namespace Log {
         }
     }
 
-    std::string Formatter::ReplaceToken(FormatToken token, const Message& msg) const {
+    void Formatter::AppendToken(FormatToken token, const Message& msg, std::string& out) const {
         switch (token) {
-        case FormatToken::TIMESTAMP: {
-            auto time = std::chrono::system_clock::to_time_t(msg.timestamp);
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                msg.timestamp.time_since_epoch()) % 1000;
-
-            std::tm tm_buf;
-#ifdef _WIN32
-            localtime_s(&tm_buf, &time);
-#else
-            localtime_r(&time, &tm_buf);
-#endif
-
-            std::ostringstream oss;
-            oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-            oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-            return oss.str();
-        }
+        case FormatToken::TIMESTAMP:
+            AppendTimestamp(msg.timestamp, out);
+            break;
 
         case FormatToken::LEVEL:
-            return LevelToString(msg.level);
+            out += LevelToString(msg.level);
+            break;
 
         case FormatToken::LEVEL_SHORT:
-            return LevelToShortString(msg.level);
-
-        case FormatToken::FILE: {
-            std::string filename = msg.file;
-            size_t pos = filename.find_last_of("/\\");
-            if (pos != std::string::npos) {
-                filename = filename.substr(pos + 1);
-            }
-            return filename;
+            out += LevelToShortString(msg.level);
+            break;
+
+        case FormatToken::FILE:
+            // 宏已传入文件名，直接调用 Logger::Log 时可能仍是完整路径
+            out += SourceFileName(msg.file);
+            break;
+
+        case FormatToken::LINE: {
+            char buffer[16];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), msg.line);
+            out.append(buffer, result.ptr);
+            break;
         }
 
-        case FormatToken::LINE:
-            return std::to_string(msg.line);
-
         case FormatToken::FUNCTION:
-            return msg.function;
+            out += msg.function;
+            break;
 
-        case FormatToken::THREAD_ID: {
-            std::ostringstream oss;
-            oss << msg.thread_id;
-            return oss.str();
-        }
+        case FormatToken::THREAD_ID:
+            AppendThreadId(msg.thread_id, out);
+            break;
 
         case FormatToken::MESSAGE:
-            return msg.content;
+            out += msg.content;
+            break;
 
         case FormatToken::PERCENT:
-            return "%";
+            out += '%';
+            break;
 
         default:
-            return "";
+            break;
+        }
+    }
+
+    void Formatter::AppendTimestamp(std::chrono::system_clock::time_point timestamp, std::string& out) {
+        // 同一秒内的日志复用已格式化的日期时间，只有跨秒时才调用 localtime
+        struct SecondCache {
+            int64_t second{ INT64_MIN };
+            char text[32]{};
+            size_t length{ 0 };
+        };
+        thread_local SecondCache cache;
+
+        auto since_epoch = timestamp.time_since_epoch();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count();
+        auto second = ms / 1000;
+        auto millisecond = ms % 1000;
+        if (millisecond < 0) {
+            --second;
+            millisecond += 1000;
+        }
+
+        if (second != cache.second) {
+            auto time = static_cast<std::time_t>(second);
+            std::tm tm_buf;
+#ifdef _WIN32
+            localtime_s(&tm_buf, &time);
+#else
+            localtime_r(&time, &tm_buf);
+#endif
+            cache.length = std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &tm_buf);
+            cache.second = second;
+        }
+
+        char suffix[4] = {
+            '.',
+            static_cast<char>('0' + millisecond / 100),
+            static_cast<char>('0' + millisecond / 10 % 10),
+            static_cast<char>('0' + millisecond % 10)
+        };
+        out.append(cache.text, cache.length);
+        out.append(suffix, sizeof(suffix));
+    }
+
+    void Formatter::AppendThreadId(std::thread::id id, std::string& out) {
+        // 直接映射的小缓存：同步写入时命中当前线程，异步后台线程写入时覆盖最近活跃的生产者线程
+        struct ThreadIdEntry {
+            std::thread::id id;
+            char text[24]{};
+            size_t length{ 0 };
+        };
+        constexpr size_t kEntries = 16;
+        thread_local ThreadIdEntry cache[kEntries];
+
+        auto& entry = cache[std::hash<std::thread::id>{}(id) % kEntries];
+        if (entry.id != id || entry.length == 0) {
+            std::ostringstream oss;
+            oss << id;
+            auto text = oss.str();
+            entry.length = std::min(text.size(), sizeof(entry.text));
+            std::memcpy(entry.text, text.data(), entry.length);
+            entry.id = id;
         }
+        out.append(entry.text, entry.length);
     }
 
-} // namespace Log
\ No newline at end of file
+} // namespace Log
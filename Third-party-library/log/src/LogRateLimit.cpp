@@ -0,0 +1,42 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "LogRateLimit.hpp"
+#include "Logger.hpp"
+
+namespace Log
+{
+
+    namespace
+    {
+        // 出现过丢弃的调用点（只增不减的无锁单链表，调用点为静态对象，不需要释放）
+        constinit std::atomic<RateLimitSite*> g_suppressed_sites{ nullptr };
+    }
+
+    void RateLimitSite::Register()
+    {
+        if (registered_.exchange(true, std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        next_ = g_suppressed_sites.load(std::memory_order_relaxed);
+        while (!g_suppressed_sites.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void ReportSuppressedLogs()
+    {
+        for (auto* site = g_suppressed_sites.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+        {
+            uint64_t suppressed = site->TakeSuppressed();
+            if (suppressed > 0)
+            {
+                Logger::Instance().Write(site->level_, site->file_, site->line_, site->function_,
+                    Format("限流期间共抑制 {} 条日志", suppressed));
+            }
+        }
+    }
+
+} // namespace Log
@@ -9,15 +9,112 @@
 #include "Logger.hpp"
 #include "ConsoleSink.hpp"
 #include "FileSink.hpp"
+#include "BinaryLogSink.hpp"
+#include "LogRateLimit.hpp"
 #include "LogConfig.hpp"
+#include <cstdint>
+#include <cstring>
+#include <optional>
 
 namespace Log
 {
 
+    namespace
+    {
+        // 当前线程缓存的 Sink 列表快照
+        struct SinkCache
+        {
+            uint64_t generation{ UINT64_MAX };
+            std::shared_ptr<const std::vector<std::shared_ptr<Sink>>> sinks;
+            int depth{ 0 };                     // 正在遍历快照的层数（Sink 内部再写日志时大于 1）
+
+            ~SinkCache();
+        };
+
+        // 线程缓存已销毁（平凡类型，线程退出时不析构）：主线程的缓存先于静态 Logger 销毁，
+        // 之后 Logger 析构中的报告与刷新只能直接读取 sinks_
+        thread_local bool sink_cache_destroyed = false;
+
+        thread_local SinkCache sink_cache;
+
+        SinkCache::~SinkCache()
+        {
+            sink_cache_destroyed = true;
+        }
+
+        // 队列记录的 steady_clock 时间戳换算为系统时间：各线程缓存一对同时读取的两种时钟，
+        // 记录晚于缓存 1 秒以上时重新读取，使系统时间的调整能及时反映到日志中
+        std::chrono::system_clock::time_point SystemTimeOf(uint64_t steady_ns)
+        {
+            constexpr uint64_t kRefreshNs = 1000000000;
+
+            struct ClockBase
+            {
+                uint64_t steady_ns{ 0 };
+                std::chrono::system_clock::time_point system;
+            };
+            thread_local ClockBase base;
+
+            if (base.steady_ns == 0 || steady_ns > base.steady_ns + kRefreshNs)
+            {
+                base.system = std::chrono::system_clock::now();
+                base.steady_ns = SteadyNanoseconds();
+            }
+
+            auto offset = std::chrono::nanoseconds(static_cast<int64_t>(steady_ns) - static_cast<int64_t>(base.steady_ns));
+            return base.system + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+        }
+    }
+
+    // 遍历期间使用的快照：代数变化时刷新线程缓存；嵌套写日志时沿用外层快照，避免释放正在遍历的列表
+    class Logger::SinkSnapshot
+    {
+    public:
+        explicit SinkSnapshot(const Logger& logger)
+        {
+            if (sink_cache_destroyed)
+            {
+                owned_ = logger.sinks_.load(std::memory_order_acquire);
+                sinks_ = owned_.get();
+                return;
+            }
+
+            auto generation = logger.sinks_generation_.load(std::memory_order_acquire);
+            if (sink_cache.depth == 0 && sink_cache.generation != generation)
+            {
+                sink_cache.sinks = logger.sinks_.load(std::memory_order_acquire);
+                sink_cache.generation = generation;
+            }
+            ++sink_cache.depth;
+            sinks_ = sink_cache.sinks.get();
+        }
+
+        ~SinkSnapshot()
+        {
+            if (!owned_)
+            {
+                --sink_cache.depth;
+            }
+        }
+
+        SinkSnapshot(const SinkSnapshot&) = delete;
+        SinkSnapshot& operator=(const SinkSnapshot&) = delete;
+
+        SinkList::const_iterator begin() const { return sinks_->begin(); }
+        SinkList::const_iterator end() const { return sinks_->end(); }
+
+    private:
+        std::shared_ptr<const SinkList> owned_;     // 线程缓存已销毁时自行持有的列表
+        const SinkList* sinks_{ nullptr };
+    };
+
     Logger::Logger() = default;
 
     Logger::~Logger()
     {
+        // 限流调用点中尚未报告的丢弃条数
+        ReportSuppressedLogs();
+        StopAsync();
         Flush();
     }
 
@@ -30,7 +127,8 @@ namespace Log
     void Logger::Initialize(Level level)
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
-        current_level_ = level;
+        current_level_.store(level, std::memory_order_relaxed);
+        InvalidateCallSites();
         initialized_ = true;
 
         Log(Level::LVL_INFO, __FILE__, __LINE__, __func__,
@@ -40,7 +138,8 @@ namespace Log
     void Logger::SetLevel(Level level)
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
-        current_level_ = level;
+        current_level_.store(level, std::memory_order_relaxed);
+        InvalidateCallSites();
 
         Log(Level::LVL_INFO, __FILE__, __LINE__, __func__,
             "Log level set to: " + std::string(LevelToString(level)));
@@ -48,15 +147,58 @@ namespace Log
 
     Level Logger::GetLevel() const
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
-        return current_level_;
+        return current_level_.load(std::memory_order_relaxed);
+    }
+
+    void Logger::SetModuleLevel(const std::string& module, Level level)
+    {
+        {
+            std::lock_guard<std::mutex> lock(module_mutex_);
+            module_levels_[module] = level;
+        }
+        InvalidateCallSites();
+    }
+
+    void Logger::ClearModuleLevels()
+    {
+        {
+            std::lock_guard<std::mutex> lock(module_mutex_);
+            module_levels_.clear();
+        }
+        InvalidateCallSites();
+    }
+
+    void Logger::InvalidateCallSites()
+    {
+        level_generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void Logger::ResolveCallSite(CallSite& site)
+    {
+        auto& logger = Instance();
+        std::lock_guard<std::mutex> lock(logger.module_mutex_);
+
+        // 在锁内读取代数：级别修改先于代数递增，解析结果不会比记录的代数旧
+        auto generation = level_generation_.load(std::memory_order_acquire);
+        auto level = current_level_.load(std::memory_order_relaxed);
+        if (!site.module.empty())
+        {
+            auto it = logger.module_levels_.find(site.module);
+            if (it != logger.module_levels_.end())
+            {
+                level = it->second;
+            }
+        }
+
+        site.level.store(level, std::memory_order_relaxed);
+        site.generation.store(generation, std::memory_order_release);
     }
 
     void Logger::Log(Level level,
         const char* file,
         int line,
         const char* function,
-        const std::string& message)
+        std::string message)
     {
 
         if (!ShouldLog(level))
@@ -64,25 +206,164 @@ namespace Log
             return;
         }
 
-        Message msg(level, file, line, function, message);
+        Write(level, file, line, function, std::move(message));
+    }
+
+    void Logger::Write(Level level,
+        const char* file,
+        int line,
+        const char* function,
+        std::string message)
+    {
+        // 异步模式：入队即返回；FATAL 无论溢出策略都等待入队，并等待写出后再返回
+        if (auto* async = async_.load(std::memory_order_acquire))
+        {
+            AsyncRecord record;
+            record.level = level;
+            record.file = file;
+            record.line = line;
+            record.function = function;
+            record.steady_ns = SteadyNanoseconds();
+            record.thread_id = std::this_thread::get_id();
+            record.text = std::move(message);
+
+            bool fatal = level >= Level::LVL_FATAL;
+            if (async->Submit(std::move(record), fatal))
+            {
+                if (fatal)
+                {
+                    Flush();
+                }
+                return;
+            }
+            // 处理器已停止：记录未被移走，改为同步写入
+            message = std::move(record.text);
+        }
+
+        WriteToSinks(Message(level, file, line, function, std::move(message)));
+    }
+
+    bool Logger::SubmitEncoded(const LogDescriptor& descriptor, std::string_view payload)
+    {
+        auto* async = async_.load(std::memory_order_acquire);
+        if (async == nullptr || payload.size() > AsyncRecord::kInlinePayload)
+        {
+            return false;
+        }
+
+        AsyncRecord record;
+        record.level = descriptor.level;
+        record.file = descriptor.file;
+        record.line = descriptor.line;
+        record.function = descriptor.function;
+        record.descriptor = &descriptor;
+        record.steady_ns = SteadyNanoseconds();
+        record.thread_id = std::this_thread::get_id();
+        record.thread_number = binary::ThreadNumber();
+        record.payload_size = static_cast<uint32_t>(payload.size());
+        std::memcpy(record.payload, payload.data(), payload.size());
+
+        bool fatal = descriptor.level >= Level::LVL_FATAL;
+        if (!async->Submit(std::move(record), fatal))
+        {
+            return false;
+        }
+        if (fatal)
+        {
+            Flush();
+        }
+        return true;
+    }
+
+    void Logger::LogBinary(const LogDescriptor& descriptor, std::string_view payload)
+    {
+        if (SubmitEncoded(descriptor, payload))
+        {
+            return;
+        }
+        DispatchEncoded(descriptor, binary::ThreadNumber(), SteadyNanoseconds(), std::chrono::system_clock::now(),
+            std::this_thread::get_id(), payload);
+    }
+
+    void Logger::DispatchEncoded(const LogDescriptor& descriptor, uint32_t thread, uint64_t steady_ns,
+        std::chrono::system_clock::time_point timestamp, std::thread::id thread_id, std::string_view payload)
+    {
+        // 只有存在文本 Sink 时才解码参数并格式化，且只格式化一次
+        std::optional<Message> text;
+
+        SinkSnapshot sinks(*this);
+        for (const auto& sink : sinks)
+        {
+            if (!sink->ShouldLog(descriptor.level) || sink->WriteBinary(descriptor, thread, steady_ns, payload))
+            {
+                continue;
+            }
+
+            if (!text)
+            {
+                std::string content;
+                if (!binary::RenderTo(content, descriptor.format, descriptor.arg_types ? descriptor.arg_types : "", payload))
+                {
+                    content = descriptor.format;
+                }
+                text.emplace(descriptor.level, descriptor.file, descriptor.line, descriptor.function, std::move(content));
+                text->timestamp = timestamp;
+                text->thread_id = thread_id;
+            }
+            sink->Write(*text);
+        }
+
+        if (descriptor.level >= Level::LVL_FATAL)
+        {
+            for (const auto& sink : sinks)
+            {
+                sink->Flush();
+            }
+        }
+    }
+
+    void Logger::ProcessRecord(AsyncRecord& record)
+    {
+        auto timestamp = SystemTimeOf(record.steady_ns);
+        if (record.descriptor)
+        {
+            DispatchEncoded(*record.descriptor, record.thread_number, record.steady_ns, timestamp, record.thread_id,
+                record.Payload());
+            return;
+        }
+
+        Message msg(record.level, record.file, record.line, record.function, std::move(record.text));
+        msg.timestamp = timestamp;
+        msg.thread_id = record.thread_id;
         WriteToSinks(msg);
     }
 
     void Logger::AddSink(std::unique_ptr<Sink> sink)
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
-        sinks_.push_back(std::move(sink));
+        auto sinks = std::make_shared<SinkList>(*sinks_.load(std::memory_order_acquire));
+        sinks->push_back(std::move(sink));
+        PublishSinks(std::move(sinks));
     }
 
-    void Logger::AddConsoleSink(Level min_level, bool use_colors, const std::string& pattern)
+    void Logger::PublishSinks(std::shared_ptr<const SinkList> sinks)
     {
-        auto sink = std::make_unique<ConsoleSink>(min_level, use_colors, pattern);
+        // 先替换列表再递增代数：读到新代数的线程一定能读到新列表
+        sinks_.store(std::move(sinks), std::memory_order_release);
+        sinks_generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void Logger::AddConsoleSink(Level min_level, bool use_colors, const std::string& pattern,
+        const ConsoleBatchOptions& batch)
+    {
+        auto sink = std::make_unique<ConsoleSink>(min_level, use_colors, pattern, batch);
         AddSink(std::move(sink));
     }
 
-    void Logger::AddFileSink(const std::string& filename, Level min_level, const std::string& pattern)
+    void Logger::AddFileSink(const std::string& filename, Level min_level, const std::string& pattern,
+        const RotationOptions& rotation)
     {
-        auto sink = std::make_unique<FileSink>(filename, min_level, pattern);
+        auto sink = std::make_unique<FileSink>(filename, min_level, pattern, rotation);
         AddSink(std::move(sink));
     }
 
@@ -90,21 +371,32 @@ namespace Log
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
 
-        sinks_.clear();
-        current_level_ = config.global_level;
+        current_level_.store(config.global_level, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> module_lock(module_mutex_);
+            module_levels_ = { config.module_levels.begin(), config.module_levels.end() };
+        }
+        InvalidateCallSites();
 
+        auto sinks = std::make_shared<SinkList>();
         for (const auto& sink_config : config.sinks)
         {
             auto sink = CreateSink(sink_config);
             if (sink) {
-                sinks_.push_back(std::move(sink));
+                sinks->push_back(std::move(sink));
             }
         }
+        PublishSinks(std::move(sinks));
 
         initialized_ = true;
 
+        if (config.async)
+        {
+            StartAsync(config.async_options);
+        }
+
         Log(Level::LVL_INFO, __FILE__, __LINE__, __func__,
-            "Logger initialized from config with level: " + std::string(LevelToString(current_level_)));
+            "Logger initialized from config with level: " + std::string(LevelToString(GetLevel())));
     }
 
     void Logger::InitializeFromFile(const std::string& config_path)
@@ -119,10 +411,49 @@ namespace Log
         Initialize(config);
     }
 
-    void Logger::Flush()
+    void Logger::StartAsync(const AsyncOptions& options)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (!async_processor_)
+        {
+            async_processor_ = std::make_unique<AsyncLogProcessor>(
+                [this](AsyncRecord& record) { ProcessRecord(record); }, options);
+        }
+        async_processor_->Start();
+        async_.store(async_processor_.get(), std::memory_order_release);
+    }
+
+    void Logger::StopAsync()
+    {
+        AsyncLogProcessor* processor = nullptr;
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            processor = async_.exchange(nullptr, std::memory_order_acq_rel);
+        }
+
+        // 等待后台线程写完期间不持有 mutex_，不阻塞配置修改
+        if (processor)
+        {
+            processor->Stop();
+        }
+    }
+
+    AsyncLogProcessor::Stats Logger::GetAsyncStats() const
     {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
-        for (auto& sink : sinks_)
+        return async_processor_ ? async_processor_->GetStats() : AsyncLogProcessor::Stats{};
+    }
+
+    void Logger::Flush()
+    {
+        // 先等后台线程写完已提交的日志，再刷新各 Sink
+        if (auto* async = async_.load(std::memory_order_acquire))
+        {
+            async->Flush();
+        }
+
+        SinkSnapshot sinks(*this);
+        for (const auto& sink : sinks)
         {
             sink->Flush();
         }
@@ -130,15 +461,14 @@ namespace Log
 
     bool Logger::ShouldLog(Level level) const
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
-        return level >= current_level_;
+        return IsEnabled(level);
     }
 
     void Logger::WriteToSinks(const Message& msg)
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
-
-        for (const auto& sink : sinks_)
+        // 不加锁：读取快照后各 Sink 并行写入
+        SinkSnapshot sinks(*this);
+        for (const auto& sink : sinks)
         {
             if (sink->ShouldLog(msg.level))
             {
@@ -151,17 +481,31 @@ namespace Log
     {
         if (config.type == "console")
         {
-            auto sink = std::make_unique<ConsoleSink>(config.min_level, config.use_colors, config.pattern.empty() ? "" : config.pattern);
+            ConsoleBatchOptions batch;
+            batch.max_bytes = config.batch_size;
+            batch.max_delay_ms = config.batch_delay_ms;
+            auto sink = std::make_unique<ConsoleSink>(config.min_level, config.use_colors, config.pattern.empty() ? "" : config.pattern, batch);
             return sink;
         }
         else if (config.type == "file")
         {
             if (!config.filename.empty())
             {
-                auto sink = std::make_unique<FileSink>(config.filename, config.min_level, config.pattern.empty() ? "" : config.pattern);
+                RotationOptions rotation;
+                rotation.max_size = config.max_size;
+                rotation.max_files = config.max_files;
+                rotation.compress = config.compress;
+                auto sink = std::make_unique<FileSink>(config.filename, config.min_level, config.pattern.empty() ? "" : config.pattern, rotation);
                 return sink;
             }
         }
+        else if (config.type == "binary")
+        {
+            if (!config.filename.empty())
+            {
+                return std::make_unique<BinaryLogSink>(config.filename, config.min_level);
+            }
+        }
 
         return nullptr;
     }
@@ -3,11 +3,19 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
-#include <sqlite3.h>
 
 
 
@@ -20,6 +28,7 @@ namespace RefStorage {
     using NodeID    = std::uint32_t;                                           //节点ID
     using ChunkID   = std::uint64_t;                                           //分片ID
     using FileID    = std::uint64_t;                                           //文件ID
+    using PathID    = std::uint32_t;                                           //路径字典中的路径ID
 
     namespace Common {
 
@@ -33,15 +42,175 @@ namespace RefStorage {
             TimePoint           creat_time_;
         };
 
+        //分片列表：按列紧凑存储，替代 std::vector<ChunkInfo>。
+        //哈希存为定长32字节摘要（64位小写十六进制以外的哈希单独保存原串），分片ID与创建时间按差值、
+        //分片大小按原值以变长整数编码（偏移量即大小的前缀和），每64项一个检查点以支持随机访问；
+        //副本节点不超过3个时内联保存。下标访问与遍历返回轻量视图 ChunkRef（只含已解码的定长字段），
+        //哈希串与副本列表按需从列中读取，需要独立副本时调用 ChunkRef::to_chunk_info()。
+        class ChunkTable {
+            //变长整数列的顺序解码位置
+            struct Cursor {
+                size_t  position_ = 0;
+                int64_t previous_ = 0;
+            };
+
+        public:
+            using Digest = std::array<uint8_t, 32>;
+
+            //分片视图：引用所属的表，不分配内存；表被修改或销毁后失效
+            class ChunkRef {
+            public:
+                [[nodiscard]] size_t index() const { return index_; }
+                [[nodiscard]] ChunkID chunk_id() const { return chunk_id_; }
+                [[nodiscard]] FileSize chunk_size() const { return chunk_size_; }
+                [[nodiscard]] uint32_t replica_count() const { return replica_count_; }
+                [[nodiscard]] TimePoint creat_time() const { return creat_time_; }
+                [[nodiscard]] const Digest& digest() const { return table_->digest(index_); }
+                [[nodiscard]] HashValue hash() const { return table_->hash(index_); }       //构造哈希串
+                [[nodiscard]] std::span<const NodeID> replicas() const { return table_->replicas(index_); }
+
+                //构造独立的 ChunkInfo（分配哈希串与副本列表）
+                [[nodiscard]] ChunkInfo to_chunk_info() const;
+
+            private:
+                friend class ChunkTable;
+
+                ChunkRef(const ChunkTable* table, size_t index, ChunkID chunk_id, FileSize chunk_size,
+                         uint32_t replica_count, TimePoint creat_time)
+                    : table_(table), index_(index), chunk_id_(chunk_id), chunk_size_(chunk_size),
+                      replica_count_(replica_count), creat_time_(creat_time) {}
+
+                const ChunkTable* table_;
+                size_t            index_;
+                ChunkID           chunk_id_;
+                FileSize          chunk_size_;
+                uint32_t          replica_count_;
+                TimePoint         creat_time_;
+            };
+
+            //只读前向迭代器，解引用得到 ChunkRef 视图（按顺序解码，不做随机访问）
+            class const_iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type        = ChunkRef;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = void;
+                using reference         = ChunkRef;
+
+                const_iterator() = default;
+
+                ChunkRef operator*() const;
+                const_iterator& operator++();
+                const_iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+                bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+            private:
+                friend class ChunkTable;
+
+                const_iterator(const ChunkTable* table, size_t index);
+
+                const ChunkTable* table_ = nullptr;
+                size_t            index_ = 0;
+                Cursor            ids_, sizes_, replica_counts_, times_;
+            };
+
+            ChunkTable() = default;
+            ChunkTable(std::initializer_list<ChunkInfo> chunks) {
+                reserve(chunks.size());
+                for (const auto& chunk : chunks) {
+                    push_back(chunk);
+                }
+            }
+
+            [[nodiscard]] size_t size() const { return digests_.size(); }
+            [[nodiscard]] bool empty() const { return digests_.empty(); }
+            void reserve(size_t count);
+            void clear();
+            void push_back(const ChunkInfo& chunk);
+
+            [[nodiscard]] ChunkRef operator[](size_t index) const;
+            [[nodiscard]] ChunkRef at(size_t index) const;                      //越界抛出 std::out_of_range
+            [[nodiscard]] ChunkRef front() const { return (*this)[0]; }
+            [[nodiscard]] ChunkRef back() const { return (*this)[size() - 1]; }
+
+            [[nodiscard]] const_iterator begin() const { return const_iterator(this, 0); }
+            [[nodiscard]] const_iterator end() const;
+
+            //按列访问，不构造 ChunkInfo
+            [[nodiscard]] HashValue hash(size_t index) const;
+            [[nodiscard]] const Digest& digest(size_t index) const { return digests_[index]; }
+            [[nodiscard]] ChunkID chunk_id(size_t index) const;
+            [[nodiscard]] FileSize chunk_size(size_t index) const;
+            [[nodiscard]] FileSize offset(size_t index) const;                  //分片在文件中的起始偏移
+            [[nodiscard]] uint32_t replica_count(size_t index) const;
+            [[nodiscard]] std::span<const NodeID> replicas(size_t index) const;
+            [[nodiscard]] TimePoint creat_time(size_t index) const;
+            [[nodiscard]] FileSize total_size() const { return sizes_.sum_; }
+
+            //占用的内存字节数（含容量余量）
+            [[nodiscard]] size_t memory_usage() const;
+
+        private:
+            static constexpr size_t kCheckpointInterval = 64;
+
+            //变长整数列：delta 为真时保存与前一项之差（zigzag 编码），否则保存原值并维护前缀和
+            class PackedColumn {
+            public:
+                explicit PackedColumn(bool delta) : delta_(delta) {}
+
+                void append(int64_t value, size_t index);
+                [[nodiscard]] int64_t get(size_t index) const;
+                //第 index 项之前所有值的和（仅非差值列）
+                [[nodiscard]] uint64_t prefix_sum(size_t index) const;
+                //从游标处解码下一项
+                int64_t next(Cursor& cursor) const;
+                void reserve(size_t count);
+                void clear();
+                [[nodiscard]] size_t memory_usage() const;
+
+                uint64_t sum_      = 0;
+                int64_t  previous_ = 0;
+
+            private:
+                struct Checkpoint {
+                    uint32_t position_;                                         //字节偏移
+                    int64_t  previous_;                                         //前一项的值（差值列）
+                    uint64_t sum_;                                              //之前各项的和（非差值列）
+                };
+
+                bool                    delta_;
+                std::vector<uint8_t>    bytes_;
+                std::vector<Checkpoint> checkpoints_;
+            };
+
+            //副本节点集合：不超过3个时内联，否则 nodes_[0] 为溢出区中的起始位置
+            struct ReplicaSet {
+                uint32_t count_;
+                NodeID   nodes_[3];
+            };
+
+            static_assert(sizeof(ReplicaSet) == 16, "副本集合应为16字节");
+
+            std::vector<Digest>                          digests_;
+            std::vector<std::pair<uint32_t, HashValue>>  irregular_hashes_;     //非标准哈希原串（按下标有序）
+            PackedColumn                                 ids_{true};
+            PackedColumn                                 sizes_{false};
+            PackedColumn                                 replica_counts_{false};
+            PackedColumn                                 times_{true};
+            std::vector<ReplicaSet>                      replicas_;
+            std::vector<NodeID>                          replica_overflow_;
+        };
+
         //文件元数据
         struct FileMataData {
             FileID                  file_id_;
             std::string             file_name_;
             std::string             path;                                        //文件路径
+            PathID                  path_id_ = 0;                                //所在目录在路径字典中的ID（由元数据管理器驻留）
             FileSize                file_size_;
             HashValue               hash_value_;
             std::string             mime_type_;                                  //文件MIME类型
-            std::vector<ChunkInfo>  chunks_;                                     //分片信息
+            ChunkTable              chunks_;                                     //分片信息
             uint32_t                reference_count_;                            //引用数（用户上传了多少哈希值相同的文件）
             TimePoint               creat_time_;
             TimePoint               last_access_time_;                           //最后上传时间
@@ -80,58 +249,133 @@ namespace RefStorage {
         };
 
 
-        template <typename T>
-        struct Result {
-            StatusCode status_code_;
-            std::string message_;
-            T value_;
-
-            // 构造函数
-            Result() : status_code_(StatusCode::ERROR), message_("Uninitialized"), value_() {}
-            Result(StatusCode code, const std::string& msg, const T& value) : status_code_(code), message_(msg), value_(value) {}       // 可拷贝类型
-            Result(StatusCode code, const std::string& msg, T&& value) : status_code_(code), message_(msg), value_(std::move(value)) {} // 移动
-
-            // 允许移动
-            Result(Result&& other) noexcept : status_code_(other.status_code_), message_(std::move(other.message_)), value_(std::move(other.value_)) {}
-            Result& operator=(Result&& other) noexcept {
-                if (this != &other) {
-                    status_code_ = other.status_code_;
-                    message_ = std::move(other.message_);
-                    value_ = std::move(other.value_);
+        //错误信息：状态码加可选的说明文字。
+        //说明文字为字符串字面量时只保存指针；动态文字或延迟构造函数放在共享的详情对象中，复制错误不复制文字
+        class ErrorInfo {
+        public:
+            using MessageBuilder = std::function<std::string()>;
+
+            //编译期常量字符数组（字符串字面量或静态常量数组），生命周期覆盖整个程序，可以只保存指针。
+            //构造函数为 consteval：运行期的字符数组无法构造 Literal，须转换为 std::string 复制保存
+            class Literal {
+            public:
+                template <size_t N>
+                consteval Literal(const char (&text)[N]) : text_(text) {}
+
+            private:
+                friend class ErrorInfo;
+
+                const char* text_;
+            };
+
+            //可转换为 std::string 的非数组类型（std::string、const char* 指针等），复制保存
+            template <typename S>
+            static constexpr bool kCopiedText = std::is_convertible_v<S, std::string> && !std::is_array_v<std::remove_cvref_t<S>>;
+
+            ErrorInfo() = default;
+            ErrorInfo(StatusCode code, Literal literal) : code_(code), literal_(literal.text_) {}
+            template <typename S>
+                requires kCopiedText<S>
+            ErrorInfo(StatusCode code, S&& message)
+                : code_(code), detail_(std::make_shared<const Detail>(Detail{std::string(std::forward<S>(message)), nullptr})) {}
+            ErrorInfo(StatusCode code, MessageBuilder builder)
+                : code_(code), detail_(std::make_shared<const Detail>(Detail{{}, std::move(builder)})) {}
+
+            [[nodiscard]] StatusCode code() const { return code_; }
+
+            //需要时才构造说明文字
+            [[nodiscard]] std::string message() const {
+                if (detail_) {
+                    return detail_->builder_ ? detail_->builder_() : detail_->text_;
                 }
-                return *this;
+                return literal_ ? std::string(literal_) : std::string();
             }
 
-            // 删除拷贝构造函数和拷贝赋值运算符
-            Result(const Result&) = delete;
-            Result& operator=(const Result&) = delete;
+        private:
+            struct Detail {
+                std::string    text_;
+                MessageBuilder builder_;
+            };
+
+            StatusCode                    code_    = StatusCode::ERROR;
+            const char*                   literal_ = nullptr;
+            std::shared_ptr<const Detail> detail_;
+        };
+
+        //操作结果（std::expected 风格）：成功时只保存值，不分配任何内存；失败时保存 ErrorInfo。
+        //T 不要求可默认构造。失败时访问 value() 抛出 std::bad_variant_access
+        template <typename T>
+        class Result {
+        public:
+            using value_type = T;
+
+            //未赋值的结果视为失败
+            Result() : state_(std::in_place_index<1>, StatusCode::ERROR, ErrorInfo::Literal("Uninitialized")) {}
+
+            static Result<T> Success(T value) {
+                return Result(std::in_place_index<0>, std::move(value));
+            }
+
+            //字符串字面量不分配内存
+            static Result<T> Error(StatusCode code, ErrorInfo::Literal message) {
+                return Result(std::in_place_index<1>, code, message);
+            }
+            //其他文字复制保存
+            template <typename S>
+                requires ErrorInfo::kCopiedText<S>
+            static Result<T> Error(StatusCode code, S&& message) {
+                return Result(std::in_place_index<1>, code, std::string(std::forward<S>(message)));
+            }
+            //说明文字在读取 message() 时才构造（builder 须按值捕获）
+            template <typename Builder>
+                requires std::is_invocable_r_v<std::string, Builder>
+            static Result<T> Error(StatusCode code, Builder builder) {
+                return Result(std::in_place_index<1>, code, ErrorInfo::MessageBuilder(std::move(builder)));
+            }
+            static Result<T> Error(ErrorInfo error) {
+                return Result(std::in_place_index<1>, std::move(error));
+            }
+            //传递另一结果的错误（不复制说明文字）
+            template <typename U>
+            static Result<T> Error(const Result<U>& other) {
+                return Error(other.error());
+            }
 
             //判断操作结果是否成功
-            [[nodiscard]] bool success() const { return status_code_ == StatusCode::OK; }
+            [[nodiscard]] bool success() const { return state_.index() == 0; }
             [[nodiscard]] bool failed() const { return !success(); }
-            //
-            static Result<T> Success(T val) {
-                return {StatusCode::OK, "Success", std::move(val)};
+            explicit operator bool() const { return success(); }
+
+            [[nodiscard]] StatusCode status_code() const {
+                return success() ? StatusCode::OK : std::get<1>(state_).code();
+            }
+            //失败说明，成功时为空串
+            [[nodiscard]] std::string message() const {
+                return success() ? std::string() : std::get<1>(state_).message();
             }
+            //仅在失败时调用
+            [[nodiscard]] const ErrorInfo& error() const { return std::get<1>(state_); }
 
-            static Result<T> Error(StatusCode code, const std::string& msg) {
-                // 对于 unique_ptr 特化处理
-                if constexpr (std::is_same_v<T, std::unique_ptr<sqlite3_stmt, void(*)(sqlite3_stmt*)>>) {
+            [[nodiscard]] T& value() & { return std::get<0>(state_); }
+            [[nodiscard]] const T& value() const & { return std::get<0>(state_); }
+            [[nodiscard]] T&& value() && { return std::get<0>(std::move(state_)); }
 
-                    auto deleter = [](sqlite3_stmt* stmt) {
-                        if (stmt) sqlite3_finalize(stmt);
-                    };
+            template <typename U>
+            [[nodiscard]] T value_or(U&& fallback) const & {
+                return success() ? std::get<0>(state_) : static_cast<T>(std::forward<U>(fallback));
+            }
 
-                    T empty_ptr(nullptr, deleter);
+            T& operator*() & { return value(); }
+            const T& operator*() const & { return value(); }
+            T* operator->() { return &value(); }
+            const T* operator->() const { return &value(); }
 
-                    return {code, msg, std::move(empty_ptr)};
-                } else {
-                    // 其他类型使用原来的方式
-                    return {code, msg, T{}};
-                }
-            }
-        };
+        private:
+            template <size_t I, typename... Args>
+            explicit Result(std::in_place_index_t<I> index, Args&&... args) : state_(index, std::forward<Args>(args)...) {}
 
+            std::variant<T, ErrorInfo> state_;
+        };
 
     }
 
@@ -0,0 +1,122 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "common_types.hpp"
+
+
+namespace RefStorage::Common {
+
+    //元数据批次内存池：单调增长的 pmr 内存池，批内所有字符串、数组都从这里分配，
+    //批次提交后 release() 一次性释放。非线程安全，每个写入线程各持有一个，线程之间没有分配器竞争。
+    class MetadataArena {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        static constexpr size_t kDefaultInitialSize = 64 * 1024;
+
+        //initial_size 为首块大小，用完后按几何级数向上游申请更大的块
+        explicit MetadataArena(size_t initial_size = kDefaultInitialSize);
+
+        MetadataArena(const MetadataArena&) = delete;
+        MetadataArena& operator=(const MetadataArena&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* resource() { return &resource_; }
+        [[nodiscard]] allocator_type allocator() { return allocator_type(&resource_); }
+
+        //释放全部内存（首块保留复用），之前从该池分配的对象全部失效
+        void release();
+
+        //向上游（系统堆）申请的次数与字节数，用于观察每批的实际 malloc 次数
+        [[nodiscard]] size_t upstream_allocations() const { return upstream_.allocations_; }
+        [[nodiscard]] size_t upstream_bytes() const { return upstream_.bytes_; }
+
+    private:
+        //统计申请次数的上游资源（转发给全局 new/delete）
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            size_t allocations_ = 0;
+            size_t bytes_       = 0;
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+            [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        };
+
+        CountingResource                    upstream_;
+        std::unique_ptr<std::byte[]>        initial_buffer_;
+        size_t                              initial_size_;
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+
+    //分片信息（字符串与数组从批次内存池分配）
+    struct ArenaChunkInfo {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        ChunkID                   chunk_id_       = 0;
+        std::pmr::string          hash_value_;
+        FileSize                  file_size_      = 0;
+        uint32_t                  replica_count_  = 0;
+        std::pmr::vector<NodeID>  storage_node_;
+        TimePoint                 creat_time_{};
+
+        ArenaChunkInfo() = default;
+        explicit ArenaChunkInfo(const allocator_type& allocator);
+        ArenaChunkInfo(const ChunkInfo& chunk, const allocator_type& allocator);
+        ArenaChunkInfo(const ArenaChunkInfo& other, const allocator_type& allocator);
+        ArenaChunkInfo(ArenaChunkInfo&& other, const allocator_type& allocator);
+        ArenaChunkInfo(const ArenaChunkInfo&) = default;
+        ArenaChunkInfo(ArenaChunkInfo&&) noexcept = default;
+        ArenaChunkInfo& operator=(const ArenaChunkInfo&) = default;
+        ArenaChunkInfo& operator=(ArenaChunkInfo&&) = default;
+
+        [[nodiscard]] allocator_type get_allocator() const { return hash_value_.get_allocator(); }
+
+        //转换为堆上分配的 ChunkInfo（写入缓存等需要脱离批次生命周期时使用）
+        [[nodiscard]] ChunkInfo to_chunk_info() const;
+    };
+
+    //文件元数据（字符串与分片列表从批次内存池分配）
+    struct ArenaFileMataData {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        FileID                            file_id_          = 0;
+        std::pmr::string                  file_name_;
+        std::pmr::string                  path;                                  //文件路径
+        FileSize                          file_size_        = 0;
+        std::pmr::string                  hash_value_;
+        std::pmr::string                  mime_type_;                            //文件MIME类型
+        std::pmr::vector<ArenaChunkInfo>  chunks_;                               //分片信息
+        uint32_t                          reference_count_  = 0;
+        TimePoint                         creat_time_{};
+        TimePoint                         last_access_time_{};
+
+        ArenaFileMataData() = default;
+        explicit ArenaFileMataData(const allocator_type& allocator);
+        ArenaFileMataData(const FileMataData& file, const allocator_type& allocator);
+        ArenaFileMataData(const ArenaFileMataData& other, const allocator_type& allocator);
+        ArenaFileMataData(ArenaFileMataData&& other, const allocator_type& allocator);
+        ArenaFileMataData(const ArenaFileMataData&) = default;
+        ArenaFileMataData(ArenaFileMataData&&) noexcept = default;
+        ArenaFileMataData& operator=(const ArenaFileMataData&) = default;
+        ArenaFileMataData& operator=(ArenaFileMataData&&) = default;
+
+        [[nodiscard]] allocator_type get_allocator() const { return hash_value_.get_allocator(); }
+
+        //追加一个分片，字符串与数组使用同一内存池
+        ArenaChunkInfo& add_chunk() { return chunks_.emplace_back(); }
+
+        [[nodiscard]] bool isDeduplicated() const { return reference_count_ > 1; }
+
+        //转换为堆上分配的 FileMataData
+        [[nodiscard]] FileMataData to_file_metadata() const;
+    };
+
+}
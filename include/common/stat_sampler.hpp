@@ -0,0 +1,31 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <cstdint>
+
+
+namespace RefStorage::Common {
+
+    //热路径统计的采样率：约每 kStatSampleRate 次调用采样一次
+    inline constexpr uint64_t kStatSampleRate = 64;
+
+    //热路径统计采样：以 1/kStatSampleRate 的概率返回 true，调用方此时把本次的计数乘以 kStatSampleRate
+    //累加到共享计数器。未采样的调用只读写线程本地的随机数状态，不在共享缓存行上做原子读改写；
+    //累计值的期望与逐次累加相同，次数较少时相对误差较大，只用于诊断统计。
+    inline bool sample_stat() {
+        thread_local uint64_t state = 0;
+        if (state == 0) {
+            //各线程的种子取本线程状态变量的地址
+            state = reinterpret_cast<uintptr_t>(&state) | 1;
+        }
+
+        //xorshift64*，取乘积的高6位
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return ((state * 0x2545F4914F6CDD1DULL) >> 58) == 0;
+    }
+
+}
@@ -1,23 +1,14 @@
 --Copyright (c) 2026 Liu Kaizhi
 --Licensed under the Apache License, Version 2.0.
 
--- 文件元数据表
-CREATE TABLE IF NOT EXISTS files (
-    id INTEGER PRIMARY KEY AUTOINCREMENT,
-    hash CHAR(64) UNIQUE NOT NULL,
-    filename VARCHAR(255) NOT NULL,
-    path VARCHAR(1024),
-    size BIGINT NOT NULL,
-    mime_type VARCHAR(100) COMMIT 'MIME类型',
-    reference_count INTEGER DEFAULT 1,
-    deduplication_enabled BOOLEAN DEFAULT 1,
-    created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-    last_accessed_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-    metadata TEXT COMMIT '额外的元数据（Json格式）',
+-- 元数据库表结构的手工初始化脚本（sqlite3 命令行工具），用于手工建库或查看表结构。
+-- 表结构只定义在 scripts/migrations 下：程序构建时把这些文件嵌入 SchemaMigrator，启动时自动创建/升级，
+-- 本脚本按相同顺序读取同一批文件，不另外维护一份表结构。新增迁移时在此追加一行并更新 user_version。
+-- 用法（在仓库根目录执行）：sqlite3 metadata.db < scripts/init_database.sql
+-- 时间字段统一为 Unix 毫秒时间戳。
 
-    INDEX idx_hash (hash),
-    INDEX idx_filename (filename),
-    INDEX idx_created_at (created_at),
-    INDEX idx_reference_count (reference_count)
-);
+.read scripts/migrations/0001_initial_schema.sql
+.read scripts/migrations/0002_gc_progress.sql
+.read scripts/migrations/0003_ref_count_journal.sql
 
+PRAGMA user_version = 3;
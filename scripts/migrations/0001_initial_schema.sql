@@ -0,0 +1,79 @@
+--Copyright (c) 2026 Liu Kaizhi
+--Licensed under the Apache License, Version 2.0.
+
+-- 版本1：files / chunks / file_chunks / storage_nodes / chunk_replicas
+
+-- 文件元数据表
+CREATE TABLE IF NOT EXISTS files (
+    id                    INTEGER PRIMARY KEY AUTOINCREMENT,
+    hash                  TEXT    NOT NULL UNIQUE,                  -- 唯一约束自带索引，按哈希查文件
+    filename              TEXT    NOT NULL,
+    path                  TEXT,
+    size                  INTEGER NOT NULL,
+    mime_type             TEXT,                                     -- MIME类型
+    reference_count       INTEGER NOT NULL DEFAULT 1,
+    deduplication_enabled INTEGER NOT NULL DEFAULT 1,
+    created_at            INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000),
+    last_accessed_at      INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000),
+    metadata              TEXT                                      -- 额外的元数据（Json格式）
+);
+
+-- 目录列举：path 前缀范围扫描
+CREATE INDEX IF NOT EXISTS idx_files_path ON files(path, filename);
+CREATE INDEX IF NOT EXISTS idx_files_created_at ON files(created_at);
+-- 回收候选：只索引引用数为0的文件
+CREATE INDEX IF NOT EXISTS idx_files_unreferenced ON files(last_accessed_at) WHERE reference_count = 0;
+
+-- 分片表：按分片哈希聚簇，去重查询一次B树查找即可命中整行
+CREATE TABLE IF NOT EXISTS chunks (
+    hash            TEXT    NOT NULL PRIMARY KEY,
+    chunk_id        INTEGER NOT NULL,
+    size            INTEGER NOT NULL,
+    replica_count   INTEGER NOT NULL DEFAULT 0,
+    reference_count INTEGER NOT NULL DEFAULT 1,
+    created_at      INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000),
+    updated_at      INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000)  -- 引用数最后变化时间
+) WITHOUT ROWID;
+
+CREATE INDEX IF NOT EXISTS idx_chunks_chunk_id ON chunks(chunk_id);
+-- 垃圾回收候选：只索引引用数为0的分片，按变为0的时间排序
+CREATE INDEX IF NOT EXISTS idx_chunks_unreferenced ON chunks(updated_at, hash) WHERE reference_count = 0;
+
+-- 文件与分片的对应关系：主键 (file_id, chunk_index) 聚簇，列举文件分片时为覆盖扫描
+CREATE TABLE IF NOT EXISTS file_chunks (
+    file_id      INTEGER NOT NULL REFERENCES files(id) ON DELETE CASCADE,
+    chunk_index  INTEGER NOT NULL,                                  -- 分片在文件中的序号
+    chunk_hash   TEXT    NOT NULL,
+    chunk_offset INTEGER NOT NULL,
+    chunk_size   INTEGER NOT NULL,
+    PRIMARY KEY (file_id, chunk_index)
+) WITHOUT ROWID;
+
+-- 反向查询：哪些文件引用了某个分片
+CREATE INDEX IF NOT EXISTS idx_file_chunks_hash ON file_chunks(chunk_hash, file_id);
+
+-- 储存节点表
+CREATE TABLE IF NOT EXISTS storage_nodes (
+    node_id        INTEGER PRIMARY KEY,
+    address        TEXT    NOT NULL,
+    port           INTEGER NOT NULL,
+    total_capacity INTEGER NOT NULL DEFAULT 0,
+    used_capacity  INTEGER NOT NULL DEFAULT 0,
+    is_active      INTEGER NOT NULL DEFAULT 1,
+    last_heartbeat INTEGER NOT NULL DEFAULT 0,
+    UNIQUE (address, port)
+);
+
+-- 调度时只扫描活动节点
+CREATE INDEX IF NOT EXISTS idx_storage_nodes_active ON storage_nodes(used_capacity, total_capacity) WHERE is_active = 1;
+
+-- 分片副本位置：分片 -> 节点
+CREATE TABLE IF NOT EXISTS chunk_replicas (
+    chunk_hash TEXT    NOT NULL REFERENCES chunks(hash) ON DELETE CASCADE,
+    node_id    INTEGER NOT NULL,
+    stored_at  INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000),
+    PRIMARY KEY (chunk_hash, node_id)
+) WITHOUT ROWID;
+
+-- 节点 -> 分片，节点下线时查找需要补副本的分片
+CREATE INDEX IF NOT EXISTS idx_chunk_replicas_node ON chunk_replicas(node_id, chunk_hash);
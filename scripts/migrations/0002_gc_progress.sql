@@ -0,0 +1,16 @@
+--Copyright (c) 2026 Liu Kaizhi
+--Licensed under the Apache License, Version 2.0.
+
+-- 版本2：增量垃圾回收的进度检查点（每个分库一行）
+
+CREATE TABLE IF NOT EXISTS gc_progress (
+    id               INTEGER PRIMARY KEY CHECK (id = 1),
+    cursor_time      INTEGER NOT NULL DEFAULT 0,                    -- 本轮已处理到的候选 (updated_at, hash)
+    cursor_hash      TEXT    NOT NULL DEFAULT '',
+    passes           INTEGER NOT NULL DEFAULT 0,                    -- 已完成的完整轮数
+    reclaimed_chunks INTEGER NOT NULL DEFAULT 0,
+    reclaimed_bytes  INTEGER NOT NULL DEFAULT 0,
+    updated_at       INTEGER NOT NULL DEFAULT 0
+);
+
+INSERT OR IGNORE INTO gc_progress (id) VALUES (1);
@@ -0,0 +1,12 @@
+--Copyright (c) 2026 Liu Kaizhi
+--Licensed under the Apache License, Version 2.0.
+
+-- 版本3：引用数增量日志已写入本分库的最大日志代数（每个分库一行），重放日志时跳过已写入的部分
+
+CREATE TABLE IF NOT EXISTS ref_count_journal (
+    id         INTEGER PRIMARY KEY CHECK (id = 1),
+    epoch      INTEGER NOT NULL DEFAULT 0,
+    updated_at INTEGER NOT NULL DEFAULT 0
+);
+
+INSERT OR IGNORE INTO ref_count_journal (id) VALUES (1);
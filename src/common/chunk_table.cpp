@@ -0,0 +1,298 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "common/common_types.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace RefStorage::Common {
+
+    namespace {
+
+        uint64_t zigzag_encode(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        int64_t zigzag_decode(uint64_t value) {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        void write_varint(std::vector<uint8_t>& bytes, uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+
+        uint64_t read_varint(const std::vector<uint8_t>& bytes, size_t& position) {
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                uint8_t byte = bytes[position++];
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+        }
+
+        int hex_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        }
+
+        //64位小写十六进制哈希解析为32字节摘要，其他格式返回false
+        bool parse_digest(const HashValue& hash, ChunkTable::Digest& digest) {
+            if (hash.size() != digest.size() * 2) {
+                return false;
+            }
+            for (size_t i = 0; i < digest.size(); ++i) {
+                int high = hex_value(hash[2 * i]);
+                int low  = hex_value(hash[2 * i + 1]);
+                if (high < 0 || low < 0) {
+                    return false;
+                }
+                digest[i] = static_cast<uint8_t>((high << 4) | low);
+            }
+            return true;
+        }
+
+        HashValue format_digest(const ChunkTable::Digest& digest) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            HashValue hash(digest.size() * 2, '0');
+            for (size_t i = 0; i < digest.size(); ++i) {
+                hash[2 * i]     = kHex[digest[i] >> 4];
+                hash[2 * i + 1] = kHex[digest[i] & 0x0F];
+            }
+            return hash;
+        }
+
+    }
+
+    // ---------------------------------------------------------------- PackedColumn
+
+    void ChunkTable::PackedColumn::append(int64_t value, size_t index) {
+        if (index % kCheckpointInterval == 0) {
+            checkpoints_.push_back(Checkpoint{static_cast<uint32_t>(bytes_.size()), previous_, sum_});
+        }
+
+        if (delta_) {
+            write_varint(bytes_, zigzag_encode(static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous_))));
+        }
+        else {
+            write_varint(bytes_, static_cast<uint64_t>(value));
+            sum_ += static_cast<uint64_t>(value);
+        }
+        previous_ = value;
+    }
+
+    int64_t ChunkTable::PackedColumn::next(Cursor& cursor) const {
+        auto raw = read_varint(bytes_, cursor.position_);
+        if (delta_) {
+            cursor.previous_ = static_cast<int64_t>(static_cast<uint64_t>(cursor.previous_) + static_cast<uint64_t>(zigzag_decode(raw)));
+        }
+        else {
+            cursor.previous_ = static_cast<int64_t>(raw);
+        }
+        return cursor.previous_;
+    }
+
+    int64_t ChunkTable::PackedColumn::get(size_t index) const {
+        const auto& checkpoint = checkpoints_[index / kCheckpointInterval];
+        Cursor cursor{checkpoint.position_, checkpoint.previous_};
+
+        int64_t value = 0;
+        for (size_t i = index - index % kCheckpointInterval; i <= index; ++i) {
+            value = next(cursor);
+        }
+        return value;
+    }
+
+    uint64_t ChunkTable::PackedColumn::prefix_sum(size_t index) const {
+        if (index / kCheckpointInterval >= checkpoints_.size()) {
+            return sum_;
+        }
+
+        const auto& checkpoint = checkpoints_[index / kCheckpointInterval];
+        Cursor cursor{checkpoint.position_, checkpoint.previous_};
+
+        uint64_t sum = checkpoint.sum_;
+        for (size_t i = index - index % kCheckpointInterval; i < index; ++i) {
+            sum += static_cast<uint64_t>(next(cursor));
+        }
+        return sum;
+    }
+
+    void ChunkTable::PackedColumn::reserve(size_t count) {
+        bytes_.reserve(count * 2);
+        checkpoints_.reserve(count / kCheckpointInterval + 1);
+    }
+
+    void ChunkTable::PackedColumn::clear() {
+        bytes_.clear();
+        checkpoints_.clear();
+        sum_      = 0;
+        previous_ = 0;
+    }
+
+    size_t ChunkTable::PackedColumn::memory_usage() const {
+        return bytes_.capacity() + checkpoints_.capacity() * sizeof(Checkpoint);
+    }
+
+    // ---------------------------------------------------------------- ChunkTable
+
+    void ChunkTable::reserve(size_t count) {
+        digests_.reserve(count);
+        replicas_.reserve(count);
+        ids_.reserve(count);
+        sizes_.reserve(count);
+        replica_counts_.reserve(count);
+        times_.reserve(count);
+    }
+
+    void ChunkTable::clear() {
+        digests_.clear();
+        irregular_hashes_.clear();
+        ids_.clear();
+        sizes_.clear();
+        replica_counts_.clear();
+        times_.clear();
+        replicas_.clear();
+        replica_overflow_.clear();
+    }
+
+    void ChunkTable::push_back(const ChunkInfo& chunk) {
+        auto index = digests_.size();
+
+        Digest digest{};
+        if (!parse_digest(chunk.hash_value_, digest)) {
+            digest.fill(0);
+            irregular_hashes_.emplace_back(static_cast<uint32_t>(index), chunk.hash_value_);
+        }
+        digests_.push_back(digest);
+
+        ids_.append(static_cast<int64_t>(chunk.chunk_id_), index);
+        sizes_.append(static_cast<int64_t>(chunk.file_size_), index);
+        replica_counts_.append(chunk.replica_count_, index);
+        times_.append(chunk.creat_time_.time_since_epoch().count(), index);
+
+        ReplicaSet set{static_cast<uint32_t>(chunk.storage_node_.size()), {0, 0, 0}};
+        if (chunk.storage_node_.size() <= 3) {
+            std::copy(chunk.storage_node_.begin(), chunk.storage_node_.end(), set.nodes_);
+        }
+        else {
+            set.nodes_[0] = static_cast<NodeID>(replica_overflow_.size());
+            replica_overflow_.insert(replica_overflow_.end(), chunk.storage_node_.begin(), chunk.storage_node_.end());
+        }
+        replicas_.push_back(set);
+    }
+
+    ChunkTable::ChunkRef ChunkTable::operator[](size_t index) const {
+        return ChunkRef(this, index, chunk_id(index), chunk_size(index), replica_count(index), creat_time(index));
+    }
+
+    ChunkTable::ChunkRef ChunkTable::at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("ChunkTable::at 下标越界");
+        }
+        return (*this)[index];
+    }
+
+    ChunkTable::const_iterator ChunkTable::end() const {
+        const_iterator it;
+        it.table_ = this;
+        it.index_ = size();
+        return it;
+    }
+
+    HashValue ChunkTable::hash(size_t index) const {
+        if (!irregular_hashes_.empty()) {
+            auto it = std::lower_bound(irregular_hashes_.begin(), irregular_hashes_.end(), static_cast<uint32_t>(index),
+                                       [](const auto& entry, uint32_t value) { return entry.first < value; });
+            if (it != irregular_hashes_.end() && it->first == index) {
+                return it->second;
+            }
+        }
+        return format_digest(digests_[index]);
+    }
+
+    ChunkID ChunkTable::chunk_id(size_t index) const {
+        return static_cast<ChunkID>(ids_.get(index));
+    }
+
+    FileSize ChunkTable::chunk_size(size_t index) const {
+        return static_cast<FileSize>(sizes_.get(index));
+    }
+
+    FileSize ChunkTable::offset(size_t index) const {
+        return sizes_.prefix_sum(index);
+    }
+
+    uint32_t ChunkTable::replica_count(size_t index) const {
+        return static_cast<uint32_t>(replica_counts_.get(index));
+    }
+
+    std::span<const NodeID> ChunkTable::replicas(size_t index) const {
+        const auto& set = replicas_[index];
+        if (set.count_ <= 3) {
+            return {set.nodes_, set.count_};
+        }
+        return {replica_overflow_.data() + set.nodes_[0], set.count_};
+    }
+
+    TimePoint ChunkTable::creat_time(size_t index) const {
+        return TimePoint(TimePoint::duration(times_.get(index)));
+    }
+
+    size_t ChunkTable::memory_usage() const {
+        size_t irregular = irregular_hashes_.capacity() * sizeof(irregular_hashes_[0]);
+        for (const auto& entry : irregular_hashes_) {
+            irregular += entry.second.capacity();
+        }
+
+        return digests_.capacity() * sizeof(Digest) + irregular +
+               ids_.memory_usage() + sizes_.memory_usage() + replica_counts_.memory_usage() + times_.memory_usage() +
+               replicas_.capacity() * sizeof(ReplicaSet) + replica_overflow_.capacity() * sizeof(NodeID);
+    }
+
+    // ---------------------------------------------------------------- ChunkRef
+
+    ChunkInfo ChunkTable::ChunkRef::to_chunk_info() const {
+        ChunkInfo chunk{};
+        chunk.chunk_id_      = chunk_id_;
+        chunk.hash_value_    = hash();
+        chunk.file_size_     = chunk_size_;
+        chunk.replica_count_ = replica_count_;
+        auto nodes = replicas();
+        chunk.storage_node_.assign(nodes.begin(), nodes.end());
+        chunk.creat_time_    = creat_time_;
+        return chunk;
+    }
+
+    // ---------------------------------------------------------------- const_iterator
+
+    ChunkTable::const_iterator::const_iterator(const ChunkTable* table, size_t index) : table_(table), index_(index) {}
+
+    ChunkTable::ChunkRef ChunkTable::const_iterator::operator*() const {
+        //从游标解码当前项（游标指向当前项之前，解码用副本）
+        auto ids = ids_, sizes = sizes_, replica_counts = replica_counts_, times = times_;
+
+        auto chunk_id      = static_cast<ChunkID>(table_->ids_.next(ids));
+        auto chunk_size    = static_cast<FileSize>(table_->sizes_.next(sizes));
+        auto replica_count = static_cast<uint32_t>(table_->replica_counts_.next(replica_counts));
+        auto creat_time    = TimePoint(TimePoint::duration(table_->times_.next(times)));
+        return ChunkRef(table_, index_, chunk_id, chunk_size, replica_count, creat_time);
+    }
+
+    ChunkTable::const_iterator& ChunkTable::const_iterator::operator++() {
+        table_->ids_.next(ids_);
+        table_->sizes_.next(sizes_);
+        table_->replica_counts_.next(replica_counts_);
+        table_->times_.next(times_);
+        ++index_;
+        return *this;
+    }
+
+}
@@ -0,0 +1,147 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "common/metadata_arena.hpp"
+
+
+namespace RefStorage::Common {
+
+    // ---------------------------------------------------------------- MetadataArena
+
+    MetadataArena::MetadataArena(size_t initial_size)
+        : initial_buffer_(std::make_unique<std::byte[]>(initial_size))
+        , initial_size_(initial_size)
+        , resource_(initial_buffer_.get(), initial_size, &upstream_) {}
+
+    void MetadataArena::release() {
+        resource_.release();
+    }
+
+    void* MetadataArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+        ++allocations_;
+        bytes_ += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void MetadataArena::CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    // ---------------------------------------------------------------- ArenaChunkInfo
+
+    ArenaChunkInfo::ArenaChunkInfo(const allocator_type& allocator)
+        : hash_value_(allocator)
+        , storage_node_(allocator) {}
+
+    ArenaChunkInfo::ArenaChunkInfo(const ChunkInfo& chunk, const allocator_type& allocator)
+        : chunk_id_(chunk.chunk_id_)
+        , hash_value_(chunk.hash_value_, allocator)
+        , file_size_(chunk.file_size_)
+        , replica_count_(chunk.replica_count_)
+        , storage_node_(chunk.storage_node_.begin(), chunk.storage_node_.end(), allocator)
+        , creat_time_(chunk.creat_time_) {}
+
+    ArenaChunkInfo::ArenaChunkInfo(const ArenaChunkInfo& other, const allocator_type& allocator)
+        : chunk_id_(other.chunk_id_)
+        , hash_value_(other.hash_value_, allocator)
+        , file_size_(other.file_size_)
+        , replica_count_(other.replica_count_)
+        , storage_node_(other.storage_node_, allocator)
+        , creat_time_(other.creat_time_) {}
+
+    ArenaChunkInfo::ArenaChunkInfo(ArenaChunkInfo&& other, const allocator_type& allocator)
+        : chunk_id_(other.chunk_id_)
+        , hash_value_(std::move(other.hash_value_), allocator)
+        , file_size_(other.file_size_)
+        , replica_count_(other.replica_count_)
+        , storage_node_(std::move(other.storage_node_), allocator)
+        , creat_time_(other.creat_time_) {}
+
+    ChunkInfo ArenaChunkInfo::to_chunk_info() const {
+        ChunkInfo chunk{};
+        chunk.chunk_id_      = chunk_id_;
+        chunk.hash_value_.assign(hash_value_.data(), hash_value_.size());
+        chunk.file_size_     = file_size_;
+        chunk.replica_count_ = replica_count_;
+        chunk.storage_node_.assign(storage_node_.begin(), storage_node_.end());
+        chunk.creat_time_    = creat_time_;
+        return chunk;
+    }
+
+    // ---------------------------------------------------------------- ArenaFileMataData
+
+    ArenaFileMataData::ArenaFileMataData(const allocator_type& allocator)
+        : file_name_(allocator)
+        , path(allocator)
+        , hash_value_(allocator)
+        , mime_type_(allocator)
+        , chunks_(allocator) {}
+
+    ArenaFileMataData::ArenaFileMataData(const FileMataData& file, const allocator_type& allocator)
+        : file_id_(file.file_id_)
+        , file_name_(file.file_name_, allocator)
+        , path(file.path, allocator)
+        , file_size_(file.file_size_)
+        , hash_value_(file.hash_value_, allocator)
+        , mime_type_(file.mime_type_, allocator)
+        , chunks_(allocator)
+        , reference_count_(file.reference_count_)
+        , creat_time_(file.creat_time_)
+        , last_access_time_(file.last_access_time_) {
+        chunks_.reserve(file.chunks_.size());
+        for (const auto& chunk : file.chunks_) {
+            auto hash  = chunk.hash();
+            auto nodes = chunk.replicas();
+            auto& stored = chunks_.emplace_back();
+            stored.chunk_id_      = chunk.chunk_id();
+            stored.hash_value_.assign(hash.data(), hash.size());
+            stored.file_size_     = chunk.chunk_size();
+            stored.replica_count_ = chunk.replica_count();
+            stored.storage_node_.assign(nodes.begin(), nodes.end());
+            stored.creat_time_    = chunk.creat_time();
+        }
+    }
+
+    ArenaFileMataData::ArenaFileMataData(const ArenaFileMataData& other, const allocator_type& allocator)
+        : file_id_(other.file_id_)
+        , file_name_(other.file_name_, allocator)
+        , path(other.path, allocator)
+        , file_size_(other.file_size_)
+        , hash_value_(other.hash_value_, allocator)
+        , mime_type_(other.mime_type_, allocator)
+        , chunks_(other.chunks_, allocator)
+        , reference_count_(other.reference_count_)
+        , creat_time_(other.creat_time_)
+        , last_access_time_(other.last_access_time_) {}
+
+    ArenaFileMataData::ArenaFileMataData(ArenaFileMataData&& other, const allocator_type& allocator)
+        : file_id_(other.file_id_)
+        , file_name_(std::move(other.file_name_), allocator)
+        , path(std::move(other.path), allocator)
+        , file_size_(other.file_size_)
+        , hash_value_(std::move(other.hash_value_), allocator)
+        , mime_type_(std::move(other.mime_type_), allocator)
+        , chunks_(std::move(other.chunks_), allocator)
+        , reference_count_(other.reference_count_)
+        , creat_time_(other.creat_time_)
+        , last_access_time_(other.last_access_time_) {}
+
+    FileMataData ArenaFileMataData::to_file_metadata() const {
+        FileMataData file{};
+        file.file_id_          = file_id_;
+        file.file_name_.assign(file_name_.data(), file_name_.size());
+        file.path.assign(path.data(), path.size());
+        file.file_size_        = file_size_;
+        file.hash_value_.assign(hash_value_.data(), hash_value_.size());
+        file.mime_type_.assign(mime_type_.data(), mime_type_.size());
+        file.chunks_.reserve(chunks_.size());
+        for (const auto& chunk : chunks_) {
+            file.chunks_.push_back(chunk.to_chunk_info());
+        }
+        file.reference_count_  = reference_count_;
+        file.creat_time_       = creat_time_;
+        file.last_access_time_ = last_access_time_;
+        return file;
+    }
+
+}
@@ -0,0 +1,133 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include "common/common_types.hpp"
+#include "redo_log.hpp"
+
+
+namespace RefStorage::Core {
+
+    //分片位置
+    struct ChunkLocation {
+        ChunkID  chunk_id_;
+        NodeID   node_id_;                                                      //首个储存节点
+        uint32_t size_;                                                         //分片大小
+    };
+
+    //索引键：分片摘要的前128位（十六进制哈希直接解析，其他哈希取其散列值）
+    struct ChunkKey {
+        std::array<uint8_t, 16> bytes_;
+
+        static ChunkKey from_hash(const HashValue& hash);
+        bool operator==(const ChunkKey&) const = default;
+    };
+
+    //索引配置
+    struct ChunkIndexOptions {
+        std::filesystem::path directory_;                                       //索引文件所在目录
+        size_t                initial_blocks_        = 256;                      //初始块数（2的幂，每块4KiB）
+        double                max_load_factor_       = 0.85;                     //占用槽位（含墓碑）超过后扩容
+        size_t                migrate_blocks_per_op_ = 4;                        //扩容期间每次写入顺带迁移的旧块数
+        uint64_t              checkpoint_interval_   = uint64_t{1} << 16;        //重做日志达到该记录数时自动做检查点
+        bool                  sync_redo_log_         = false;                    //每条重做记录都 fsync
+    };
+
+    //索引统计
+    struct ChunkIndexStats {
+        uint64_t items_;
+        uint64_t capacity_;                                                     //当前表的槽位数
+        uint64_t occupied_;                                                     //当前表已占用槽位（含墓碑）
+        uint64_t blocks_;
+        bool     migrating_;                                                    //是否正在渐进扩容
+        uint64_t migrate_cursor_;                                               //旧表已迁移的块数
+        uint64_t redo_records_;                                                 //上次检查点后的重做记录数
+        uint64_t lookups_;                                                      //查询次数（采样估计）
+        uint64_t block_probes_;                                                 //查询访问的块数（每块一页，采样估计）
+
+        [[nodiscard]] double probes_per_lookup() const {
+            return lookups_ > 0 ? static_cast<double>(block_probes_) / lookups_ : 0.0;
+        }
+    };
+
+    //内存映射的磁盘分片索引（哈希 -> 位置），Swiss table 风格的开放寻址：
+    //表由4KiB的块组成，每块128个控制字节（7位标签/空/墓碑）加124个32字节槽位，一块恰好一页，
+    //查询在一块内用SSE2一次比较16个标签，通常只访问一页（一次缺页或一次缓存未命中）。块满时顺延到下一块。
+    //扩容时新建两倍大小的表，旧表按块渐进迁移（每次写入顺带迁移若干块），迁移期间先查新表再查旧表。
+    //所有变更先写重做日志；检查点把映射表写回磁盘后截断日志，异常退出后打开时重放日志并重新统计。
+    //块与页对齐，单个变更只写一页，依赖页写入的原子性。
+    class ChunkIndex {
+    public:
+        explicit ChunkIndex(ChunkIndexOptions options);
+        ~ChunkIndex();
+
+        ChunkIndex(const ChunkIndex&) = delete;
+        ChunkIndex& operator=(const ChunkIndex&) = delete;
+
+        //打开（不存在则创建）；上次未正常关闭时重放重做日志
+        Common::Result<bool> open();
+        //做检查点并关闭
+        void close();
+        [[nodiscard]] bool is_open() const { return current_ != nullptr; }
+
+        [[nodiscard]] std::optional<ChunkLocation> find(const HashValue& hash) const { return find(ChunkKey::from_hash(hash)); }
+        [[nodiscard]] std::optional<ChunkLocation> find(const ChunkKey& key) const;
+
+        //插入或更新
+        Common::Result<bool> put(const HashValue& hash, const ChunkLocation& location) { return put(ChunkKey::from_hash(hash), location); }
+        Common::Result<bool> put(const ChunkKey& key, const ChunkLocation& location);
+
+        //删除，value_ 表示键是否存在
+        Common::Result<bool> erase(const HashValue& hash) { return erase(ChunkKey::from_hash(hash)); }
+        Common::Result<bool> erase(const ChunkKey& key);
+
+        //把映射表写回磁盘并截断重做日志
+        Common::Result<bool> checkpoint();
+
+        //扩容期间迁移最多 blocks 个旧块（可由后台线程调用加快迁移），返回实际迁移数
+        size_t migrate_step(size_t blocks);
+        [[nodiscard]] bool is_migrating() const;
+
+        [[nodiscard]] ChunkIndexStats stats() const;
+
+    private:
+        struct Table;
+
+        //不加锁、不写日志的内部操作
+        std::optional<ChunkLocation> find_locked(const ChunkKey& key) const;
+        Common::Result<bool> put_locked(const ChunkKey& key, const ChunkLocation& location);
+        bool erase_locked(const ChunkKey& key);
+        void apply(const RedoRecord& record);
+
+        Common::Result<bool> start_migration();
+        size_t migrate_locked(size_t blocks);
+        Common::Result<bool> finish_migration();
+        Common::Result<bool> checkpoint_locked();
+        Common::Result<bool> write_meta(bool clean);
+        Common::Result<std::unique_ptr<Table>> open_table(uint64_t generation, uint64_t blocks, bool initialize) const;
+        //异常退出后重新统计键数与各表占用槽位
+        void recount();
+        [[nodiscard]] std::filesystem::path table_path(uint64_t generation) const;
+
+        ChunkIndexOptions          options_;
+        mutable std::shared_mutex  mutex_;
+        std::unique_ptr<Table>     current_;
+        std::unique_ptr<Table>     previous_;                                   //扩容期间的旧表
+        uint64_t                   migrate_cursor_ = 0;
+        uint64_t                   items_          = 0;
+        uint64_t                   last_lsn_       = 0;
+        uint64_t                   checkpoint_lsn_ = 0;
+        RedoLog                    redo_log_;
+
+        mutable std::atomic<uint64_t> lookups_{0};                              //按 Common::sample_stat 采样累加
+        mutable std::atomic<uint64_t> block_probes_{0};
+    };
+
+}
@@ -0,0 +1,50 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::Core {
+
+    //可读写的内存映射文件（Windows 与 POSIX）
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        //打开（不存在则创建）并映射整个文件；文件小于 size 时扩展到 size（新增部分为0）
+        Common::Result<bool> open(const std::filesystem::path& path, size_t size);
+        //解除映射并关闭
+        void close();
+
+        //把脏页同步写入磁盘
+        Common::Result<bool> flush();
+        //提示内核访问是随机的，不做预读（机械盘上避免读入用不到的页）
+        void advise_random();
+
+        [[nodiscard]] bool is_open() const { return data_ != nullptr; }
+        [[nodiscard]] uint8_t* data() const { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+
+    private:
+        std::filesystem::path path_;
+        uint8_t*              data_ = nullptr;
+        size_t                size_ = 0;
+#ifdef _WIN32
+        void*                 file_handle_    = nullptr;
+        void*                 mapping_handle_ = nullptr;
+#else
+        int                   fd_ = -1;
+#endif
+    };
+
+}
@@ -0,0 +1,66 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::Core {
+
+    //重做日志记录（定长，带校验和，崩溃时写了一半的尾部记录在重放时被丢弃）
+    struct RedoRecord {
+        enum class Op : uint8_t {
+            PUT   = 1,
+            ERASE = 2
+        };
+
+        uint64_t                lsn_;
+        Op                      op_;
+        std::array<uint8_t, 16> key_;
+        uint64_t                chunk_id_;
+        uint32_t                node_id_;
+        uint32_t                size_;
+    };
+
+    //追加写的重做日志：变更先写日志再改映射表，检查点把映射表写回磁盘后截断日志
+    class RedoLog {
+    public:
+        RedoLog() = default;
+        ~RedoLog();
+
+        RedoLog(const RedoLog&) = delete;
+        RedoLog& operator=(const RedoLog&) = delete;
+
+        //sync 为 true 时每条记录都 fsync（掉电也不丢），否则只写入系统缓存（进程崩溃不丢）
+        Common::Result<bool> open(const std::filesystem::path& path, bool sync);
+        void close();
+
+        Common::Result<bool> append(const RedoRecord& record);
+
+        //按顺序重放 lsn 大于 after_lsn 的有效记录，返回最后一条的 lsn
+        Common::Result<uint64_t> replay(uint64_t after_lsn, const std::function<void(const RedoRecord&)>& apply);
+
+        //清空日志（检查点完成后调用）
+        Common::Result<bool> truncate();
+
+        [[nodiscard]] uint64_t record_count() const { return record_count_; }
+
+    private:
+        static constexpr size_t kRecordSize = 56;
+
+        static void encode(const RedoRecord& record, uint8_t* buffer);
+        static bool decode(const uint8_t* buffer, RedoRecord& record);
+
+        std::filesystem::path path_;
+        std::FILE*            file_         = nullptr;
+        bool                  sync_         = false;
+        uint64_t              record_count_ = 0;
+    };
+
+}
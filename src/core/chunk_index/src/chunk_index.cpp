@@ -0,0 +1,742 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/chunk_index.hpp"
+#include "../include/mapped_file.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include "common/stat_sampler.hpp"
+#include "Log.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define REFSTORAGE_CHUNK_INDEX_SSE2 1
+#endif
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        constexpr size_t kBlockSize   = 4096;
+        constexpr size_t kCtrlBytes   = 128;
+        constexpr size_t kSlots       = 124;
+        constexpr size_t kGroupWidth  = 16;
+        constexpr size_t kGroups      = kCtrlBytes / kGroupWidth;
+
+        //控制字节：0~127 为占用（键的7位标签），其余为特殊值
+        constexpr int8_t kEmpty    = -128;
+        constexpr int8_t kDeleted  = -2;
+        constexpr int8_t kSentinel = -1;                                        //块尾没有槽位的填充字节，不与任何值匹配
+
+        constexpr uint32_t kMetaMagic   = 0x58494352;                           //"RCIX"
+        constexpr uint32_t kMetaVersion = 1;
+
+        struct Slot {
+            uint8_t  key_[16];
+            uint64_t chunk_id_;
+            uint32_t node_id_;
+            uint32_t size_;
+        };
+
+        struct Block {
+            int8_t ctrl_[kCtrlBytes];
+            Slot   slots_[kSlots];
+        };
+
+        static_assert(sizeof(Slot) == 32, "槽位应为32字节");
+        static_assert(sizeof(Block) == kBlockSize, "一块应恰好一页");
+
+        //元数据文件（先写临时文件再改名）
+        struct Meta {
+            uint32_t magic_;
+            uint32_t version_;
+            uint64_t generation_;
+            uint64_t block_count_;
+            uint64_t occupied_;
+            uint64_t previous_generation_;                                      //0 表示没有进行中的扩容
+            uint64_t previous_block_count_;
+            uint64_t previous_occupied_;
+            uint64_t migrate_cursor_;
+            uint64_t items_;
+            uint64_t checkpoint_lsn_;
+            uint32_t clean_;                                                    //是否正常关闭
+            uint32_t reserved_;
+            uint64_t checksum_;
+        };
+
+        uint64_t fnv1a(const void* data, size_t size, uint64_t seed) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            uint64_t h = seed;
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ bytes[i]) * 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        int hex_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        uint64_t home_hash(const ChunkKey& key) {
+            uint64_t h = 0;
+            std::memcpy(&h, key.bytes_.data(), sizeof(h));
+            return h;
+        }
+
+        int8_t tag_of(const ChunkKey& key) {
+            return static_cast<int8_t>(key.bytes_[8] & 0x7F);
+        }
+
+#ifdef REFSTORAGE_CHUNK_INDEX_SSE2
+        //组内等于 value 的控制字节位图
+        uint32_t match_byte(const int8_t* group, int8_t value) {
+            auto ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+        }
+
+        //组内空或墓碑（可写入）的位图：两者都小于 kSentinel
+        uint32_t match_free(const int8_t* group) {
+            auto ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), ctrl)));
+        }
+#else
+        uint32_t match_byte(const int8_t* group, int8_t value) {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<uint32_t>(group[i] == value) << i;
+            }
+            return mask;
+        }
+
+        uint32_t match_free(const int8_t* group) {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<uint32_t>(group[i] < kSentinel) << i;
+            }
+            return mask;
+        }
+#endif
+
+        bool block_has_empty(const Block& block) {
+            for (size_t g = 0; g < kGroups; ++g) {
+                if (match_byte(block.ctrl_ + g * kGroupWidth, kEmpty) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    }
+
+    ChunkKey ChunkKey::from_hash(const HashValue& hash) {
+        ChunkKey key{};
+
+        bool is_hex = hash.size() >= 32;
+        for (size_t i = 0; is_hex && i < 16; ++i) {
+            int high = hex_value(hash[2 * i]);
+            int low  = hex_value(hash[2 * i + 1]);
+            is_hex = high >= 0 && low >= 0;
+            key.bytes_[i] = static_cast<uint8_t>((high << 4) | low);
+        }
+
+        if (!is_hex) {
+            auto first  = fnv1a(hash.data(), hash.size(), 0xcbf29ce484222325ULL);
+            auto second = fnv1a(hash.data(), hash.size(), first ^ 0x9E3779B97F4A7C15ULL);
+            std::memcpy(key.bytes_.data(), &first, 8);
+            std::memcpy(key.bytes_.data() + 8, &second, 8);
+        }
+        return key;
+    }
+
+    struct ChunkIndex::Table {
+        uint64_t   generation_  = 0;
+        uint64_t   block_count_ = 0;
+        uint64_t   mask_        = 0;
+        uint64_t   occupied_    = 0;                                            //占用与墓碑槽位数
+        MappedFile file_;
+
+        [[nodiscard]] Block& block(uint64_t index) const { return reinterpret_cast<Block*>(file_.data())[index & mask_]; }
+        [[nodiscard]] uint64_t capacity() const { return block_count_ * kSlots; }
+
+        //查找键所在槽位，probes 累加访问的块数
+        Slot* find(const ChunkKey& key, uint64_t& probes) const {
+            auto home = home_hash(key);
+            auto tag  = tag_of(key);
+
+            for (uint64_t i = 0; i < block_count_; ++i) {
+                auto& current = block(home + i);
+                ++probes;
+
+                bool has_empty = false;
+                for (size_t g = 0; g < kGroups; ++g) {
+                    const int8_t* group = current.ctrl_ + g * kGroupWidth;
+                    for (auto mask = match_byte(group, tag); mask != 0; mask &= mask - 1) {
+                        auto& slot = current.slots_[g * kGroupWidth + std::countr_zero(mask)];
+                        if (std::memcmp(slot.key_, key.bytes_.data(), sizeof(slot.key_)) == 0) {
+                            return &slot;
+                        }
+                    }
+                    has_empty = has_empty || match_byte(group, kEmpty) != 0;
+                }
+
+                //块中有空槽说明这块从未满过，键不会顺延到后面的块
+                if (has_empty) {
+                    return nullptr;
+                }
+            }
+            return nullptr;
+        }
+
+        //插入（调用方保证键不存在），表满时返回false
+        bool insert(const ChunkKey& key, const ChunkLocation& location) {
+            auto home = home_hash(key);
+
+            for (uint64_t i = 0; i < block_count_; ++i) {
+                auto& current = block(home + i);
+                for (size_t g = 0; g < kGroups; ++g) {
+                    auto mask = match_free(current.ctrl_ + g * kGroupWidth);
+                    if (mask == 0) {
+                        continue;
+                    }
+
+                    auto index = g * kGroupWidth + std::countr_zero(mask);
+                    auto& slot = current.slots_[index];
+                    std::memcpy(slot.key_, key.bytes_.data(), sizeof(slot.key_));
+                    slot.chunk_id_ = location.chunk_id_;
+                    slot.node_id_  = location.node_id_;
+                    slot.size_     = location.size_;
+
+                    if (current.ctrl_[index] == kEmpty) {
+                        ++occupied_;
+                    }
+                    current.ctrl_[index] = tag_of(key);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //删除键的所有副本（异常退出后同一键可能在探测链上残留多份），返回是否存在
+        bool erase(const ChunkKey& key) {
+            auto home = home_hash(key);
+            auto tag  = tag_of(key);
+            bool erased = false;
+
+            for (uint64_t i = 0; i < block_count_; ++i) {
+                auto& current = block(home + i);
+                bool has_empty = block_has_empty(current);
+
+                for (size_t g = 0; g < kGroups; ++g) {
+                    for (auto mask = match_byte(current.ctrl_ + g * kGroupWidth, tag); mask != 0; mask &= mask - 1) {
+                        auto index = g * kGroupWidth + std::countr_zero(mask);
+                        if (std::memcmp(current.slots_[index].key_, key.bytes_.data(), 16) != 0) {
+                            continue;
+                        }
+                        //从未满过的块可以直接置空，否则留墓碑以免截断其他键的探测链
+                        current.ctrl_[index] = has_empty ? kEmpty : kDeleted;
+                        if (has_empty) {
+                            --occupied_;
+                        }
+                        erased = true;
+                    }
+                }
+
+                if (has_empty) {
+                    break;
+                }
+            }
+            return erased;
+        }
+    };
+
+    ChunkIndex::ChunkIndex(ChunkIndexOptions options) : options_(std::move(options)) {}
+
+    ChunkIndex::~ChunkIndex() {
+        close();
+    }
+
+    std::filesystem::path ChunkIndex::table_path(uint64_t generation) const {
+        return options_.directory_ / ("chunk-index-" + std::to_string(generation) + ".tbl");
+    }
+
+    Common::Result<std::unique_ptr<ChunkIndex::Table>> ChunkIndex::open_table(uint64_t generation, uint64_t blocks, bool initialize) const {
+        using TableResult = Common::Result<std::unique_ptr<Table>>;
+
+        auto path = table_path(generation);
+        if (initialize) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+        else if (!std::filesystem::exists(path)) {
+            return TableResult::Error(Common::StatusCode::FILE_NOT_FOUND, "分片索引表文件缺失：" + path.string());
+        }
+
+        auto table = std::make_unique<Table>();
+        auto opened = table->file_.open(path, blocks * kBlockSize);
+        if (opened.failed()) {
+            return TableResult::Error(opened);
+        }
+        if (table->file_.size() != blocks * kBlockSize) {
+            return TableResult::Error(Common::StatusCode::ERROR, "分片索引表大小与元数据不符：" + path.string());
+        }
+
+        table->generation_  = generation;
+        table->block_count_ = blocks;
+        table->mask_        = blocks - 1;
+
+        if (initialize) {
+            for (uint64_t i = 0; i < blocks; ++i) {
+                auto& block = table->block(i);
+                std::memset(block.ctrl_, static_cast<uint8_t>(kEmpty), kSlots);
+                std::memset(block.ctrl_ + kSlots, static_cast<uint8_t>(kSentinel), kCtrlBytes - kSlots);
+            }
+        }
+
+        table->file_.advise_random();
+        return TableResult::Success(std::move(table));
+    }
+
+    Common::Result<bool> ChunkIndex::write_meta(bool clean) {
+        Meta meta{};
+        meta.magic_                = kMetaMagic;
+        meta.version_              = kMetaVersion;
+        meta.generation_           = current_->generation_;
+        meta.block_count_          = current_->block_count_;
+        meta.occupied_             = current_->occupied_;
+        meta.previous_generation_  = previous_ ? previous_->generation_ : 0;
+        meta.previous_block_count_ = previous_ ? previous_->block_count_ : 0;
+        meta.previous_occupied_    = previous_ ? previous_->occupied_ : 0;
+        meta.migrate_cursor_       = migrate_cursor_;
+        meta.items_                = items_;
+        meta.checkpoint_lsn_       = checkpoint_lsn_;
+        meta.clean_                = clean ? 1 : 0;
+        meta.checksum_             = fnv1a(&meta, offsetof(Meta, checksum_), 0xcbf29ce484222325ULL);
+
+        auto path      = options_.directory_ / "chunk-index.meta";
+        auto temp_path = options_.directory_ / "chunk-index.meta.tmp";
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&meta), sizeof(meta));
+            out.flush();
+            if (!out) {
+                return Common::Result<bool>::Error(Common::StatusCode::ERROR, "写入分片索引元数据失败：" + temp_path.string());
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "分片索引元数据改名失败：" + ec.message());
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> ChunkIndex::open() {
+        std::unique_lock lock(mutex_);
+        if (current_) {
+            return Common::Result<bool>::Success(true);
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(options_.directory_, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法创建分片索引目录：" + ec.message());
+        }
+
+        Meta meta{};
+        bool has_meta = false;
+        {
+            std::ifstream in(options_.directory_ / "chunk-index.meta", std::ios::binary);
+            if (in && in.read(reinterpret_cast<char*>(&meta), sizeof(meta))) {
+                has_meta = true;
+                if (meta.magic_ != kMetaMagic || meta.version_ != kMetaVersion ||
+                    meta.checksum_ != fnv1a(&meta, offsetof(Meta, checksum_), 0xcbf29ce484222325ULL) ||
+                    !std::has_single_bit(meta.block_count_)) {
+                    return Common::Result<bool>::Error(Common::StatusCode::ERROR, "分片索引元数据已损坏");
+                }
+            }
+        }
+
+        if (!has_meta) {
+            meta = Meta{};
+            meta.generation_  = 1;
+            meta.block_count_ = std::bit_ceil(std::max<uint64_t>(options_.initial_blocks_, 1));
+            meta.clean_       = 1;
+        }
+
+        auto current = open_table(meta.generation_, meta.block_count_, !has_meta);
+        if (current.failed()) {
+            return Common::Result<bool>::Error(current);
+        }
+        current_ = std::move(current.value());
+        current_->occupied_ = meta.occupied_;
+
+        if (meta.previous_generation_ != 0) {
+            auto previous = open_table(meta.previous_generation_, meta.previous_block_count_, false);
+            if (previous.failed()) {
+                current_.reset();
+                return Common::Result<bool>::Error(previous);
+            }
+            previous_ = std::move(previous.value());
+            previous_->occupied_ = meta.previous_occupied_;
+        }
+
+        migrate_cursor_ = meta.migrate_cursor_;
+        items_          = meta.items_;
+        checkpoint_lsn_ = meta.checkpoint_lsn_;
+        last_lsn_       = meta.checkpoint_lsn_;
+
+        auto redo_opened = redo_log_.open(options_.directory_ / "chunk-index.redo", options_.sync_redo_log_);
+        if (redo_opened.failed()) {
+            current_.reset();
+            previous_.reset();
+            return redo_opened;
+        }
+
+        auto replayed = redo_log_.replay(checkpoint_lsn_, [this](const RedoRecord& record) { apply(record); });
+        if (replayed.failed()) {
+            current_.reset();
+            previous_.reset();
+            return Common::Result<bool>::Error(replayed);
+        }
+        last_lsn_ = replayed.value();
+
+        if (!meta.clean_ || redo_log_.record_count() > 0) {
+            LOG_WARN_FMT("分片索引上次未正常关闭，已重放 {0} 条重做记录", redo_log_.record_count());
+            recount();
+            auto checkpointed = checkpoint_locked();
+            if (checkpointed.failed()) {
+                return checkpointed;
+            }
+        }
+
+        //标记为打开状态，异常退出后下次打开时会重新统计
+        return write_meta(false);
+    }
+
+    void ChunkIndex::close() {
+        std::unique_lock lock(mutex_);
+        if (!current_) {
+            return;
+        }
+
+        auto checkpointed = checkpoint_locked();
+        if (checkpointed.success()) {
+            write_meta(true);
+        }
+        else {
+            LOG_ERROR_FMT("分片索引关闭时检查点失败：{0}", checkpointed.message());
+        }
+
+        redo_log_.close();
+        previous_.reset();
+        current_.reset();
+    }
+
+    std::optional<ChunkLocation> ChunkIndex::find(const ChunkKey& key) const {
+        std::shared_lock lock(mutex_);
+        return find_locked(key);
+    }
+
+    std::optional<ChunkLocation> ChunkIndex::find_locked(const ChunkKey& key) const {
+        if (!current_) {
+            return std::nullopt;
+        }
+
+        uint64_t probes = 0;
+        const Slot* slot = current_->find(key, probes);
+        if (slot == nullptr && previous_) {
+            slot = previous_->find(key, probes);
+        }
+
+        //统计按采样累加，未采样的查询不写共享计数器
+        if (Common::sample_stat()) {
+            lookups_.fetch_add(Common::kStatSampleRate, std::memory_order_relaxed);
+            block_probes_.fetch_add(probes * Common::kStatSampleRate, std::memory_order_relaxed);
+        }
+
+        if (slot == nullptr) {
+            return std::nullopt;
+        }
+        return ChunkLocation{slot->chunk_id_, slot->node_id_, slot->size_};
+    }
+
+    Common::Result<bool> ChunkIndex::put(const ChunkKey& key, const ChunkLocation& location) {
+        std::unique_lock lock(mutex_);
+        if (!current_) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "分片索引未打开");
+        }
+
+        RedoRecord record{last_lsn_ + 1, RedoRecord::Op::PUT, key.bytes_, location.chunk_id_, location.node_id_, location.size_};
+        auto logged = redo_log_.append(record);
+        if (logged.failed()) {
+            return logged;
+        }
+        last_lsn_ = record.lsn_;
+
+        auto result = put_locked(key, location);
+        if (result.success() && redo_log_.record_count() >= options_.checkpoint_interval_) {
+            auto checkpointed = checkpoint_locked();
+            if (checkpointed.failed()) {
+                return checkpointed;
+            }
+        }
+        return result;
+    }
+
+    Common::Result<bool> ChunkIndex::erase(const ChunkKey& key) {
+        std::unique_lock lock(mutex_);
+        if (!current_) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "分片索引未打开");
+        }
+
+        RedoRecord record{last_lsn_ + 1, RedoRecord::Op::ERASE, key.bytes_, 0, 0, 0};
+        auto logged = redo_log_.append(record);
+        if (logged.failed()) {
+            return logged;
+        }
+        last_lsn_ = record.lsn_;
+
+        bool erased = erase_locked(key);
+        if (redo_log_.record_count() >= options_.checkpoint_interval_) {
+            auto checkpointed = checkpoint_locked();
+            if (checkpointed.failed()) {
+                return checkpointed;
+            }
+        }
+        return Common::Result<bool>::Success(erased);
+    }
+
+    Common::Result<bool> ChunkIndex::put_locked(const ChunkKey& key, const ChunkLocation& location) {
+        if (previous_) {
+            migrate_locked(options_.migrate_blocks_per_op_);
+        }
+
+        uint64_t probes = 0;
+        if (auto* slot = current_->find(key, probes)) {
+            slot->chunk_id_ = location.chunk_id_;
+            slot->node_id_  = location.node_id_;
+            slot->size_     = location.size_;
+            return Common::Result<bool>::Success(true);
+        }
+
+        //旧表中的副本随后被新表中的值遮蔽，迁移时不会覆盖新值
+        bool existed = previous_ && previous_->find(key, probes) != nullptr;
+
+        if (!previous_ && static_cast<double>(current_->occupied_ + 1) > current_->capacity() * options_.max_load_factor_) {
+            auto started = start_migration();
+            if (started.failed()) {
+                return started;
+            }
+        }
+
+        if (!current_->insert(key, location)) {
+            return Common::Result<bool>::Error(Common::StatusCode::STORAGE_FULL, "分片索引表已满");
+        }
+        if (!existed) {
+            ++items_;
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    bool ChunkIndex::erase_locked(const ChunkKey& key) {
+        bool erased = current_->erase(key);
+        if (previous_) {
+            erased = previous_->erase(key) || erased;
+        }
+        if (erased) {
+            --items_;
+        }
+        return erased;
+    }
+
+    void ChunkIndex::apply(const RedoRecord& record) {
+        ChunkKey key{record.key_};
+
+        //映射表中可能已有日志之后的部分写入，先删除全部副本再写入，保证重放结果只取决于日志
+        erase_locked(key);
+        if (record.op_ == RedoRecord::Op::PUT) {
+            auto result = put_locked(key, ChunkLocation{record.chunk_id_, record.node_id_, record.size_});
+            if (result.failed()) {
+                LOG_ERROR_FMT("重放分片索引重做记录失败：{0}", result.message());
+            }
+        }
+    }
+
+    Common::Result<bool> ChunkIndex::start_migration() {
+        //按当前键数的两倍容量取块数，墓碑较多时可能与原表同样大小（相当于清理墓碑）
+        auto wanted = std::max<uint64_t>(current_->block_count_, std::bit_ceil((items_ * 2) / kSlots + 1));
+        if (static_cast<double>(items_) > wanted * kSlots * options_.max_load_factor_ / 2) {
+            wanted *= 2;
+        }
+
+        auto table = open_table(current_->generation_ + 1, wanted, true);
+        if (table.failed()) {
+            return Common::Result<bool>::Error(table);
+        }
+
+        LOG_INFO_FMT("分片索引开始扩容：{0} 块 -> {1} 块，{2} 个键", current_->block_count_, wanted, items_);
+
+        previous_       = std::move(current_);
+        current_        = std::move(table.value());
+        migrate_cursor_ = 0;
+        return write_meta(false);
+    }
+
+    size_t ChunkIndex::migrate_step(size_t blocks) {
+        std::unique_lock lock(mutex_);
+        return previous_ ? migrate_locked(blocks) : 0;
+    }
+
+    bool ChunkIndex::is_migrating() const {
+        std::shared_lock lock(mutex_);
+        return previous_ != nullptr;
+    }
+
+    size_t ChunkIndex::migrate_locked(size_t blocks) {
+        size_t migrated = 0;
+
+        while (previous_ && migrated < blocks && migrate_cursor_ < previous_->block_count_) {
+            auto& block = previous_->block(migrate_cursor_);
+
+            for (size_t i = 0; i < kSlots; ++i) {
+                if (block.ctrl_[i] < 0) {
+                    continue;
+                }
+
+                ChunkKey key{};
+                std::memcpy(key.bytes_.data(), block.slots_[i].key_, 16);
+                uint64_t probes = 0;
+                if (current_->find(key, probes) == nullptr) {
+                    const auto& slot = block.slots_[i];
+                    current_->insert(key, ChunkLocation{slot.chunk_id_, slot.node_id_, slot.size_});
+                }
+            }
+
+            ++migrate_cursor_;
+            ++migrated;
+        }
+
+        if (previous_ && migrate_cursor_ >= previous_->block_count_) {
+            auto finished = finish_migration();
+            if (finished.failed()) {
+                LOG_ERROR_FMT("分片索引扩容收尾失败：{0}", finished.message());
+            }
+        }
+        return migrated;
+    }
+
+    Common::Result<bool> ChunkIndex::finish_migration() {
+        //迁移写入不在重做日志中，删除旧表前必须先把新表写回磁盘
+        auto flushed = current_->file_.flush();
+        if (flushed.failed()) {
+            return flushed;
+        }
+
+        auto old_path = previous_->file_.path();
+        previous_.reset();
+        migrate_cursor_ = 0;
+
+        auto written = write_meta(false);
+        if (written.failed()) {
+            return written;
+        }
+
+        std::error_code ec;
+        std::filesystem::remove(old_path, ec);
+        LOG_INFO_FMT("分片索引扩容完成：{0} 块，{1} 个键", current_->block_count_, items_);
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> ChunkIndex::checkpoint() {
+        std::unique_lock lock(mutex_);
+        if (!current_) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "分片索引未打开");
+        }
+        return checkpoint_locked();
+    }
+
+    Common::Result<bool> ChunkIndex::checkpoint_locked() {
+        auto flushed = current_->file_.flush();
+        if (flushed.success() && previous_) {
+            flushed = previous_->file_.flush();
+        }
+        if (flushed.failed()) {
+            return flushed;
+        }
+
+        checkpoint_lsn_ = last_lsn_;
+        auto written = write_meta(false);
+        if (written.failed()) {
+            return written;
+        }
+        return redo_log_.truncate();
+    }
+
+    void ChunkIndex::recount() {
+        auto count_table = [](Table& table) {
+            uint64_t occupied = 0;
+            for (uint64_t b = 0; b < table.block_count_; ++b) {
+                const auto& block = table.block(b);
+                for (size_t i = 0; i < kSlots; ++i) {
+                    occupied += block.ctrl_[i] != kEmpty ? 1 : 0;
+                }
+            }
+            table.occupied_ = occupied;
+        };
+
+        uint64_t items = 0;
+        for (uint64_t b = 0; b < current_->block_count_; ++b) {
+            const auto& block = current_->block(b);
+            for (size_t i = 0; i < kSlots; ++i) {
+                items += block.ctrl_[i] >= 0 ? 1 : 0;
+            }
+        }
+        count_table(*current_);
+
+        //旧表中只统计尚未迁移、且新表中没有的键
+        if (previous_) {
+            for (uint64_t b = migrate_cursor_; b < previous_->block_count_; ++b) {
+                const auto& block = previous_->block(b);
+                for (size_t i = 0; i < kSlots; ++i) {
+                    if (block.ctrl_[i] < 0) {
+                        continue;
+                    }
+                    ChunkKey key{};
+                    std::memcpy(key.bytes_.data(), block.slots_[i].key_, 16);
+                    uint64_t probes = 0;
+                    items += current_->find(key, probes) == nullptr ? 1 : 0;
+                }
+            }
+            count_table(*previous_);
+        }
+
+        items_ = items;
+    }
+
+    ChunkIndexStats ChunkIndex::stats() const {
+        std::shared_lock lock(mutex_);
+
+        ChunkIndexStats stats{};
+        if (current_) {
+            stats.items_          = items_;
+            stats.capacity_       = current_->capacity();
+            stats.occupied_       = current_->occupied_;
+            stats.blocks_         = current_->block_count_;
+            stats.migrating_      = previous_ != nullptr;
+            stats.migrate_cursor_ = migrate_cursor_;
+            stats.redo_records_   = redo_log_.record_count();
+        }
+        stats.lookups_      = lookups_.load(std::memory_order_relaxed);
+        stats.block_probes_ = block_probes_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+}
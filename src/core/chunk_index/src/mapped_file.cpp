@@ -0,0 +1,170 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/mapped_file.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace RefStorage::Core {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+#ifdef _WIN32
+
+    Common::Result<bool> MappedFile::open(const std::filesystem::path& path, size_t size) {
+        close();
+
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法打开映射文件：" + path.string());
+        }
+
+        LARGE_INTEGER current{};
+        GetFileSizeEx(file, &current);
+        auto mapped_size = std::max(size, static_cast<size_t>(current.QuadPart));
+        if (mapped_size == 0) {
+            CloseHandle(file);
+            return Common::Result<bool>::Error(Common::StatusCode::INVALID_ARGUMENT, "映射文件大小为0：" + path.string());
+        }
+
+        LARGE_INTEGER length{};
+        length.QuadPart = static_cast<LONGLONG>(mapped_size);
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(length.HighPart),
+                                            length.LowPart, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法创建文件映射：" + path.string());
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, mapped_size);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法映射文件：" + path.string());
+        }
+
+        path_           = path;
+        file_handle_    = file;
+        mapping_handle_ = mapping;
+        data_           = static_cast<uint8_t*>(view);
+        size_           = mapped_size;
+        return Common::Result<bool>::Success(true);
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_handle_ != nullptr) {
+            CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        }
+        if (file_handle_ != nullptr) {
+            CloseHandle(static_cast<HANDLE>(file_handle_));
+        }
+        data_           = nullptr;
+        size_           = 0;
+        mapping_handle_ = nullptr;
+        file_handle_    = nullptr;
+    }
+
+    Common::Result<bool> MappedFile::flush() {
+        if (data_ == nullptr) {
+            return Common::Result<bool>::Success(true);
+        }
+        if (!FlushViewOfFile(data_, size_) || !FlushFileBuffers(static_cast<HANDLE>(file_handle_))) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "映射文件写回失败：" + path_.string());
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    void MappedFile::advise_random() {
+        //Windows 在打开时已通过 FILE_FLAG_RANDOM_ACCESS 关闭预读
+    }
+
+#else
+
+    Common::Result<bool> MappedFile::open(const std::filesystem::path& path, size_t size) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR,
+                                               "无法打开映射文件：" + path.string() + "，" + std::strerror(errno));
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法读取映射文件大小：" + path.string());
+        }
+
+        auto mapped_size = std::max(size, static_cast<size_t>(info.st_size));
+        if (mapped_size == 0) {
+            ::close(fd);
+            return Common::Result<bool>::Error(Common::StatusCode::INVALID_ARGUMENT, "映射文件大小为0：" + path.string());
+        }
+        if (static_cast<size_t>(info.st_size) < mapped_size && ftruncate(fd, static_cast<off_t>(mapped_size)) != 0) {
+            ::close(fd);
+            return Common::Result<bool>::Error(Common::StatusCode::STORAGE_FULL, "无法扩展映射文件：" + path.string());
+        }
+
+        void* view = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            ::close(fd);
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR,
+                                               "无法映射文件：" + path.string() + "，" + std::strerror(errno));
+        }
+
+        path_ = path;
+        fd_   = fd;
+        data_ = static_cast<uint8_t*>(view);
+        size_ = mapped_size;
+        return Common::Result<bool>::Success(true);
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        fd_   = -1;
+    }
+
+    Common::Result<bool> MappedFile::flush() {
+        if (data_ == nullptr) {
+            return Common::Result<bool>::Success(true);
+        }
+        if (msync(data_, size_, MS_SYNC) != 0) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR,
+                                               "映射文件写回失败：" + path_.string() + "，" + std::strerror(errno));
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    void MappedFile::advise_random() {
+        if (data_ != nullptr) {
+            madvise(data_, size_, MADV_RANDOM);
+        }
+    }
+
+#endif
+
+}
@@ -0,0 +1,151 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/redo_log.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        //记录布局：lsn(8) op(1) key(16) chunk_id(8) node_id(4) size(4) 填充(7) 校验和(8)，共56字节
+        constexpr size_t kChecksumOffset = 48;
+
+        uint64_t checksum(const uint8_t* data, size_t size) {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ data[i]) * 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        bool sync_file(std::FILE* file) {
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+
+    }
+
+    RedoLog::~RedoLog() {
+        close();
+    }
+
+    Common::Result<bool> RedoLog::open(const std::filesystem::path& path, bool sync) {
+        close();
+
+        file_ = std::fopen(path.string().c_str(), "ab+");
+        if (file_ == nullptr) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法打开重做日志：" + path.string());
+        }
+
+        path_         = path;
+        sync_         = sync;
+        record_count_ = 0;
+        return Common::Result<bool>::Success(true);
+    }
+
+    void RedoLog::close() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    void RedoLog::encode(const RedoRecord& record, uint8_t* buffer) {
+        std::memset(buffer, 0, kRecordSize);
+        std::memcpy(buffer, &record.lsn_, 8);
+        buffer[8] = static_cast<uint8_t>(record.op_);
+        std::memcpy(buffer + 9, record.key_.data(), 16);
+        std::memcpy(buffer + 25, &record.chunk_id_, 8);
+        std::memcpy(buffer + 33, &record.node_id_, 4);
+        std::memcpy(buffer + 37, &record.size_, 4);
+
+        auto sum = checksum(buffer, kChecksumOffset);
+        std::memcpy(buffer + kChecksumOffset, &sum, 8);
+    }
+
+    bool RedoLog::decode(const uint8_t* buffer, RedoRecord& record) {
+        uint64_t sum = 0;
+        std::memcpy(&sum, buffer + kChecksumOffset, 8);
+        if (sum != checksum(buffer, kChecksumOffset)) {
+            return false;
+        }
+
+        std::memcpy(&record.lsn_, buffer, 8);
+        record.op_ = static_cast<RedoRecord::Op>(buffer[8]);
+        std::memcpy(record.key_.data(), buffer + 9, 16);
+        std::memcpy(&record.chunk_id_, buffer + 25, 8);
+        std::memcpy(&record.node_id_, buffer + 33, 4);
+        std::memcpy(&record.size_, buffer + 37, 4);
+        return record.op_ == RedoRecord::Op::PUT || record.op_ == RedoRecord::Op::ERASE;
+    }
+
+    Common::Result<bool> RedoLog::append(const RedoRecord& record) {
+        if (file_ == nullptr) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "重做日志未打开");
+        }
+
+        uint8_t buffer[kRecordSize];
+        encode(record, buffer);
+
+        if (std::fwrite(buffer, 1, kRecordSize, file_) != kRecordSize || std::fflush(file_) != 0) {
+            return Common::Result<bool>::Error(Common::StatusCode::STORAGE_FULL, "写入重做日志失败：" + path_.string());
+        }
+        if (sync_ && !sync_file(file_)) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "重做日志同步失败：" + path_.string());
+        }
+
+        ++record_count_;
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<uint64_t> RedoLog::replay(uint64_t after_lsn, const std::function<void(const RedoRecord&)>& apply) {
+        if (file_ == nullptr) {
+            return Common::Result<uint64_t>::Error(Common::StatusCode::ERROR, "重做日志未打开");
+        }
+
+        std::fseek(file_, 0, SEEK_SET);
+
+        uint64_t last_lsn = after_lsn;
+        uint64_t applied  = 0;
+        uint8_t buffer[kRecordSize];
+        RedoRecord record{};
+
+        //遇到第一条不完整或校验失败的记录即停止（崩溃时写了一半的尾部）
+        while (std::fread(buffer, 1, kRecordSize, file_) == kRecordSize && decode(buffer, record)) {
+            if (record.lsn_ <= last_lsn) {
+                continue;
+            }
+            apply(record);
+            last_lsn = record.lsn_;
+            ++applied;
+        }
+
+        std::fseek(file_, 0, SEEK_END);
+        record_count_ = applied;
+        return Common::Result<uint64_t>::Success(last_lsn);
+    }
+
+    Common::Result<bool> RedoLog::truncate() {
+        close();
+
+        file_ = std::fopen(path_.string().c_str(), "wb+");
+        if (file_ == nullptr || !sync_file(file_)) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法截断重做日志：" + path_.string());
+        }
+
+        record_count_ = 0;
+        return Common::Result<bool>::Success(true);
+    }
+
+}
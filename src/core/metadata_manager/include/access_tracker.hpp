@@ -0,0 +1,110 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.hpp"
+#include "concurrent_hash_map.hpp"
+
+
+namespace RefStorage::DataBase {
+    class ShardedMetadataStore;
+}
+
+namespace RefStorage::Core {
+
+    //访问跟踪配置
+    struct AccessTrackerOptions {
+        std::chrono::milliseconds flush_interval_ = std::chrono::seconds(30);    //后台批量写回的周期
+        std::chrono::milliseconds precision_      = std::chrono::hours(1);      //类似 relatime：新访问时间比已写入的晚超过该值才写回
+        std::chrono::milliseconds half_life_      = std::chrono::hours(24);     //访问频率衰减的半衰期
+        uint32_t                  sample_rate_    = 1;                          //每 N 次访问记录一次（计数按 N 放大），1 表示全部记录
+        std::chrono::milliseconds idle_retention_ = std::chrono::hours(24 * 7); //超过该时长未访问的文件移出内存统计（默认七个半衰期）
+    };
+
+    //单个文件的访问统计
+    struct AccessStats {
+        TimePoint last_access_;                                                 //最近一次访问（含未写回的）
+        TimePoint persisted_access_;                                            //已写入数据库的访问时间
+        uint64_t  total_accesses_;                                              //累计访问次数（抽样时为估计值）
+        double    frequency_;                                                   //截至 last_access_ 的衰减访问频率（次/小时），用于冷热分层
+    };
+
+    //文件访问时间跟踪：
+    //读路径只把访问记入当前线程的缓冲区（无共享写、无数据库事务），后台线程周期性地收集各线程缓冲区，
+    //合并后更新内存统计，并把超过精度阈值的访问时间按分库批量写入 files.last_accessed_at（每个分库一个变更）。
+    //内存占用有界：空闲超过 idle_retention_ 的统计在写回时移除，线程退出后其缓冲区在下一次收集后注销。
+    class AccessTracker {
+    public:
+        AccessTracker(DataBase::ShardedMetadataStore& store, AccessTrackerOptions options = {});
+        ~AccessTracker();
+
+        AccessTracker(const AccessTracker&) = delete;
+        AccessTracker& operator=(const AccessTracker&) = delete;
+
+        //启动/停止后台写回线程（停止时写回剩余访问）
+        void start();
+        void stop();
+
+        //记录一次文件访问（热路径，只写线程本地缓冲区）
+        void record_access(const HashValue& hash);
+
+        //立即收集并写回，返回写入数据库的文件数
+        Common::Result<size_t> flush();
+
+        //访问统计（只反映已收集的访问），未访问过时返回空
+        [[nodiscard]] std::shared_ptr<const AccessStats> stats(const HashValue& hash) const;
+        //当前访问频率（次/小时，按半衰期衰减到现在）
+        [[nodiscard]] double frequency(const HashValue& hash) const;
+
+        [[nodiscard]] size_t tracked_files() const { return stats_.size(); }
+
+    private:
+        //线程本地缓冲区中的一项
+        struct PendingAccess {
+            uint64_t  count_;
+            TimePoint last_access_;
+        };
+
+        //每个线程一个缓冲区，互斥锁只在收集时与后台线程竞争
+        struct ThreadBuffer {
+            std::mutex                                    mutex_;
+            std::unordered_map<HashValue, PendingAccess>  accesses_;
+            bool                                          retired_ = false;   //所属线程已退出，收集后注销
+        };
+
+        ThreadBuffer& local_buffer();
+        //线程退出时由线程本地槽位调用，标记缓冲区待注销
+        static void retire_buffer(void* buffer);
+        //移除空闲超过 idle_retention_ 的统计（调用方持有 flush_mutex_）
+        void evict_idle_stats();
+        void run();
+        //衰减到指定时间点的频率
+        [[nodiscard]] double decayed(double frequency, TimePoint from, TimePoint to) const;
+
+        DataBase::ShardedMetadataStore&                 store_;
+        AccessTrackerOptions                            options_;
+        const uint64_t                                  id_;                    //区分线程本地缓存属于哪个跟踪器
+        const std::shared_ptr<void>                     alive_;                 //线程本地槽位持有其弱引用，用于清理已销毁跟踪器的槽位
+
+        std::mutex                                      buffers_mutex_;
+        std::vector<std::shared_ptr<ThreadBuffer>>      buffers_;
+
+        ConcurrentHashMap<HashValue, AccessStats>       stats_;
+        std::mutex                                      flush_mutex_;           //串行化 flush（stats_ 只在 flush 中修改）
+        std::unordered_map<HashValue, PendingAccess>    deferred_;              //写回失败、待重试的访问（由 flush_mutex_ 保护）
+
+        std::mutex                                      run_mutex_;
+        std::condition_variable                         run_cv_;
+        bool                                            running_ = false;
+        std::thread                                     worker_thread_;
+    };
+
+}
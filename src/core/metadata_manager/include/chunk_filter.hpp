@@ -0,0 +1,145 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::DataBase {
+    class ShardedMetadataStore;
+}
+
+namespace RefStorage::Core {
+
+    //过滤器配置
+    struct ChunkFilterOptions {
+        size_t expected_items_ = size_t{1} << 20;                               //预计分片数，决定初始容量
+        double max_load_factor_ = 0.95;                                         //超过后标记需要扩容重建
+    };
+
+    //过滤器统计
+    struct ChunkFilterStats {
+        uint64_t capacity_;                                                     //槽位总数
+        uint64_t items_;                                                        //已插入的指纹数
+        uint64_t stashed_;                                                      //插入失败、暂存在溢出区的数量
+        uint64_t lookups_;                                                      //查询次数（采样估计，见 Common::sample_stat）
+        uint64_t negatives_;                                                    //判定为不存在的次数（采样估计）
+        uint64_t false_positives_;                                              //判定可能存在但实际不存在的次数（由调用方回报）
+        double   load_factor_;
+        double   estimated_fpr_;                                                //按负载估算的误判率
+        double   observed_fpr_;                                                 //实际观测的误判率
+
+        [[nodiscard]] double negative_ratio() const {
+            return lookups_ > 0 ? static_cast<double>(negatives_) / lookups_ : 0.0;
+        }
+    };
+
+    //分片哈希的布谷鸟过滤器，放在去重查询之前：
+    //判定“不存在”时一定不存在，可直接跳过索引查询；判定“可能存在”时再查缓存或数据库。
+    //每个桶4个16位指纹（一个64位原子字），理论误判率约 8*负载/65536。
+    //查询无锁：表指针由线程本地缓存按代数取得（只在重建或加载后重新读取共享指针），
+    //踢出迁移期间以版本号（seqlock）检测并重试，不会因元素搬移产生假阴性，查询统计按采样累加；
+    //插入与删除由一把互斥锁串行化。踢出次数用尽时元素进入溢出区（查询溢出区时加锁），不会丢失，
+    //同时标记需要扩容重建。
+    class ChunkFilter {
+    public:
+        explicit ChunkFilter(ChunkFilterOptions options = {});
+
+        ChunkFilter(const ChunkFilter&) = delete;
+        ChunkFilter& operator=(const ChunkFilter&) = delete;
+
+        //是否可能存在
+        [[nodiscard]] bool may_contain(const HashValue& hash) const;
+
+        //添加与删除（只能删除确实添加过的哈希，否则可能误删同指纹的其他元素）
+        void add(const HashValue& hash);
+        bool remove(const HashValue& hash);
+
+        //调用方确认一次误判（may_contain 为真但索引中不存在）
+        void record_false_positive() { false_positives_.fetch_add(1, std::memory_order_relaxed); }
+
+        [[nodiscard]] ChunkFilterStats stats() const;
+        [[nodiscard]] size_t size() const;
+        //负载过高或有元素进入溢出区，应当重建
+        [[nodiscard]] bool needs_rebuild() const;
+        [[nodiscard]] bool is_rebuilding() const { return rebuilding_.load(std::memory_order_acquire); }
+
+        //从分库存储重建（容量按当前分片数重新计算）；重建期间照常服务，期间的添加会补录到新表。
+        //期间的删除不补录（可能已不在扫描结果中），只会留下多余指纹，结果仍是实际集合的超集。
+        Common::Result<bool> rebuild(DataBase::ShardedMetadataStore& store);
+        std::future<Common::Result<bool>> rebuild_async(DataBase::ShardedMetadataStore& store);
+
+        //持久化：先写临时文件再改名（本机字节序）
+        Common::Result<bool> save(const std::filesystem::path& path) const;
+        //加载后删除文件：只有正常关闭时保存的过滤器与数据库一致，崩溃后找不到文件应从存储重建
+        static Common::Result<std::unique_ptr<ChunkFilter>> load(const std::filesystem::path& path,
+                                                                 ChunkFilterOptions options = {});
+
+        //哈希的64位摘要（跨平台稳定，持久化文件依赖它）
+        static uint64_t digest(std::string_view hash);
+
+    private:
+        static constexpr int kSlotsPerBucket = 4;
+        static constexpr int kMaxKicks       = 500;
+
+        //溢出区条目：无法安放的指纹及其所在桶（两个候选桶之一）
+        struct StashEntry {
+            size_t   index_;
+            uint16_t fingerprint_;
+        };
+
+        struct Table {
+            explicit Table(size_t bucket_count) : buckets_(bucket_count), mask_(bucket_count - 1) {}
+
+            std::vector<std::atomic<uint64_t>> buckets_;
+            size_t                             mask_;
+            std::atomic<uint64_t>              version_{0};                     //踢出迁移期间为奇数
+            std::atomic<uint64_t>              items_{0};
+            std::vector<StashEntry>            stash_;                          //由 write_mutex_ 保护
+            std::atomic<size_t>                stash_size_{0};                  //查询时只在非空时加锁检查溢出区
+        };
+
+        static size_t bucket_count_for(size_t items);
+        static uint16_t fingerprint(uint64_t digest);
+        static size_t alternate(const Table& table, size_t index, uint16_t fingerprint);
+
+        static bool bucket_contains(uint64_t bucket, uint16_t fingerprint);
+        static bool buckets_contain(const Table& table, size_t first, size_t second, uint16_t fingerprint);
+        static bool try_store(Table& table, size_t index, uint16_t fingerprint);
+        static bool try_erase(Table& table, size_t index, uint16_t fingerprint);
+        //插入摘要（需持有 write_mutex_），踢出次数用尽时被踢出的指纹进入溢出区
+        static void insert(Table& table, uint64_t digest);
+
+        bool stash_contains(const Table& table, size_t first, size_t second, uint16_t fingerprint) const;
+
+        //查询使用的当前表：线程本地缓存（过滤器编号 + 代数）命中时不访问共享指针。
+        //缓存持有旧表的引用，直到该线程下一次查询或退出时才释放
+        const Table& reader_table() const;
+        //替换当前表（需持有 write_mutex_，加载时除外）
+        void publish(std::shared_ptr<Table> table);
+
+        ChunkFilterOptions                  options_;
+        uint64_t                            id_;                                //进程内唯一编号，区分线程本地缓存属于哪个过滤器
+        std::atomic<std::shared_ptr<Table>> table_;
+        std::atomic<uint64_t>               generation_{1};                     //每次替换表时递增
+        mutable std::mutex                  write_mutex_;
+        std::mutex                          rebuild_mutex_;
+
+        //重建期间的添加，切换到新表前补录（由 write_mutex_ 保护）
+        std::atomic<bool>                   rebuilding_{false};
+        std::vector<uint64_t>               pending_adds_;
+
+        mutable std::atomic<uint64_t>       lookups_{0};
+        mutable std::atomic<uint64_t>       negatives_{0};
+        std::atomic<uint64_t>               false_positives_{0};
+    };
+
+}
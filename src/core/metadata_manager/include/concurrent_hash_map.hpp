@@ -0,0 +1,111 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+namespace RefStorage::Core {
+
+    //分段并发哈希表：
+    //键按散列值分到 ShardCount 个段，每段一把读写锁（段按缓存行对齐，避免伪共享）。
+    //值以 shared_ptr<const V> 保存且不可变，更新时整体替换指针：读者只在拷贝指针的瞬间持有共享锁，
+    //之后可以无锁使用快照，即使该项随后被替换或删除（类似RCU的读路径）。
+    template <typename K, typename V, typename Hash = std::hash<K>, std::size_t ShardCount = 64>
+    class ConcurrentHashMap {
+        static_assert((ShardCount & (ShardCount - 1)) == 0, "ShardCount 必须是2的幂");
+
+    public:
+        using ValuePtr = std::shared_ptr<const V>;
+
+        //查找，不存在时返回空指针
+        [[nodiscard]] ValuePtr find(const K& key) const {
+            const auto& shard = shard_for(key);
+            std::shared_lock lock(shard.mutex_);
+            auto it = shard.map_.find(key);
+            return it != shard.map_.end() ? it->second : nullptr;
+        }
+
+        [[nodiscard]] bool contains(const K& key) const {
+            const auto& shard = shard_for(key);
+            std::shared_lock lock(shard.mutex_);
+            return shard.map_.find(key) != shard.map_.end();
+        }
+
+        //插入或替换
+        void insert_or_assign(const K& key, ValuePtr value) {
+            auto& shard = shard_for(key);
+            std::unique_lock lock(shard.mutex_);
+            shard.map_.insert_or_assign(key, std::move(value));
+        }
+
+        //删除，返回是否存在
+        bool erase(const K& key) {
+            auto& shard = shard_for(key);
+            std::unique_lock lock(shard.mutex_);
+            return shard.map_.erase(key) > 0;
+        }
+
+        //逐段遍历（每段持有共享锁，不是全表一致的快照）
+        template <typename Function>
+        void for_each(Function&& function) const {
+            for (const auto& shard : shards_) {
+                std::shared_lock lock(shard.mutex_);
+                for (const auto& [key, value] : shard.map_) {
+                    function(key, value);
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            std::size_t total = 0;
+            for (const auto& shard : shards_) {
+                std::shared_lock lock(shard.mutex_);
+                total += shard.map_.size();
+            }
+            return total;
+        }
+
+        void clear() {
+            for (auto& shard : shards_) {
+                std::unique_lock lock(shard.mutex_);
+                shard.map_.clear();
+            }
+        }
+
+        //按预计总数为每段预留桶，避免预热时反复扩容
+        void reserve(std::size_t count) {
+            for (auto& shard : shards_) {
+                std::unique_lock lock(shard.mutex_);
+                shard.map_.reserve(count / ShardCount + 1);
+            }
+        }
+
+        //键所在的段号
+        [[nodiscard]] static std::size_t shard_index(const K& key) {
+            //散列值再混合一次取高位，段内 unordered_map 用的是低位，两者互不相关
+            auto mixed = static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<std::size_t>(mixed >> 40) & (ShardCount - 1);
+        }
+
+    private:
+        struct alignas(64) Shard {
+            mutable std::shared_mutex            mutex_;
+            std::unordered_map<K, ValuePtr, Hash> map_;
+        };
+
+        Shard& shard_for(const K& key) { return shards_[shard_index(key)]; }
+        const Shard& shard_for(const K& key) const { return shards_[shard_index(key)]; }
+
+        std::array<Shard, ShardCount> shards_;
+    };
+
+}
@@ -0,0 +1,104 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.hpp"
+#include "metadata_repository.hpp"
+
+
+namespace RefStorage::DataBase {
+    class ShardedMetadataStore;
+}
+
+namespace RefStorage::Core {
+
+    class MetadataManager;
+
+    //垃圾回收配置
+    struct GcOptions {
+        std::chrono::milliseconds grace_period_          = std::chrono::hours(1);     //引用数变为0后至少经过该时间才回收（容纳正在进行、会重新引用该分片的上传）
+        std::chrono::milliseconds idle_interval_         = std::chrono::seconds(30);  //一轮扫描完（没有候选）后等待的时间
+        size_t                    batch_size_            = 256;                       //每个分库每批处理的候选数
+        uint64_t                  max_chunks_per_second_ = 1000;                      //删除速率上限（0 表示不限）
+        uint64_t                  max_bytes_per_second_  = 0;                         //回收字节速率上限（0 表示不限）
+    };
+
+    //垃圾回收统计
+    struct GcMetrics {
+        uint64_t reclaimed_chunks_;
+        uint64_t reclaimed_bytes_;
+        uint64_t skipped_;                                                      //日志中有待写入增量、暂不回收的候选
+        uint64_t storage_failures_;                                             //元数据已删除但分片数据删除失败的次数
+        uint64_t batches_;
+        double   bytes_per_second_;                                             //最近回收速率（指数滑动平均，时间常数1分钟）
+    };
+
+    //增量垃圾回收器：
+    //从部分索引 idx_chunks_unreferenced 中按 (updated_at, hash) 顺序分批取出引用数为0、且超过宽限期的分片，
+    //每批在一个写事务中按条件删除元数据（被重新引用的分片保留）并推进 gc_progress 中的游标，
+    //随后从缓存中去掉并调用回调删除分片数据。批之间按速率上限等待，不做全表扫描，不阻塞前台写入。
+    //游标持久化在每个分库中，重启后从检查点继续；一轮扫描到末尾后游标回到起点，被跳过的候选在下一轮重新检查。
+    class GarbageCollector {
+    public:
+        //删除分片数据（元数据已删除后调用）
+        using ChunkReclaimer = std::function<Common::Result<bool>(const HashValue& hash, FileSize size)>;
+
+        GarbageCollector(DataBase::ShardedMetadataStore& store, MetadataManager& manager, GcOptions options = {});
+        ~GarbageCollector();
+
+        GarbageCollector(const GarbageCollector&) = delete;
+        GarbageCollector& operator=(const GarbageCollector&) = delete;
+
+        //设置分片数据删除回调（启动前设置）；未设置时只回收元数据
+        void set_chunk_reclaimer(ChunkReclaimer reclaimer) { reclaimer_ = std::move(reclaimer); }
+
+        //启动/停止后台回收线程
+        void start();
+        void stop();
+
+        //在每个分库上处理一批候选，返回本次回收的分片数
+        Common::Result<size_t> run_once();
+
+        [[nodiscard]] GcMetrics metrics() const;
+
+    private:
+        //单个分库处理一批，返回回收的分片数与字节数
+        Common::Result<std::pair<size_t, FileSize>> collect_shard(uint32_t shard);
+        //按速率上限计算下一批之前需要等待的时间
+        [[nodiscard]] std::chrono::milliseconds throttle(size_t chunks, FileSize bytes) const;
+        void update_rate(FileSize bytes);
+        void run();
+
+        DataBase::ShardedMetadataStore&     store_;
+        MetadataManager&                    manager_;
+        GcOptions                           options_;
+        ChunkReclaimer                      reclaimer_;
+
+        std::mutex                          collect_mutex_;                     //串行化 run_once（progress_ 由它保护）
+        std::vector<DataBase::GcProgress>   progress_;
+        bool                                progress_loaded_ = false;
+        std::atomic<bool>                   mid_pass_{false};                   //有分库的本轮扫描尚未到末尾
+
+        std::atomic<uint64_t>               reclaimed_chunks_{0};
+        std::atomic<uint64_t>               reclaimed_bytes_{0};
+        std::atomic<uint64_t>               skipped_{0};
+        std::atomic<uint64_t>               storage_failures_{0};
+        std::atomic<uint64_t>               batches_{0};
+        std::atomic<double>                 bytes_per_second_{0.0};
+        std::chrono::steady_clock::time_point rate_updated_;                    //由 collect_mutex_ 保护
+
+        std::mutex                          run_mutex_;
+        std::condition_variable             run_cv_;
+        bool                                running_ = false;
+        std::thread                         worker_thread_;
+    };
+
+}
@@ -2,3 +2,113 @@
 //Licensed under the Apache License, Version 2.0.
 
 #pragma once
+
+#include <array>
+#include <future>
+#include <mutex>
+#include "common/common_types.hpp"
+#include "chunk_filter.hpp"
+#include "concurrent_hash_map.hpp"
+#include "path_dictionary.hpp"
+#include "ref_count_log.hpp"
+#include "sharded_metadata_store.hpp"
+
+
+namespace RefStorage::Core {
+
+    //元数据管理器：文件与分片元数据的内存缓存，写穿透到分库存储。
+    //读操作只访问内存中的分段哈希表；写操作先经组提交写入数据库，持久化成功后再更新缓存，
+    //同一哈希上的写操作由条带锁串行化，保证缓存与数据库的更新顺序一致。
+    //缓存中的文件不保存 path 字符串，目录驻留在路径字典中，由 path_id_ 还原。
+    class MetadataManager {
+    public:
+        using FilePtr  = std::shared_ptr<const Common::FileMataData>;
+        using ChunkPtr = std::shared_ptr<const Common::ChunkInfo>;
+
+        //目录列举结果
+        struct DirectoryListing {
+            std::vector<std::string> directories_;                              //子目录名（有序）
+            std::vector<FilePtr>     files_;                                    //直接位于该目录下的文件
+        };
+
+        explicit MetadataManager(DataBase::ShardedMetadataStore& store);
+
+        MetadataManager(const MetadataManager&) = delete;
+        MetadataManager& operator=(const MetadataManager&) = delete;
+
+        //设置分片过滤器（启动时、开始服务前设置）；设置后分片查询先经过滤器，分片增删同步到过滤器
+        void set_chunk_filter(std::shared_ptr<ChunkFilter> filter) { chunk_filter_ = std::move(filter); }
+        [[nodiscard]] const std::shared_ptr<ChunkFilter>& chunk_filter() const { return chunk_filter_; }
+
+        //设置引用数增量日志（启动时设置）；设置后日志写入的增量同步到缓存中文件的 reference_count_
+        void set_ref_count_log(std::shared_ptr<RefCountLog> log);
+        [[nodiscard]] const std::shared_ptr<RefCountLog>& ref_count_log() const { return ref_count_log_; }
+
+        //启动时从所有分库批量加载分片与文件元数据（覆盖已有缓存）；过滤器为空时一并填充
+        Common::Result<bool> warm_up();
+
+        //按文件哈希查找，不存在时返回空指针
+        [[nodiscard]] FilePtr find_file(const HashValue& hash) const { return files_.find(hash); }
+        //按分片哈希查找，不存在时返回空指针
+        [[nodiscard]] ChunkPtr find_chunk(const HashValue& hash) const;
+        [[nodiscard]] bool contains_chunk(const HashValue& hash) const { return find_chunk(hash) != nullptr; }
+
+        //写入文件元数据（已存在则覆盖，引用数保持不变），成功后 file_id_ 为数据库分配的ID；
+        //path 为空时使用 path_id_ 对应的目录（如修改 find_file 读出的对象后写回）
+        Common::Result<bool> put_file(Common::FileMataData file);
+        Common::Result<bool> remove_file(const HashValue& hash);
+
+        //文件引用数：缓存中的基准值 + 日志中未写入的增量（写入进行中的瞬间可能短暂偏差，精确值用 RefCountLog::references）
+        [[nodiscard]] uint64_t file_references(const HashValue& hash) const;
+
+        //缓存中文件所在目录与完整路径（目录/文件名），分量以 '/' 连接、不含前导 '/'
+        [[nodiscard]] std::string file_directory(const Common::FileMataData& file) const { return paths_.path(file.path_id_); }
+        [[nodiscard]] std::string file_path(const Common::FileMataData& file) const;
+
+        //列举目录（路径字典中的一层子节点），目录不存在时结果为空
+        [[nodiscard]] DirectoryListing list_directory(std::string_view directory) const;
+        //删除目录下（含子目录）的全部文件，返回删除的文件数。
+        //所有删除先一并提交给写线程（按分库组提交），再统一等待结果；有失败时返回第一个错误，已成功的删除仍会移出缓存
+        Common::Result<size_t> remove_subtree(std::string_view directory);
+
+        //写入分片信息（已存在则覆盖）
+        Common::Result<bool> put_chunk(Common::ChunkInfo chunk);
+        Common::Result<bool> remove_chunk(const HashValue& hash);
+        //分片已在数据库中删除（如垃圾回收）后，从缓存与过滤器中去掉；调用方须已通过 lock_writes 持有该哈希的写锁
+        void evict_chunk(const HashValue& hash);
+
+        //按条带序号升序获取一组哈希的写锁（与 put/remove 互斥且不会死锁），
+        //供批量操作（如垃圾回收）在锁内完成检查、删除与缓存更新，期间不得再调用本类会加写锁的方法
+        [[nodiscard]] std::vector<std::unique_lock<std::mutex>> lock_writes(const std::vector<HashValue>& hashes);
+
+        [[nodiscard]] size_t file_count() const { return files_.size(); }
+        [[nodiscard]] size_t chunk_count() const { return chunks_.size(); }
+        [[nodiscard]] const PathDictionary& path_dictionary() const { return paths_; }
+
+    private:
+        static constexpr size_t kWriteStripes = 64;
+
+        static size_t write_stripe_of(const HashValue& hash);
+        std::mutex& write_lock_for(const HashValue& hash);
+        //驻留文件所在目录、去掉路径字符串后放入缓存，并更新目录 -> 文件索引
+        void cache_file(std::shared_ptr<Common::FileMataData> file);
+        void uncache_file(const HashValue& hash);
+        //从目录 -> 文件索引中去掉一个哈希（调用方持有 path_files_mutex_）
+        void unindex_path_locked(PathID path, const HashValue& hash);
+        //过滤器负载过高或出现溢出时在后台从存储重建
+        void maybe_rebuild_filter();
+
+        DataBase::ShardedMetadataStore&                       store_;
+        ConcurrentHashMap<HashValue, Common::FileMataData>    files_;
+        ConcurrentHashMap<HashValue, Common::ChunkInfo>       chunks_;
+        PathDictionary                                        paths_;
+        ConcurrentHashMap<PathID, std::vector<HashValue>>     path_files_;     //目录 -> 直接位于其下的文件哈希
+        std::mutex                                            path_files_mutex_; //串行化 path_files_ 的读-改-写
+        std::array<std::mutex, kWriteStripes>                 write_locks_;
+        std::shared_ptr<ChunkFilter>                          chunk_filter_;
+        std::shared_ptr<RefCountLog>                          ref_count_log_;
+        std::mutex                                            filter_rebuild_mutex_;
+        std::future<Common::Result<bool>>                     filter_rebuild_;
+    };
+
+}
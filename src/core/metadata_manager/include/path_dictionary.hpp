@@ -0,0 +1,88 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::Core {
+
+    //路径字典：目录按分量组成的前缀树（驻留表）。
+    //每个分量只在其父节点下保存一次，文件只需保存所在目录的 PathID，千万级文件共享的深层目录不再重复存储；
+    //列目录是读取一个节点的子节点，删除子树是一次先序遍历，不需要 LIKE 'prefix%' 扫描。
+    //读操作（查找、还原、遍历）持有共享锁并发执行，只有新分量插入时持有独占锁。
+    //节点只增不删，PathID 在字典生命周期内稳定。
+    class PathDictionary {
+    public:
+        static constexpr PathID kRoot = 0;                                      //根（空路径）
+
+        PathDictionary();
+
+        PathDictionary(const PathDictionary&) = delete;
+        PathDictionary& operator=(const PathDictionary&) = delete;
+
+        //驻留路径（不存在的分量依次创建），返回叶节点。分隔符为 '/' 或 '\\'，忽略空分量与 "."
+        PathID intern(std::string_view path);
+        //在 parent 下驻留一个分量
+        PathID intern_child(PathID parent, std::string_view name);
+
+        //查找已驻留的路径，不存在时返回空
+        [[nodiscard]] std::optional<PathID> find(std::string_view path) const;
+
+        //还原完整路径（分量以 '/' 连接，不含前导 '/'）
+        [[nodiscard]] std::string path(PathID id) const;
+        [[nodiscard]] std::string name(PathID id) const;
+        [[nodiscard]] PathID parent(PathID id) const;
+
+        //直接子节点（按名称排序）
+        [[nodiscard]] std::vector<PathID> children(PathID id) const;
+        //先序遍历 id 及其全部后代；遍历期间持有共享锁，回调中不得驻留新路径
+        void for_each_descendant(PathID id, const std::function<void(PathID)>& visit) const;
+
+        [[nodiscard]] size_t size() const;
+        //分量名与节点结构占用的内存字节数（估算）
+        [[nodiscard]] size_t memory_usage() const;
+
+        //把路径拆分为分量
+        static std::vector<std::string_view> split(std::string_view path);
+
+    private:
+        struct Node {
+            PathID              parent_;
+            std::string         name_;
+            std::vector<PathID> children_;
+        };
+
+        //子节点索引键：父节点 + 分量名（名称指向节点自身保存的字符串）
+        struct ChildKey {
+            PathID           parent_;
+            std::string_view name_;
+
+            bool operator==(const ChildKey&) const = default;
+        };
+
+        struct ChildKeyHash {
+            size_t operator()(const ChildKey& key) const {
+                return std::hash<std::string_view>{}(key.name_) ^ (static_cast<size_t>(key.parent_) * 0x9E3779B97F4A7C15ULL);
+            }
+        };
+
+        std::optional<PathID> find_child_locked(PathID parent, std::string_view name) const;
+        PathID insert_child_locked(PathID parent, std::string_view name);
+
+        mutable std::shared_mutex                              mutex_;
+        std::deque<Node>                                       nodes_;          //下标即 PathID，deque 保证名称地址稳定
+        std::unordered_map<ChildKey, PathID, ChildKeyHash>     index_;
+        size_t                                                 name_bytes_ = 0;
+    };
+
+}
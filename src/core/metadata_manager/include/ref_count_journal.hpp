@@ -0,0 +1,71 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <vector>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::Core {
+
+    //引用数增量日志的一条记录
+    struct RefCountRecord {
+        uint8_t   target_;                                                      //RefTarget 的取值
+        int64_t   delta_;
+        HashValue hash_;
+    };
+
+    //引用数增量的追加写日志：目录下每个代数一个文件 refcount-<代数>.journal。
+    //记录先编码到调用方的缓冲区，多条记录攒成一批后由 write 一次写入当前代数的文件（组提交）；
+    //合并写入数据库前轮换到下一个代数，各分库都写入了某代数之后，该代数及更早的文件即可删除。
+    //崩溃时写了一半的尾部记录在重放时被丢弃。不是线程安全的，由 RefCountLog 串行化调用。
+    class RefCountJournal {
+    public:
+        RefCountJournal() = default;
+        ~RefCountJournal();
+
+        RefCountJournal(const RefCountJournal&) = delete;
+        RefCountJournal& operator=(const RefCountJournal&) = delete;
+
+        //打开目录并列出已有的日志文件（不创建当前文件，由 start_epoch 创建）；
+        //sync 为 true 时每条记录都 fsync（掉电也不丢），否则只写入系统缓存（进程崩溃不丢）
+        Common::Result<bool> open(const std::filesystem::path& directory, bool sync);
+        void close();
+
+        //已有日志文件的代数（升序），open 之后有效
+        [[nodiscard]] const std::vector<uint64_t>& existing_epochs() const { return existing_; }
+
+        //按顺序重放某代数文件中的有效记录
+        Common::Result<bool> replay(uint64_t epoch, const std::function<void(const RefCountRecord&)>& apply) const;
+
+        //以 epoch 为当前代数，此后的记录追加到该代数的文件
+        Common::Result<bool> start_epoch(uint64_t epoch);
+        [[nodiscard]] uint64_t current_epoch() const { return epoch_; }
+
+        //把一条记录编码追加到 out（不写文件）
+        static Common::Result<bool> encode(const RefCountRecord& record, std::vector<uint8_t>& out);
+
+        //把已编码的一批记录写入当前文件（一次 write，sync 时再一次 fsync）；
+        //失败时把文件截回写入前的长度，批中的记录都视为未写入
+        Common::Result<bool> write(const std::vector<uint8_t>& records);
+
+        //删除代数不大于 epoch 的文件（不含当前文件）
+        void remove_through(uint64_t epoch);
+
+    private:
+        [[nodiscard]] std::filesystem::path path_of(uint64_t epoch) const;
+
+        std::filesystem::path  directory_;
+        bool                   sync_  = false;
+        std::FILE*             file_  = nullptr;
+        uint64_t               epoch_ = 0;
+        uint64_t               size_  = 0;                                     //当前文件已写入的长度
+        std::vector<uint64_t>  existing_;                                      //当前文件之外、尚未删除的文件
+    };
+
+}
@@ -0,0 +1,167 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.hpp"
+#include "ref_count_journal.hpp"
+
+
+namespace RefStorage::DataBase {
+    class ShardedMetadataStore;
+}
+
+namespace RefStorage::Core {
+
+    //引用数所在的表
+    enum class RefTarget : uint8_t {
+        File,                                                                   //files.reference_count
+        Chunk                                                                   //chunks.reference_count（同时推进 updated_at）
+    };
+
+    //引用数增量日志配置
+    struct RefCountLogOptions {
+        std::chrono::milliseconds apply_interval_ = std::chrono::seconds(5);    //后台合并写入的周期
+        size_t                    max_pending_    = 100000;                     //待写入的哈希数超过该值时提前写入
+        std::filesystem::path     journal_directory_;                           //增量日志目录，为空时增量只在内存中
+        bool                      sync_journal_   = false;                      //每批增量都 fsync（掉电不丢），否则进程崩溃不丢
+    };
+
+    //引用数增量日志：
+    //重复上传与删除只把 +1/-1 追加到内存中按哈希合并的增量表（条带锁，不开数据库事务），
+    //后台线程周期性地（或在 checkpoint 时）把净增量按分库批量写入，每个哈希每个周期最多一次 UPDATE，
+    //热门内容的行不再成为写入热点，批量去重时的元数据写放大从“每次引用一次”降为“每周期一次”。
+    //读取引用数时返回 数据库中的基准值 + 未写入的增量。
+    //配置了日志目录时，每个增量在 add 返回前先追加到 RefCountJournal，open 时重放数据库尚未包含的部分，
+    //进程崩溃不会丢失已确认的增量（垃圾回收依赖的引用数不会因此偏小）。日志按组提交：并发的 add 把记录放进同一批，
+    //先拿到日志锁的线程一次写入（及 fsync）整批并把其中的增量并入条带，其余线程随之返回；未配置时增量只在内存中，
+    //进程异常退出时未写入的部分会丢失，正常退出（stop）会写完。
+    class RefCountLog {
+    public:
+        //增量写入数据库后的回调（用于同步缓存中的基准值），在写入线程外、不持有内部锁时调用
+        using ApplyListener = std::function<void(RefTarget target, const HashValue& hash, int64_t delta)>;
+
+        RefCountLog(DataBase::ShardedMetadataStore& store, RefCountLogOptions options = {});
+        ~RefCountLog();
+
+        RefCountLog(const RefCountLog&) = delete;
+        RefCountLog& operator=(const RefCountLog&) = delete;
+
+        //打开增量日志并重放上次未写入数据库的增量（未配置日志目录时无操作），须在 start 与 add 之前、分库打开之后调用
+        Common::Result<bool> open();
+
+        //启动/停止后台写入线程（停止时写入剩余增量）
+        void start();
+        void stop();
+
+        //追加一次引用数变化（热路径，在内存中合并；配置了日志时先追加到日志），返回成功即已持久
+        Common::Result<bool> add(RefTarget target, const HashValue& hash, int64_t delta);
+        Common::Result<bool> increment(RefTarget target, const HashValue& hash) { return add(target, hash, 1); }
+        Common::Result<bool> decrement(RefTarget target, const HashValue& hash) { return add(target, hash, -1); }
+
+        //尚未写入数据库的净增量（含正在写入的）
+        [[nodiscard]] int64_t pending(RefTarget target, const HashValue& hash) const;
+        //当前引用数：数据库基准值 + 未写入的增量（不小于0）；记录不存在时基准值为0
+        Common::Result<uint64_t> references(RefTarget target, const HashValue& hash) const;
+
+        //把当前全部增量写入数据库，返回写入的行数；失败分库的增量保留到下次
+        Common::Result<size_t> checkpoint();
+
+        void set_apply_listener(ApplyListener listener) { listener_ = std::move(listener); }
+
+        //待写入的哈希数
+        [[nodiscard]] size_t pending_count() const { return pending_count_.load(std::memory_order_relaxed); }
+        //累计追加的变化次数与写入数据库的行数（用于观察合并效果）
+        [[nodiscard]] uint64_t appended() const { return appended_.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t applied_rows() const { return applied_rows_.load(std::memory_order_relaxed); }
+        //日志写入的批数（组提交后不多于 appended）
+        [[nodiscard]] uint64_t journal_writes() const { return journal_writes_.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t kStripes = 64;
+
+        struct Key {
+            RefTarget target_;
+            HashValue hash_;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const {
+                return std::hash<HashValue>{}(key.hash_) ^ static_cast<size_t>(key.target_);
+            }
+        };
+
+        using DeltaMap = std::unordered_map<Key, int64_t, KeyHash>;
+
+        //条带：增量表与正在写入的增量；读取遇到正在写入的哈希时等待写入完成，避免基准值与增量重复计算
+        struct Stripe {
+            mutable std::mutex              mutex_;
+            mutable std::condition_variable applied_cv_;
+            DeltaMap                        pending_;
+            DeltaMap                        in_flight_;
+            uint64_t                        generation_ = 0;                    //增量表每被换出写入一次加一
+        };
+
+        //一次写入中的一项
+        struct Applied {
+            Key     key_;
+            int64_t delta_;
+        };
+
+        //等待写入日志的一批记录：追加方在 batch_mutex_ 下加入当前批，写入方在 journal_mutex_ 下整批写入
+        struct JournalBatch {
+            std::vector<uint8_t>  data_;                                        //已编码的记录
+            std::vector<Applied>  entries_;
+            bool                  done_ = false;                                //以下由 journal_mutex_ 保护
+            Common::Result<bool>  result_;
+        };
+
+        Stripe& stripe_for(const HashValue& hash) const;
+        //把增量并入条带（调用方持有条带锁）；新增了待写入的哈希时返回新增后的待写入哈希数，否则返回0
+        size_t merge_locked(Stripe& stripe, const Key& key, int64_t delta);
+        //写入结束后的收尾：成功则移出正在写入的增量，失败则并回增量表
+        void settle(const std::vector<Applied>& entries, bool applied);
+        //把当前批写入日志并把其中的增量并入条带（调用方持有 journal_mutex_）
+        void flush_journal_locked();
+        void request_apply();
+        void run();
+
+        DataBase::ShardedMetadataStore&     store_;
+        RefCountLogOptions                  options_;
+        mutable std::array<Stripe, kStripes> stripes_;
+        ApplyListener                       listener_;
+
+        std::atomic<size_t>                 pending_count_{0};
+        std::atomic<uint64_t>               appended_{0};
+        std::atomic<uint64_t>               applied_rows_{0};
+        std::atomic<uint64_t>               journal_writes_{0};
+        std::mutex                          checkpoint_mutex_;                  //串行化 checkpoint
+
+        bool                                journaled_ = false;
+        std::mutex                          journal_mutex_;                     //串行化日志写入、并入条带与换出增量时的日志轮换
+        RefCountJournal                     journal_;
+        std::mutex                          batch_mutex_;                       //保护 open_batch_（只在加入与换出时短暂持有）
+        std::shared_ptr<JournalBatch>       open_batch_ = std::make_shared<JournalBatch>();
+        std::vector<uint64_t>               durable_epochs_;                    //各分库已包含的最大日志代数（由 checkpoint_mutex_ 保护）
+
+        std::mutex                          run_mutex_;
+        std::condition_variable             run_cv_;
+        bool                                running_ = false;
+        bool                                apply_requested_ = false;           //待写入数超过阈值
+        std::thread                         worker_thread_;
+    };
+
+}
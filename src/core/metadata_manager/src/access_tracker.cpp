@@ -0,0 +1,285 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/access_tracker.hpp"
+#include <atomic>
+#include <cmath>
+#include <future>
+#include "metadata_repository.hpp"
+#include "sharded_metadata_store.hpp"
+#include "Log.hpp"
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        std::atomic<uint64_t> next_tracker_id{1};
+
+        //线程本地：当前线程在各跟踪器中的缓冲区（通常只有一个跟踪器）
+        struct LocalSlot {
+            uint64_t              tracker_id_;
+            std::weak_ptr<void>   tracker_alive_;
+            std::shared_ptr<void> buffer_;
+            void                (*retire_)(void* buffer);
+        };
+
+        //线程退出时把各缓冲区标记为待注销，已收集的内容不受影响
+        struct LocalSlots {
+            std::vector<LocalSlot> slots_;
+
+            ~LocalSlots() {
+                for (const auto& slot : slots_) {
+                    slot.retire_(slot.buffer_.get());
+                }
+            }
+        };
+
+        thread_local LocalSlots local_slots;
+        thread_local uint64_t               local_sample_counter = 0;
+
+        double hours(std::chrono::milliseconds duration) {
+            return std::chrono::duration<double, std::ratio<3600>>(duration).count();
+        }
+
+    }
+
+    AccessTracker::AccessTracker(DataBase::ShardedMetadataStore& store, AccessTrackerOptions options)
+        : store_(store)
+        , options_(options)
+        , id_(next_tracker_id.fetch_add(1, std::memory_order_relaxed))
+        , alive_(std::make_shared<char>()) {
+        if (options_.sample_rate_ == 0) {
+            options_.sample_rate_ = 1;
+        }
+    }
+
+    AccessTracker::~AccessTracker() {
+        stop();
+    }
+
+    void AccessTracker::start() {
+        std::lock_guard lock(run_mutex_);
+        if (running_) {
+            return;
+        }
+        running_       = true;
+        worker_thread_ = std::thread(&AccessTracker::run, this);
+    }
+
+    void AccessTracker::stop() {
+        {
+            std::lock_guard lock(run_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        run_cv_.notify_all();
+        worker_thread_.join();
+
+        auto flushed = flush();
+        if (flushed.failed()) {
+            LOG_WARN_FMT("停止时写回访问时间失败：{0}", flushed.message());
+        }
+    }
+
+    void AccessTracker::record_access(const HashValue& hash) {
+        if (options_.sample_rate_ > 1 && ++local_sample_counter % options_.sample_rate_ != 0) {
+            return;
+        }
+
+        auto& buffer = local_buffer();
+        auto  now    = std::chrono::system_clock::now();
+
+        std::lock_guard lock(buffer.mutex_);
+        auto& pending = buffer.accesses_[hash];
+        pending.count_      += options_.sample_rate_;
+        pending.last_access_ = now;
+    }
+
+    AccessTracker::ThreadBuffer& AccessTracker::local_buffer() {
+        for (const auto& slot : local_slots.slots_) {
+            if (slot.tracker_id_ == id_) {
+                return *static_cast<ThreadBuffer*>(slot.buffer_.get());
+            }
+        }
+
+        //当前线程第一次访问该跟踪器：顺带清理已销毁跟踪器的槽位，再注册缓冲区
+        //（线程退出后缓冲区仍由跟踪器持有，内容照常收集，收集后注销）
+        std::erase_if(local_slots.slots_, [](const LocalSlot& slot) { return slot.tracker_alive_.expired(); });
+
+        auto buffer = std::make_shared<ThreadBuffer>();
+        {
+            std::lock_guard lock(buffers_mutex_);
+            buffers_.push_back(buffer);
+        }
+        local_slots.slots_.push_back(LocalSlot{id_, alive_, buffer, &AccessTracker::retire_buffer});
+        return *buffer;
+    }
+
+    void AccessTracker::retire_buffer(void* buffer) {
+        auto* thread_buffer = static_cast<ThreadBuffer*>(buffer);
+        std::lock_guard lock(thread_buffer->mutex_);
+        thread_buffer->retired_ = true;
+    }
+
+    void AccessTracker::evict_idle_stats() {
+        auto cutoff = std::chrono::system_clock::now() - options_.idle_retention_;
+
+        //遍历时持有分段的共享锁，先收集再删除；待重试写回的文件保留
+        std::vector<HashValue> idle;
+        stats_.for_each([&](const HashValue& hash, const std::shared_ptr<const AccessStats>& stats) {
+            if (stats->last_access_ < cutoff && !deferred_.contains(hash)) {
+                idle.push_back(hash);
+            }
+        });
+        for (const auto& hash : idle) {
+            stats_.erase(hash);
+        }
+    }
+
+    Common::Result<size_t> AccessTracker::flush() {
+        std::lock_guard flush_lock(flush_mutex_);
+
+        evict_idle_stats();
+
+        //收集各线程缓冲区：整体换出，线程只在换出的瞬间等待
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        {
+            std::lock_guard lock(buffers_mutex_);
+            buffers = buffers_;
+        }
+
+        //上次写回失败的访问先并入，保证最终写回
+        std::unordered_map<HashValue, PendingAccess> merged;
+        merged.swap(deferred_);
+        bool retired = false;
+        for (const auto& buffer : buffers) {
+            std::unordered_map<HashValue, PendingAccess> accesses;
+            {
+                std::lock_guard lock(buffer->mutex_);
+                accesses.swap(buffer->accesses_);
+                retired = retired || buffer->retired_;
+            }
+            for (auto& [hash, pending] : accesses) {
+                auto& target = merged[hash];
+                target.count_      += pending.count_;
+                target.last_access_ = std::max(target.last_access_, pending.last_access_);
+            }
+        }
+        //所属线程已退出的缓冲区内容已全部取出，注销
+        if (retired) {
+            std::lock_guard lock(buffers_mutex_);
+            std::erase_if(buffers_, [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                std::lock_guard buffer_lock(buffer->mutex_);
+                return buffer->retired_ && buffer->accesses_.empty();
+            });
+        }
+        if (merged.empty()) {
+            return Common::Result<size_t>::Success(0);
+        }
+
+        //更新统计，挑出超过精度阈值、需要写回的访问时间
+        auto per_access = std::log(2.0) / hours(options_.half_life_);
+        std::unordered_map<HashValue, AccessStats> updated;
+        std::vector<std::vector<std::pair<HashValue, TimePoint>>> writes(store_.shard_count());
+        updated.reserve(merged.size());
+        for (auto& [hash, pending] : merged) {
+            AccessStats stats{};
+            if (auto previous = stats_.find(hash)) {
+                stats = *previous;
+                stats.frequency_ = decayed(stats.frequency_, stats.last_access_, pending.last_access_);
+            }
+            stats.last_access_     = std::max(stats.last_access_, pending.last_access_);
+            stats.total_accesses_ += pending.count_;
+            stats.frequency_      += pending.count_ * per_access;
+
+            if (stats.last_access_ - stats.persisted_access_ >= options_.precision_) {
+                writes[store_.shard_of(hash)].emplace_back(hash, stats.last_access_);
+            }
+            updated.emplace(hash, stats);
+        }
+
+        std::vector<std::pair<uint32_t, std::future<Common::Result<bool>>>> futures;
+        for (uint32_t shard = 0; shard < writes.size(); ++shard) {
+            if (writes[shard].empty()) {
+                continue;
+            }
+            futures.emplace_back(shard, store_.submit_to(shard, [touches = &writes[shard]](DataBase::DatabaseConnector& connector) {
+                for (const auto& [hash, access_time] : *touches) {
+                    auto result = DataBase::MetadataRepository::touch_file(connector, hash, access_time);
+                    if (result.failed()) {
+                        return result;
+                    }
+                }
+                return Common::Result<bool>::Success(true);
+            }));
+        }
+
+        //写回成功的分库才推进已写入时间，失败的留到下次重试（计数已计入统计，重试项计数为0）
+        auto   result  = Common::Result<size_t>::Success(0);
+        size_t written = 0;
+        for (auto& [shard, future] : futures) {
+            auto shard_result = future.get();
+            if (shard_result.failed()) {
+                if (result.success()) {
+                    result = Common::Result<size_t>::Error(shard_result);
+                }
+                for (const auto& [hash, access_time] : writes[shard]) {
+                    deferred_.emplace(hash, PendingAccess{0, access_time});
+                }
+                continue;
+            }
+            for (const auto& [hash, access_time] : writes[shard]) {
+                updated[hash].persisted_access_ = access_time;
+            }
+            written += writes[shard].size();
+        }
+
+        for (auto& [hash, stats] : updated) {
+            stats_.insert_or_assign(hash, std::make_shared<const AccessStats>(stats));
+        }
+
+        if (result.failed()) {
+            return result;
+        }
+        LOG_DEBUG_FMT("访问时间写回完成：{0} 个文件有访问，写入 {1} 个", merged.size(), written);
+        return Common::Result<size_t>::Success(written);
+    }
+
+    std::shared_ptr<const AccessStats> AccessTracker::stats(const HashValue& hash) const {
+        return stats_.find(hash);
+    }
+
+    double AccessTracker::frequency(const HashValue& hash) const {
+        auto stats = stats_.find(hash);
+        return stats ? decayed(stats->frequency_, stats->last_access_, std::chrono::system_clock::now()) : 0.0;
+    }
+
+    double AccessTracker::decayed(double frequency, TimePoint from, TimePoint to) const {
+        if (to <= from) {
+            return frequency;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(to - from);
+        return frequency * std::exp2(-hours(elapsed) / hours(options_.half_life_));
+    }
+
+    void AccessTracker::run() {
+        std::unique_lock lock(run_mutex_);
+        while (running_) {
+            run_cv_.wait_for(lock, options_.flush_interval_, [this] { return !running_; });
+            if (!running_) {
+                break;
+            }
+
+            lock.unlock();
+            auto flushed = flush();
+            if (flushed.failed()) {
+                LOG_WARN_FMT("写回访问时间失败，下个周期重试：{0}", flushed.message());
+            }
+            lock.lock();
+        }
+    }
+
+}
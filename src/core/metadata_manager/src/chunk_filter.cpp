@@ -0,0 +1,458 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/chunk_filter.hpp"
+#include "sharded_metadata_store.hpp"
+#include <sqlite3.h>
+#include <bit>
+#include <fstream>
+#include <thread>
+#include "common/stat_sampler.hpp"
+#include "Log.hpp"
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        constexpr uint32_t kFileMagic   = 0x46435352;                           //"RSCF"
+        constexpr uint32_t kFileVersion = 1;
+
+        constexpr uint64_t kSlotMask = 0xFFFF;
+
+        uint16_t slot(uint64_t bucket, int i) {
+            return static_cast<uint16_t>((bucket >> (16 * i)) & kSlotMask);
+        }
+
+        uint64_t with_slot(uint64_t bucket, int i, uint16_t fingerprint) {
+            return (bucket & ~(kSlotMask << (16 * i))) | (static_cast<uint64_t>(fingerprint) << (16 * i));
+        }
+
+        template <typename T>
+        void write_pod(std::ofstream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool read_pod(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        std::atomic<uint64_t> next_filter_id{1};
+
+    }
+
+    ChunkFilter::ChunkFilter(ChunkFilterOptions options)
+        : options_(options),
+          id_(next_filter_id.fetch_add(1, std::memory_order_relaxed)),
+          table_(std::make_shared<Table>(bucket_count_for(options.expected_items_))) {}
+
+    const ChunkFilter::Table& ChunkFilter::reader_table() const {
+        struct Cache {
+            uint64_t                     filter_id_  = 0;
+            uint64_t                     generation_ = 0;
+            std::shared_ptr<const Table> table_;
+        };
+        thread_local Cache cache;
+
+        //先读代数再读指针：读到新代数时一定能读到新表；读到旧代数时下一次查询会再刷新
+        auto generation = generation_.load(std::memory_order_acquire);
+        if (cache.filter_id_ != id_ || cache.generation_ != generation) {
+            cache.table_      = table_.load(std::memory_order_acquire);
+            cache.filter_id_  = id_;
+            cache.generation_ = generation;
+        }
+        return *cache.table_;
+    }
+
+    void ChunkFilter::publish(std::shared_ptr<Table> table) {
+        table_.store(std::move(table), std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    uint64_t ChunkFilter::digest(std::string_view hash) {
+        //FNV-1a 后接 splitmix64 的终结混合，保证高低位都均匀
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : hash) {
+            h = (h ^ c) * 0x100000001b3ULL;
+        }
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    size_t ChunkFilter::bucket_count_for(size_t items) {
+        //按约90%的目标负载计算，取2的幂
+        size_t buckets = items / kSlotsPerBucket + items / (kSlotsPerBucket * 9) + 1;
+        return std::bit_ceil(buckets);
+    }
+
+    uint16_t ChunkFilter::fingerprint(uint64_t digest) {
+        //指纹取高16位，桶号取低位，两者互不相关；0 表示空槽
+        auto fp = static_cast<uint16_t>(digest >> 48);
+        return fp == 0 ? 1 : fp;
+    }
+
+    size_t ChunkFilter::alternate(const Table& table, size_t index, uint16_t fingerprint) {
+        return (index ^ (static_cast<size_t>(fingerprint) * 0x5bd1e995)) & table.mask_;
+    }
+
+    bool ChunkFilter::bucket_contains(uint64_t bucket, uint16_t fingerprint) {
+        for (int i = 0; i < kSlotsPerBucket; ++i) {
+            if (slot(bucket, i) == fingerprint) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ChunkFilter::buckets_contain(const Table& table, size_t first, size_t second, uint16_t fingerprint) {
+        return bucket_contains(table.buckets_[first].load(std::memory_order_relaxed), fingerprint) ||
+               bucket_contains(table.buckets_[second].load(std::memory_order_relaxed), fingerprint);
+    }
+
+    bool ChunkFilter::try_store(Table& table, size_t index, uint16_t fingerprint) {
+        auto bucket = table.buckets_[index].load(std::memory_order_relaxed);
+        for (int i = 0; i < kSlotsPerBucket; ++i) {
+            if (slot(bucket, i) == 0) {
+                table.buckets_[index].store(with_slot(bucket, i, fingerprint), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ChunkFilter::try_erase(Table& table, size_t index, uint16_t fingerprint) {
+        auto bucket = table.buckets_[index].load(std::memory_order_relaxed);
+        for (int i = 0; i < kSlotsPerBucket; ++i) {
+            if (slot(bucket, i) == fingerprint) {
+                table.buckets_[index].store(with_slot(bucket, i, 0), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ChunkFilter::insert(Table& table, uint64_t digest) {
+        auto fp     = fingerprint(digest);
+        auto first  = static_cast<size_t>(digest) & table.mask_;
+        auto second = alternate(table, first, fp);
+
+        table.items_.fetch_add(1, std::memory_order_relaxed);
+        if (try_store(table, first, fp) || try_store(table, second, fp)) {
+            return;
+        }
+
+        //踢出迁移：被踢出的指纹在“手上”时不在表中，版本号为奇数，查询方会等待并重试
+        auto version = table.version_.load(std::memory_order_relaxed);
+        table.version_.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto index = (digest >> 32) & 1 ? second : first;
+        bool placed = false;
+        for (int kick = 0; kick < kMaxKicks && !placed; ++kick) {
+            int victim  = static_cast<int>((digest >> (kick % 48)) + kick) & (kSlotsPerBucket - 1);
+            auto bucket = table.buckets_[index].load(std::memory_order_relaxed);
+            auto evicted = slot(bucket, victim);
+            table.buckets_[index].store(with_slot(bucket, victim, fp), std::memory_order_relaxed);
+
+            fp     = evicted;
+            index  = alternate(table, index, fp);
+            placed = try_store(table, index, fp);
+        }
+
+        if (!placed) {
+            table.stash_.push_back(StashEntry{index, fp});
+            table.stash_size_.store(table.stash_.size(), std::memory_order_relaxed);
+        }
+
+        table.version_.store(version + 2, std::memory_order_release);
+    }
+
+    bool ChunkFilter::stash_contains(const Table& table, size_t first, size_t second, uint16_t fingerprint) const {
+        std::lock_guard lock(write_mutex_);
+        for (const auto& entry : table.stash_) {
+            if (entry.fingerprint_ == fingerprint && (entry.index_ == first || entry.index_ == second)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ChunkFilter::may_contain(const HashValue& hash) const {
+        //同一次采样同时用于查询数与否定数，两者的比例不受采样影响
+        bool sampled = Common::sample_stat();
+        if (sampled) {
+            lookups_.fetch_add(Common::kStatSampleRate, std::memory_order_relaxed);
+        }
+
+        const auto& table = reader_table();
+        auto d      = digest(hash);
+        auto fp     = fingerprint(d);
+        auto first  = static_cast<size_t>(d) & table.mask_;
+        auto second = alternate(table, first, fp);
+
+        while (true) {
+            auto before = table.version_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (buckets_contain(table, first, second, fp)) {
+                return true;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (table.version_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        if (table.stash_size_.load(std::memory_order_acquire) != 0 && stash_contains(table, first, second, fp)) {
+            return true;
+        }
+
+        if (sampled) {
+            negatives_.fetch_add(Common::kStatSampleRate, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    void ChunkFilter::add(const HashValue& hash) {
+        auto d = digest(hash);
+
+        std::lock_guard lock(write_mutex_);
+        insert(*table_.load(std::memory_order_acquire), d);
+        if (rebuilding_.load(std::memory_order_relaxed)) {
+            pending_adds_.push_back(d);
+        }
+    }
+
+    bool ChunkFilter::remove(const HashValue& hash) {
+        auto d = digest(hash);
+
+        std::lock_guard lock(write_mutex_);
+        auto table  = table_.load(std::memory_order_acquire);
+        auto fp     = fingerprint(d);
+        auto first  = static_cast<size_t>(d) & table->mask_;
+        auto second = alternate(*table, first, fp);
+
+        bool removed = try_erase(*table, first, fp) || try_erase(*table, second, fp);
+        if (!removed) {
+            for (auto it = table->stash_.begin(); it != table->stash_.end(); ++it) {
+                if (it->fingerprint_ == fp && (it->index_ == first || it->index_ == second)) {
+                    table->stash_.erase(it);
+                    table->stash_size_.store(table->stash_.size(), std::memory_order_relaxed);
+                    removed = true;
+                    break;
+                }
+            }
+        }
+
+        if (removed) {
+            table->items_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (rebuilding_.load(std::memory_order_relaxed)) {
+            std::erase(pending_adds_, d);
+        }
+        return removed;
+    }
+
+    size_t ChunkFilter::size() const {
+        return table_.load(std::memory_order_acquire)->items_.load(std::memory_order_relaxed);
+    }
+
+    bool ChunkFilter::needs_rebuild() const {
+        auto table    = table_.load(std::memory_order_acquire);
+        auto capacity = static_cast<double>(table->buckets_.size() * kSlotsPerBucket);
+        return table->stash_size_.load(std::memory_order_relaxed) != 0 ||
+               static_cast<double>(table->items_.load(std::memory_order_relaxed)) > capacity * options_.max_load_factor_;
+    }
+
+    ChunkFilterStats ChunkFilter::stats() const {
+        auto table = table_.load(std::memory_order_acquire);
+
+        ChunkFilterStats stats{};
+        stats.capacity_        = table->buckets_.size() * kSlotsPerBucket;
+        stats.items_           = table->items_.load(std::memory_order_relaxed);
+        stats.stashed_         = table->stash_size_.load(std::memory_order_relaxed);
+        stats.lookups_         = lookups_.load(std::memory_order_relaxed);
+        stats.negatives_       = negatives_.load(std::memory_order_relaxed);
+        stats.false_positives_ = false_positives_.load(std::memory_order_relaxed);
+        stats.load_factor_     = stats.capacity_ > 0 ? static_cast<double>(stats.items_) / stats.capacity_ : 0.0;
+        //两个候选桶共 2*4 个槽，每个槽与随机指纹相同的概率为 1/65535
+        stats.estimated_fpr_   = 2.0 * kSlotsPerBucket * stats.load_factor_ / 65535.0;
+
+        auto absent = stats.negatives_ + stats.false_positives_;
+        stats.observed_fpr_ = absent > 0 ? static_cast<double>(stats.false_positives_) / absent : 0.0;
+        return stats;
+    }
+
+    Common::Result<bool> ChunkFilter::rebuild(DataBase::ShardedMetadataStore& store) {
+        std::lock_guard rebuild_lock(rebuild_mutex_);
+        if (!store.is_open()) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "元数据存储未打开");
+        }
+
+        auto started = std::chrono::steady_clock::now();
+
+        //用独立连接扫描，不占用存储的只读连接（WAL模式下也不阻塞写入）
+        std::vector<std::unique_ptr<DataBase::DatabaseConnector>> connectors;
+        int64_t total = 0;
+        for (uint32_t i = 0; i < store.shard_count(); ++i) {
+            auto path = DataBase::ShardedMetadataStore::shard_path(store.directory(), i, store.shard_count());
+            auto connector = std::make_unique<DataBase::DatabaseConnector>(path.string());
+            if (!connector->is_connected()) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法打开分库：" + path.string());
+            }
+
+            auto counted = connector->execute_statement("SELECT count(*) FROM chunks", nullptr,
+                [&total](sqlite3_stmt* stmt) { total += sqlite3_column_int64(stmt, 0); });
+            if (counted.failed()) {
+                return counted;
+            }
+            connectors.push_back(std::move(connector));
+        }
+
+        //容量留出一倍余量，避免刚重建完又因增长而重建
+        auto expected = std::max(options_.expected_items_, static_cast<size_t>(total) * 2);
+        auto table = std::make_shared<Table>(bucket_count_for(expected));
+
+        {
+            std::lock_guard lock(write_mutex_);
+            pending_adds_.clear();
+            rebuilding_.store(true, std::memory_order_release);
+        }
+
+        for (auto& connector : connectors) {
+            auto scanned = connector->execute_statement("SELECT hash FROM chunks", nullptr, [&table](sqlite3_stmt* stmt) {
+                std::string_view hash(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                                      static_cast<size_t>(sqlite3_column_bytes(stmt, 0)));
+                insert(*table, digest(hash));
+            });
+
+            if (scanned.failed()) {
+                std::lock_guard lock(write_mutex_);
+                rebuilding_.store(false, std::memory_order_release);
+                pending_adds_.clear();
+                return scanned;
+            }
+        }
+
+        {
+            std::lock_guard lock(write_mutex_);
+            for (auto d : pending_adds_) {
+                insert(*table, d);
+            }
+            pending_adds_.clear();
+            pending_adds_.shrink_to_fit();
+
+            publish(table);
+            rebuilding_.store(false, std::memory_order_release);
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO_FMT("分片过滤器重建完成：{0} 个分片，容量 {1}，耗时 {2} ms",
+                     table->items_.load(), table->buckets_.size() * kSlotsPerBucket, elapsed.count());
+        return Common::Result<bool>::Success(true);
+    }
+
+    std::future<Common::Result<bool>> ChunkFilter::rebuild_async(DataBase::ShardedMetadataStore& store) {
+        return std::async(std::launch::async, [this, &store] { return rebuild(store); });
+    }
+
+    Common::Result<bool> ChunkFilter::save(const std::filesystem::path& path) const {
+        auto temp_path = path;
+        temp_path += ".tmp";
+
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法写入过滤器文件：" + temp_path.string());
+            }
+
+            std::lock_guard lock(write_mutex_);
+            auto table = table_.load(std::memory_order_acquire);
+
+            write_pod(out, kFileMagic);
+            write_pod(out, kFileVersion);
+            write_pod(out, static_cast<uint64_t>(table->buckets_.size()));
+            write_pod(out, table->items_.load());
+            write_pod(out, static_cast<uint64_t>(table->stash_.size()));
+            for (const auto& entry : table->stash_) {
+                write_pod(out, static_cast<uint64_t>(entry.index_));
+                write_pod(out, static_cast<uint64_t>(entry.fingerprint_));
+            }
+
+            std::vector<uint64_t> buckets(table->buckets_.size());
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                buckets[i] = table->buckets_[i].load(std::memory_order_relaxed);
+            }
+            out.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint64_t)));
+
+            out.flush();
+            if (!out) {
+                return Common::Result<bool>::Error(Common::StatusCode::ERROR, "写入过滤器文件失败：" + temp_path.string());
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "过滤器文件改名失败：" + ec.message());
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<std::unique_ptr<ChunkFilter>> ChunkFilter::load(const std::filesystem::path& path, ChunkFilterOptions options) {
+        using LoadResult = Common::Result<std::unique_ptr<ChunkFilter>>;
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return LoadResult::Error(Common::StatusCode::FILE_NOT_FOUND, "过滤器文件不存在：" + path.string());
+        }
+
+        uint32_t magic = 0, version = 0;
+        uint64_t bucket_count = 0, items = 0, stashed = 0;
+        if (!read_pod(in, magic) || !read_pod(in, version) || magic != kFileMagic || version != kFileVersion ||
+            !read_pod(in, bucket_count) || !read_pod(in, items) || !read_pod(in, stashed) ||
+            bucket_count == 0 || !std::has_single_bit(bucket_count)) {
+            return LoadResult::Error(Common::StatusCode::ERROR, "过滤器文件格式无效：" + path.string());
+        }
+
+        auto filter = std::make_unique<ChunkFilter>(options);
+        auto table  = std::make_shared<Table>(static_cast<size_t>(bucket_count));
+        table->items_.store(items);
+
+        for (uint64_t i = 0; i < stashed; ++i) {
+            uint64_t index = 0, fp = 0;
+            if (!read_pod(in, index) || !read_pod(in, fp) || index > table->mask_) {
+                return LoadResult::Error(Common::StatusCode::ERROR, "过滤器文件已损坏：" + path.string());
+            }
+            table->stash_.push_back(StashEntry{static_cast<size_t>(index), static_cast<uint16_t>(fp)});
+        }
+        table->stash_size_.store(table->stash_.size());
+
+        std::vector<uint64_t> buckets(static_cast<size_t>(bucket_count));
+        if (!in.read(reinterpret_cast<char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint64_t)))) {
+            return LoadResult::Error(Common::StatusCode::ERROR, "过滤器文件已损坏：" + path.string());
+        }
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            table->buckets_[i].store(buckets[i], std::memory_order_relaxed);
+        }
+        in.close();
+
+        filter->publish(std::move(table));
+
+        //文件只对应上次正常关闭时的状态，加载后立即删除，防止崩溃后误用过期的过滤器
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+
+        return LoadResult::Success(std::move(filter));
+    }
+
+}
@@ -0,0 +1,252 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/garbage_collector.hpp"
+#include <algorithm>
+#include <cmath>
+#include "metadata_manager.hpp"
+#include "sharded_metadata_store.hpp"
+#include "Log.hpp"
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        //回收速率滑动平均的时间常数
+        constexpr double kRateTimeConstantSeconds = 60.0;
+
+    }
+
+    GarbageCollector::GarbageCollector(DataBase::ShardedMetadataStore& store, MetadataManager& manager, GcOptions options)
+        : store_(store)
+        , manager_(manager)
+        , options_(options)
+        , rate_updated_(std::chrono::steady_clock::now()) {
+        if (options_.batch_size_ == 0) {
+            options_.batch_size_ = 1;
+        }
+    }
+
+    GarbageCollector::~GarbageCollector() {
+        stop();
+    }
+
+    void GarbageCollector::start() {
+        std::lock_guard lock(run_mutex_);
+        if (running_) {
+            return;
+        }
+        running_       = true;
+        worker_thread_ = std::thread(&GarbageCollector::run, this);
+    }
+
+    void GarbageCollector::stop() {
+        {
+            std::lock_guard lock(run_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        run_cv_.notify_all();
+        worker_thread_.join();
+    }
+
+    Common::Result<size_t> GarbageCollector::run_once() {
+        std::lock_guard lock(collect_mutex_);
+
+        //第一次运行时从各分库读取检查点
+        if (!progress_loaded_) {
+            progress_.clear();
+            for (uint32_t shard = 0; shard < store_.shard_count(); ++shard) {
+                auto progress = DataBase::MetadataRepository::load_gc_progress(store_, shard);
+                if (progress.failed()) {
+                    return Common::Result<size_t>::Error(progress.status_code(), "读取垃圾回收进度失败：" + progress.message());
+                }
+                progress_.push_back(std::move(progress.value()));
+            }
+            progress_loaded_ = true;
+        }
+
+        size_t   chunks   = 0;
+        FileSize bytes    = 0;
+        bool     mid_pass = false;
+        for (uint32_t shard = 0; shard < store_.shard_count(); ++shard) {
+            auto collected = collect_shard(shard);
+            if (collected.failed()) {
+                return Common::Result<size_t>::Error(collected);
+            }
+            chunks += collected.value().first;
+            bytes  += collected.value().second;
+            mid_pass = mid_pass || progress_[shard].cursor_time_ != 0 || !progress_[shard].cursor_hash_.empty();
+        }
+        mid_pass_.store(mid_pass, std::memory_order_relaxed);
+
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        update_rate(bytes);
+        if (chunks > 0) {
+            LOG_DEBUG_FMT("垃圾回收：本批回收 {0} 个分片，{1} 字节", chunks, bytes);
+        }
+        return Common::Result<size_t>::Success(chunks);
+    }
+
+    Common::Result<std::pair<size_t, FileSize>> GarbageCollector::collect_shard(uint32_t shard) {
+        using ShardResult = Common::Result<std::pair<size_t, FileSize>>;
+
+        auto& progress = progress_[shard];
+        auto  cutoff   = std::chrono::system_clock::now() - options_.grace_period_;
+        auto  candidates = DataBase::MetadataRepository::load_gc_candidates(store_, shard, cutoff, progress.cursor_time_,
+                                                                            progress.cursor_hash_, options_.batch_size_);
+        if (candidates.failed()) {
+            return ShardResult::Error(candidates);
+        }
+
+        bool at_start = progress.cursor_time_ == 0 && progress.cursor_hash_.empty();
+        if (candidates.value().empty() && at_start) {
+            return ShardResult::Success({0, 0});
+        }
+
+        //推进游标；不足一批说明本轮已到末尾，游标回到起点
+        auto next = progress;
+        if (candidates.value().size() < options_.batch_size_) {
+            next.cursor_time_ = 0;
+            next.cursor_hash_.clear();
+            ++next.passes_;
+        } else {
+            next.cursor_time_ = candidates.value().back().updated_at_;
+            next.cursor_hash_ = candidates.value().back().hash_;
+        }
+
+        //检查、删除、去掉缓存与删除分片数据期间持有这些哈希的写锁，put_chunk 等写操作不会穿插其中
+        std::vector<HashValue> hashes;
+        hashes.reserve(candidates.value().size());
+        for (const auto& candidate : candidates.value()) {
+            hashes.push_back(candidate.hash_);
+        }
+        auto locks = manager_.lock_writes(hashes);
+
+        //引用数日志中有待写入的增量（可能是重新引用）的候选本轮跳过
+        std::vector<DataBase::GcCandidate> eligible;
+        eligible.reserve(candidates.value().size());
+        const auto& log = manager_.ref_count_log();
+        for (auto& candidate : candidates.value()) {
+            if (log && log->pending(RefTarget::Chunk, candidate.hash_) > 0) {
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            eligible.push_back(std::move(candidate));
+        }
+
+        //元数据删除与游标推进在同一事务中，崩溃后不会重复或遗漏。
+        //引用数增量不经过写锁：在事务内删除前再检查一次，排除上面检查之后追加的重新引用
+        std::vector<uint8_t> removed(eligible.size(), 0);
+        auto written = store_.submit_to(shard, [&](DataBase::DatabaseConnector& connector) {
+            auto saved = next;
+            for (size_t i = 0; i < eligible.size(); ++i) {
+                if (log && log->pending(RefTarget::Chunk, eligible[i].hash_) > 0) {
+                    skipped_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                auto result = DataBase::MetadataRepository::remove_unreferenced_chunk(connector, eligible[i]);
+                if (result.failed()) {
+                    return result;
+                }
+                removed[i] = result.value() ? 1 : 0;
+                if (removed[i]) {
+                    ++saved.reclaimed_chunks_;
+                    saved.reclaimed_bytes_ += eligible[i].size_;
+                }
+            }
+            auto result = DataBase::MetadataRepository::save_gc_progress(connector, saved);
+            if (result.success()) {
+                next = std::move(saved);
+            }
+            return result;
+        }).get();
+        if (written.failed()) {
+            return ShardResult::Error(written);
+        }
+        progress = std::move(next);
+
+        //元数据已删除：去掉缓存，再删除分片数据（失败只会留下无引用的孤立数据）
+        size_t   chunks = 0;
+        FileSize bytes  = 0;
+        for (size_t i = 0; i < eligible.size(); ++i) {
+            if (!removed[i]) {
+                continue;
+            }
+            const auto& candidate = eligible[i];
+            manager_.evict_chunk(candidate.hash_);
+            if (reclaimer_) {
+                auto reclaimed = reclaimer_(candidate.hash_, candidate.size_);
+                if (reclaimed.failed()) {
+                    storage_failures_.fetch_add(1, std::memory_order_relaxed);
+                    LOG_WARN_FMT("删除分片数据失败：{0}：{1}", candidate.hash_, reclaimed.message());
+                }
+            }
+            ++chunks;
+            bytes += candidate.size_;
+        }
+
+        reclaimed_chunks_.fetch_add(chunks, std::memory_order_relaxed);
+        reclaimed_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        return ShardResult::Success({chunks, bytes});
+    }
+
+    std::chrono::milliseconds GarbageCollector::throttle(size_t chunks, FileSize bytes) const {
+        double seconds = 0.0;
+        if (options_.max_chunks_per_second_ > 0) {
+            seconds = std::max(seconds, static_cast<double>(chunks) / options_.max_chunks_per_second_);
+        }
+        if (options_.max_bytes_per_second_ > 0) {
+            seconds = std::max(seconds, static_cast<double>(bytes) / options_.max_bytes_per_second_);
+        }
+        return std::chrono::milliseconds(static_cast<int64_t>(std::ceil(seconds * 1000.0)));
+    }
+
+    void GarbageCollector::update_rate(FileSize bytes) {
+        auto now     = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration<double>(now - rate_updated_).count();
+        rate_updated_ = now;
+        if (elapsed <= 0.0) {
+            return;
+        }
+
+        auto alpha = 1.0 - std::exp(-elapsed / kRateTimeConstantSeconds);
+        auto rate  = bytes_per_second_.load(std::memory_order_relaxed);
+        bytes_per_second_.store(rate + alpha * (static_cast<double>(bytes) / elapsed - rate), std::memory_order_relaxed);
+    }
+
+    GcMetrics GarbageCollector::metrics() const {
+        return GcMetrics{
+            reclaimed_chunks_.load(std::memory_order_relaxed),
+            reclaimed_bytes_.load(std::memory_order_relaxed),
+            skipped_.load(std::memory_order_relaxed),
+            storage_failures_.load(std::memory_order_relaxed),
+            batches_.load(std::memory_order_relaxed),
+            bytes_per_second_.load(std::memory_order_relaxed)
+        };
+    }
+
+    void GarbageCollector::run() {
+        std::unique_lock lock(run_mutex_);
+        while (running_) {
+            lock.unlock();
+            auto before = reclaimed_bytes_.load(std::memory_order_relaxed);
+            auto chunks = run_once();
+            auto bytes  = reclaimed_bytes_.load(std::memory_order_relaxed) - before;
+            lock.lock();
+
+            //本轮已扫描完（或出错）时按空闲周期等待，否则按速率上限等待下一批
+            std::chrono::milliseconds wait = options_.idle_interval_;
+            if (chunks.failed()) {
+                LOG_WARN_FMT("垃圾回收失败，稍后重试：{0}", chunks.message());
+            } else if (chunks.value() > 0 || mid_pass_.load(std::memory_order_relaxed)) {
+                wait = throttle(chunks.value(), bytes);
+            }
+            run_cv_.wait_for(lock, wait, [this] { return !running_; });
+        }
+    }
+
+}
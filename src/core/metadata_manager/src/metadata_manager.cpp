@@ -0,0 +1,351 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/metadata_manager.hpp"
+#include <algorithm>
+#include <optional>
+#include "metadata_repository.hpp"
+#include "Log.hpp"
+
+
+namespace RefStorage::Core {
+
+    MetadataManager::MetadataManager(DataBase::ShardedMetadataStore& store) : store_(store) {}
+
+    Common::Result<bool> MetadataManager::warm_up() {
+        auto started = std::chrono::steady_clock::now();
+
+        auto chunks = DataBase::MetadataRepository::load_all_chunks(store_);
+        if (chunks.failed()) {
+            return Common::Result<bool>::Error(chunks.status_code(), "加载分片元数据失败：" + chunks.message());
+        }
+
+        auto files = DataBase::MetadataRepository::load_all_files(store_);
+        if (files.failed()) {
+            return Common::Result<bool>::Error(files.status_code(), "加载文件元数据失败：" + files.message());
+        }
+
+        chunks_.clear();
+        chunks_.reserve(chunks.value().size());
+        for (auto& chunk : chunks.value()) {
+            auto hash = chunk.hash_value_;
+            chunks_.insert_or_assign(hash, std::make_shared<const Common::ChunkInfo>(std::move(chunk)));
+        }
+
+        //过滤器从持久化文件加载时已与数据库一致；为空说明是新建的（如崩溃后），用加载结果填充
+        if (chunk_filter_ && chunk_filter_->size() == 0) {
+            chunks_.for_each([this](const HashValue& hash, const ChunkPtr&) { chunk_filter_->add(hash); });
+        }
+
+        //文件的分片列表只有哈希与大小，用已加载的分片信息补全
+        files_.clear();
+        path_files_.clear();
+        files_.reserve(files.value().size());
+        for (auto& file : files.value()) {
+            Common::ChunkTable completed;
+            completed.reserve(file.chunks_.size());
+            for (const auto& chunk : file.chunks_) {
+                auto cached = chunks_.find(chunk.hash());
+                completed.push_back(cached ? *cached : chunk.to_chunk_info());
+            }
+            file.chunks_ = std::move(completed);
+            cache_file(std::make_shared<Common::FileMataData>(std::move(file)));
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO_FMT("元数据缓存预热完成：文件 {0} 个，分片 {1} 个，路径节点 {2} 个，耗时 {3} ms",
+                     files_.size(), chunks_.size(), paths_.size(), elapsed.count());
+        return Common::Result<bool>::Success(true);
+    }
+
+    MetadataManager::ChunkPtr MetadataManager::find_chunk(const HashValue& hash) const {
+        if (chunk_filter_ && !chunk_filter_->may_contain(hash)) {
+            return nullptr;
+        }
+
+        auto chunk = chunks_.find(hash);
+        if (chunk_filter_ && !chunk) {
+            chunk_filter_->record_false_positive();
+        }
+        return chunk;
+    }
+
+    Common::Result<bool> MetadataManager::put_file(Common::FileMataData file) {
+        std::lock_guard lock(write_lock_for(file.hash_value_));
+
+        //缓存中的对象不保存 path（已驻留为 path_id_）：读出后修改再写回时由 path_id_ 还原目录
+        if (file.path.empty() && file.path_id_ != PathDictionary::kRoot) {
+            file.path = paths_.path(file.path_id_);
+        }
+
+        auto stored = std::make_shared<Common::FileMataData>(std::move(file));
+        auto result = store_.submit(stored->hash_value_, [stored](DataBase::DatabaseConnector& connector) {
+            return DataBase::MetadataRepository::save_file(connector, *stored);
+        }).get();
+        if (result.failed()) {
+            return result;
+        }
+
+        //引用数由增量日志维护，save_file 不覆盖：已缓存时沿用缓存中的基准值
+        //（它与增量写入回调同步，读回的数据库值可能已含有回调尚未同步到缓存的增量）
+        if (auto cached = files_.find(stored->hash_value_)) {
+            stored->reference_count_ = cached->reference_count_;
+        }
+        cache_file(std::move(stored));
+        return result;
+    }
+
+    Common::Result<bool> MetadataManager::remove_file(const HashValue& hash) {
+        std::lock_guard lock(write_lock_for(hash));
+
+        auto result = store_.submit(hash, [hash](DataBase::DatabaseConnector& connector) {
+            return DataBase::MetadataRepository::remove_file(connector, hash);
+        }).get();
+        if (result.failed()) {
+            return result;
+        }
+
+        uncache_file(hash);
+        return result;
+    }
+
+    void MetadataManager::set_ref_count_log(std::shared_ptr<RefCountLog> log) {
+        ref_count_log_ = std::move(log);
+        if (!ref_count_log_) {
+            return;
+        }
+
+        //增量已写入数据库：按写时复制更新缓存中的基准值
+        ref_count_log_->set_apply_listener([this](RefTarget target, const HashValue& hash, int64_t delta) {
+            if (target != RefTarget::File) {
+                return;
+            }
+            std::lock_guard lock(write_lock_for(hash));
+            auto cached = files_.find(hash);
+            if (!cached) {
+                return;
+            }
+            auto updated = std::make_shared<Common::FileMataData>(*cached);
+            updated->reference_count_ = static_cast<uint32_t>(std::max<int64_t>(int64_t{updated->reference_count_} + delta, 0));
+            files_.insert_or_assign(hash, std::move(updated));
+        });
+    }
+
+    uint64_t MetadataManager::file_references(const HashValue& hash) const {
+        auto    cached = files_.find(hash);
+        int64_t count  = cached ? cached->reference_count_ : 0;
+        if (ref_count_log_) {
+            count += ref_count_log_->pending(RefTarget::File, hash);
+        }
+        return static_cast<uint64_t>(std::max<int64_t>(count, 0));
+    }
+
+    std::string MetadataManager::file_path(const Common::FileMataData& file) const {
+        auto directory = paths_.path(file.path_id_);
+        return directory.empty() ? file.file_name_ : directory + "/" + file.file_name_;
+    }
+
+    MetadataManager::DirectoryListing MetadataManager::list_directory(std::string_view directory) const {
+        DirectoryListing listing;
+        auto id = paths_.find(directory);
+        if (!id) {
+            return listing;
+        }
+
+        for (auto child : paths_.children(*id)) {
+            listing.directories_.push_back(paths_.name(child));
+        }
+        if (auto hashes = path_files_.find(*id)) {
+            for (const auto& hash : *hashes) {
+                if (auto file = files_.find(hash)) {
+                    listing.files_.push_back(std::move(file));
+                }
+            }
+        }
+        return listing;
+    }
+
+    Common::Result<size_t> MetadataManager::remove_subtree(std::string_view directory) {
+        auto id = paths_.find(directory);
+        if (!id) {
+            return Common::Result<size_t>::Success(0);
+        }
+
+        //先收集哈希再删除：遍历期间持有字典的共享锁
+        std::vector<HashValue> hashes;
+        paths_.for_each_descendant(*id, [this, &hashes](PathID path) {
+            if (auto files = path_files_.find(path)) {
+                hashes.insert(hashes.end(), files->begin(), files->end());
+            }
+        });
+
+        //持有全部写锁，期间只等待一轮提交
+        auto locks = lock_writes(hashes);
+
+        std::vector<std::future<Common::Result<bool>>> pending;
+        pending.reserve(hashes.size());
+        for (const auto& hash : hashes) {
+            pending.push_back(store_.submit(hash, [hash](DataBase::DatabaseConnector& connector) {
+                return DataBase::MetadataRepository::remove_file(connector, hash);
+            }));
+        }
+
+        size_t removed = 0;
+        std::optional<Common::Result<bool>> first_error;
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            auto result = pending[i].get();
+            if (result.failed()) {
+                if (!first_error) {
+                    first_error = std::move(result);
+                }
+                continue;
+            }
+            uncache_file(hashes[i]);
+            ++removed;
+        }
+
+        if (first_error) {
+            return Common::Result<size_t>::Error(*first_error);
+        }
+        return Common::Result<size_t>::Success(removed);
+    }
+
+    void MetadataManager::cache_file(std::shared_ptr<Common::FileMataData> file) {
+        file->path_id_ = paths_.intern(file->path);
+        std::string().swap(file->path);
+
+        const auto& hash = file->hash_value_;
+        auto previous = files_.find(hash);
+        files_.insert_or_assign(hash, file);
+
+        std::lock_guard lock(path_files_mutex_);
+        if (previous && previous->path_id_ != file->path_id_) {
+            unindex_path_locked(previous->path_id_, hash);
+        }
+
+        auto current = path_files_.find(file->path_id_);
+        if (!current || std::find(current->begin(), current->end(), hash) == current->end()) {
+            auto hashes = current ? *current : std::vector<HashValue>();
+            hashes.push_back(hash);
+            path_files_.insert_or_assign(file->path_id_, std::make_shared<const std::vector<HashValue>>(std::move(hashes)));
+        }
+    }
+
+    void MetadataManager::uncache_file(const HashValue& hash) {
+        auto previous = files_.find(hash);
+        if (!previous || !files_.erase(hash)) {
+            return;
+        }
+
+        std::lock_guard lock(path_files_mutex_);
+        unindex_path_locked(previous->path_id_, hash);
+    }
+
+    void MetadataManager::unindex_path_locked(PathID path, const HashValue& hash) {
+        auto current = path_files_.find(path);
+        if (!current) {
+            return;
+        }
+
+        auto hashes = *current;
+        std::erase(hashes, hash);
+        if (hashes.empty()) {
+            path_files_.erase(path);
+        }
+        else {
+            path_files_.insert_or_assign(path, std::make_shared<const std::vector<HashValue>>(std::move(hashes)));
+        }
+    }
+
+    Common::Result<bool> MetadataManager::put_chunk(Common::ChunkInfo chunk) {
+        std::lock_guard lock(write_lock_for(chunk.hash_value_));
+
+        bool existed = chunks_.contains(chunk.hash_value_);
+        auto stored  = std::make_shared<const Common::ChunkInfo>(std::move(chunk));
+        auto result = store_.submit(stored->hash_value_, [stored](DataBase::DatabaseConnector& connector) {
+            return DataBase::MetadataRepository::save_chunk(connector, *stored);
+        }).get();
+        if (result.failed()) {
+            return result;
+        }
+
+        const auto& hash = stored->hash_value_;
+        chunks_.insert_or_assign(hash, stored);
+        if (chunk_filter_ && !existed) {
+            chunk_filter_->add(hash);
+            maybe_rebuild_filter();
+        }
+        return result;
+    }
+
+    Common::Result<bool> MetadataManager::remove_chunk(const HashValue& hash) {
+        std::lock_guard lock(write_lock_for(hash));
+
+        auto result = store_.submit(hash, [hash](DataBase::DatabaseConnector& connector) {
+            return DataBase::MetadataRepository::remove_chunk(connector, hash);
+        }).get();
+        if (result.failed()) {
+            return result;
+        }
+
+        if (chunks_.erase(hash) && chunk_filter_) {
+            chunk_filter_->remove(hash);
+        }
+        return result;
+    }
+
+    void MetadataManager::evict_chunk(const HashValue& hash) {
+        if (chunks_.erase(hash) && chunk_filter_) {
+            chunk_filter_->remove(hash);
+        }
+    }
+
+    std::vector<std::unique_lock<std::mutex>> MetadataManager::lock_writes(const std::vector<HashValue>& hashes) {
+        std::vector<size_t> stripes;
+        stripes.reserve(hashes.size());
+        for (const auto& hash : hashes) {
+            stripes.push_back(write_stripe_of(hash));
+        }
+        std::sort(stripes.begin(), stripes.end());
+        stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(stripes.size());
+        for (auto stripe : stripes) {
+            locks.emplace_back(write_locks_[stripe]);
+        }
+        return locks;
+    }
+
+    void MetadataManager::maybe_rebuild_filter() {
+        if (!chunk_filter_->needs_rebuild() || chunk_filter_->is_rebuilding()) {
+            return;
+        }
+
+        std::unique_lock lock(filter_rebuild_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        if (filter_rebuild_.valid()) {
+            if (filter_rebuild_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return;
+            }
+            auto previous = filter_rebuild_.get();
+            if (previous.failed()) {
+                LOG_WARN_FMT("分片过滤器重建失败：{0}", previous.message());
+            }
+        }
+
+        LOG_INFO("分片过滤器负载过高，开始后台重建");
+        filter_rebuild_ = chunk_filter_->rebuild_async(store_);
+    }
+
+    size_t MetadataManager::write_stripe_of(const HashValue& hash) {
+        return std::hash<HashValue>{}(hash) % kWriteStripes;
+    }
+
+    std::mutex& MetadataManager::write_lock_for(const HashValue& hash) {
+        return write_locks_[write_stripe_of(hash)];
+    }
+
+}
@@ -0,0 +1,185 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/path_dictionary.hpp"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        //短名称保存在 std::string 对象内部（SSO），不额外分配
+        constexpr size_t kShortNameLength = 15;
+
+    }
+
+    PathDictionary::PathDictionary() {
+        nodes_.push_back(Node{kRoot, {}, {}});
+    }
+
+    std::vector<std::string_view> PathDictionary::split(std::string_view path) {
+        std::vector<std::string_view> components;
+        size_t start = 0;
+        while (start <= path.size()) {
+            auto end = path.find_first_of("/\\", start);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            auto component = path.substr(start, end - start);
+            if (!component.empty() && component != ".") {
+                components.push_back(component);
+            }
+            start = end + 1;
+        }
+        return components;
+    }
+
+    PathID PathDictionary::intern(std::string_view path) {
+        auto components = split(path);
+
+        //先在共享锁下走完已存在的前缀，通常整条路径都已驻留
+        PathID current = kRoot;
+        size_t matched = 0;
+        {
+            std::shared_lock lock(mutex_);
+            for (; matched < components.size(); ++matched) {
+                auto child = find_child_locked(current, components[matched]);
+                if (!child) {
+                    break;
+                }
+                current = *child;
+            }
+        }
+        if (matched == components.size()) {
+            return current;
+        }
+
+        std::unique_lock lock(mutex_);
+        for (; matched < components.size(); ++matched) {
+            auto child = find_child_locked(current, components[matched]);
+            current = child ? *child : insert_child_locked(current, components[matched]);
+        }
+        return current;
+    }
+
+    PathID PathDictionary::intern_child(PathID parent, std::string_view name) {
+        {
+            std::shared_lock lock(mutex_);
+            if (auto child = find_child_locked(parent, name)) {
+                return *child;
+            }
+        }
+
+        std::unique_lock lock(mutex_);
+        auto child = find_child_locked(parent, name);
+        return child ? *child : insert_child_locked(parent, name);
+    }
+
+    std::optional<PathID> PathDictionary::find(std::string_view path) const {
+        auto components = split(path);
+
+        std::shared_lock lock(mutex_);
+        PathID current = kRoot;
+        for (auto component : components) {
+            auto child = find_child_locked(current, component);
+            if (!child) {
+                return std::nullopt;
+            }
+            current = *child;
+        }
+        return current;
+    }
+
+    std::string PathDictionary::path(PathID id) const {
+        std::vector<const std::string*> names;
+        size_t length = 0;
+        {
+            std::shared_lock lock(mutex_);
+            for (auto current = id; current != kRoot; current = nodes_.at(current).parent_) {
+                names.push_back(&nodes_[current].name_);
+                length += nodes_[current].name_.size() + 1;
+            }
+        }
+
+        //名称字符串只增不改，释放锁后读取是安全的
+        std::string result;
+        result.reserve(length);
+        for (auto it = names.rbegin(); it != names.rend(); ++it) {
+            if (!result.empty()) {
+                result.push_back('/');
+            }
+            result += **it;
+        }
+        return result;
+    }
+
+    std::string PathDictionary::name(PathID id) const {
+        std::shared_lock lock(mutex_);
+        return nodes_.at(id).name_;
+    }
+
+    PathID PathDictionary::parent(PathID id) const {
+        std::shared_lock lock(mutex_);
+        return nodes_.at(id).parent_;
+    }
+
+    std::vector<PathID> PathDictionary::children(PathID id) const {
+        std::shared_lock lock(mutex_);
+        auto children = nodes_.at(id).children_;
+        std::sort(children.begin(), children.end(), [this](PathID a, PathID b) { return nodes_[a].name_ < nodes_[b].name_; });
+        return children;
+    }
+
+    void PathDictionary::for_each_descendant(PathID id, const std::function<void(PathID)>& visit) const {
+        std::shared_lock lock(mutex_);
+        if (id >= nodes_.size()) {
+            return;
+        }
+
+        std::vector<PathID> stack{id};
+        while (!stack.empty()) {
+            auto current = stack.back();
+            stack.pop_back();
+            visit(current);
+            const auto& children = nodes_[current].children_;
+            stack.insert(stack.end(), children.rbegin(), children.rend());
+        }
+    }
+
+    size_t PathDictionary::size() const {
+        std::shared_lock lock(mutex_);
+        return nodes_.size();
+    }
+
+    size_t PathDictionary::memory_usage() const {
+        std::shared_lock lock(mutex_);
+        //节点本身、子节点数组（每个非根节点恰在一个数组中）、索引项（键、值与桶链指针）与超出SSO的名称
+        return nodes_.size() * (sizeof(Node) + sizeof(PathID)) +
+               index_.size() * (sizeof(ChildKey) + sizeof(PathID) + 2 * sizeof(void*)) + index_.bucket_count() * sizeof(void*) +
+               name_bytes_;
+    }
+
+    std::optional<PathID> PathDictionary::find_child_locked(PathID parent, std::string_view name) const {
+        auto it = index_.find(ChildKey{parent, name});
+        return it != index_.end() ? std::optional<PathID>(it->second) : std::nullopt;
+    }
+
+    PathID PathDictionary::insert_child_locked(PathID parent, std::string_view name) {
+        if (parent >= nodes_.size()) {
+            throw std::out_of_range("PathDictionary: 父节点不存在");
+        }
+
+        auto id = static_cast<PathID>(nodes_.size());
+        auto& node = nodes_.emplace_back(Node{parent, std::string(name), {}});
+        nodes_[parent].children_.push_back(id);
+        index_.emplace(ChildKey{parent, node.name_}, id);
+        if (node.name_.size() > kShortNameLength) {
+            name_bytes_ += node.name_.capacity() + 1;
+        }
+        return id;
+    }
+
+}
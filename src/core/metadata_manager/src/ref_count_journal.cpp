@@ -0,0 +1,210 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/ref_count_journal.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+namespace RefStorage::Core {
+
+    namespace {
+
+        //记录布局：哈希长度(2) 目标(1) 增量(8) 哈希(变长) 校验和(8)
+        constexpr size_t kHeaderSize   = 11;
+        constexpr size_t kChecksumSize = 8;
+
+        constexpr std::string_view kPrefix = "refcount-";
+        constexpr std::string_view kSuffix = ".journal";
+
+        uint64_t checksum(const uint8_t* data, size_t size) {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ data[i]) * 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        bool sync_file(std::FILE* file) {
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+
+        //从文件名解析代数，不是日志文件时返回false
+        bool parse_epoch(const std::string& name, uint64_t& epoch) {
+            if (name.size() <= kPrefix.size() + kSuffix.size() || !name.starts_with(kPrefix) || !name.ends_with(kSuffix)) {
+                return false;
+            }
+            auto digits = name.substr(kPrefix.size(), name.size() - kPrefix.size() - kSuffix.size());
+            if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                return false;
+            }
+            epoch = std::stoull(digits);
+            return true;
+        }
+
+    }
+
+    RefCountJournal::~RefCountJournal() {
+        close();
+    }
+
+    Common::Result<bool> RefCountJournal::open(const std::filesystem::path& directory, bool sync) {
+        close();
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法创建引用数日志目录：" + directory.string());
+        }
+
+        existing_.clear();
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            uint64_t epoch = 0;
+            if (entry.is_regular_file() && parse_epoch(entry.path().filename().string(), epoch)) {
+                existing_.push_back(epoch);
+            }
+        }
+        if (error) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法读取引用数日志目录：" + directory.string());
+        }
+        std::sort(existing_.begin(), existing_.end());
+
+        directory_ = directory;
+        sync_      = sync;
+        epoch_     = 0;
+        return Common::Result<bool>::Success(true);
+    }
+
+    void RefCountJournal::close() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    std::filesystem::path RefCountJournal::path_of(uint64_t epoch) const {
+        return directory_ / (std::string(kPrefix) + std::to_string(epoch) + std::string(kSuffix));
+    }
+
+    Common::Result<bool> RefCountJournal::replay(uint64_t epoch, const std::function<void(const RefCountRecord&)>& apply) const {
+        auto path = path_of(epoch);
+        std::FILE* file = std::fopen(path.string().c_str(), "rb");
+        if (file == nullptr) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法打开引用数日志：" + path.string());
+        }
+
+        //遇到第一条不完整或校验失败的记录即停止（崩溃时写了一半的尾部）
+        std::vector<uint8_t> buffer;
+        uint8_t header[kHeaderSize];
+        while (std::fread(header, 1, kHeaderSize, file) == kHeaderSize) {
+            uint16_t hash_size = 0;
+            std::memcpy(&hash_size, header, 2);
+
+            buffer.assign(header, header + kHeaderSize);
+            buffer.resize(kHeaderSize + hash_size + kChecksumSize);
+            if (std::fread(buffer.data() + kHeaderSize, 1, hash_size + kChecksumSize, file) != hash_size + kChecksumSize) {
+                break;
+            }
+
+            uint64_t sum = 0;
+            std::memcpy(&sum, buffer.data() + kHeaderSize + hash_size, kChecksumSize);
+            if (sum != checksum(buffer.data(), kHeaderSize + hash_size)) {
+                break;
+            }
+
+            RefCountRecord record{};
+            record.target_ = buffer[2];
+            std::memcpy(&record.delta_, buffer.data() + 3, 8);
+            record.hash_.assign(reinterpret_cast<const char*>(buffer.data() + kHeaderSize), hash_size);
+            apply(record);
+        }
+
+        std::fclose(file);
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> RefCountJournal::start_epoch(uint64_t epoch) {
+        auto path = path_of(epoch);
+        std::FILE* file = std::fopen(path.string().c_str(), "ab");
+        if (file == nullptr) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法创建引用数日志：" + path.string());
+        }
+        //不经 stdio 缓冲：一批记录一次 write，写失败时也不会有残留在缓冲区里的字节
+        std::setvbuf(file, nullptr, _IONBF, 0);
+
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            existing_.push_back(epoch_);
+        }
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        file_  = file;
+        epoch_ = epoch;
+        size_  = error ? 0 : size;
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> RefCountJournal::encode(const RefCountRecord& record, std::vector<uint8_t>& out) {
+        if (record.hash_.size() > UINT16_MAX) {
+            return Common::Result<bool>::Error(Common::StatusCode::INVALID_ARGUMENT, "哈希过长，无法写入引用数日志");
+        }
+
+        auto hash_size = static_cast<uint16_t>(record.hash_.size());
+        auto begin     = out.size();
+        out.resize(begin + kHeaderSize + hash_size + kChecksumSize);
+        uint8_t* data = out.data() + begin;
+        std::memcpy(data, &hash_size, 2);
+        data[2] = record.target_;
+        std::memcpy(data + 3, &record.delta_, 8);
+        std::memcpy(data + kHeaderSize, record.hash_.data(), hash_size);
+        auto sum = checksum(data, kHeaderSize + hash_size);
+        std::memcpy(data + kHeaderSize + hash_size, &sum, kChecksumSize);
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> RefCountJournal::write(const std::vector<uint8_t>& records) {
+        if (file_ == nullptr) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "引用数日志未打开");
+        }
+
+        auto fail = [&](Common::StatusCode code, std::string message) {
+            //去掉可能已写入的部分记录：重放遇到不完整的记录会停止，其后的记录也会丢失
+            std::clearerr(file_);
+            std::error_code error;
+            std::filesystem::resize_file(path_of(epoch_), size_, error);
+            return Common::Result<bool>::Error(code, std::move(message) + path_of(epoch_).string());
+        };
+
+        if (std::fwrite(records.data(), 1, records.size(), file_) != records.size()) {
+            return fail(Common::StatusCode::STORAGE_FULL, "写入引用数日志失败：");
+        }
+        if (sync_ && !sync_file(file_)) {
+            return fail(Common::StatusCode::ERROR, "引用数日志同步失败：");
+        }
+        size_ += records.size();
+        return Common::Result<bool>::Success(true);
+    }
+
+    void RefCountJournal::remove_through(uint64_t epoch) {
+        std::erase_if(existing_, [&](uint64_t existing) {
+            if (existing > epoch) {
+                return false;
+            }
+            std::error_code error;
+            std::filesystem::remove(path_of(existing), error);
+            return !error;
+        });
+    }
+
+}
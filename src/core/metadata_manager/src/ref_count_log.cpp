@@ -0,0 +1,418 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/ref_count_log.hpp"
+#include <algorithm>
+#include <future>
+#include <utility>
+#include "metadata_repository.hpp"
+#include "sharded_metadata_store.hpp"
+#include "Log.hpp"
+
+
+namespace RefStorage::Core {
+
+    RefCountLog::RefCountLog(DataBase::ShardedMetadataStore& store, RefCountLogOptions options)
+        : store_(store)
+        , options_(options) {}
+
+    RefCountLog::~RefCountLog() {
+        stop();
+    }
+
+    Common::Result<bool> RefCountLog::open() {
+        if (options_.journal_directory_.empty()) {
+            return Common::Result<bool>::Success(true);
+        }
+
+        std::lock_guard checkpoint_lock(checkpoint_mutex_);
+        std::lock_guard journal_lock(journal_mutex_);
+
+        auto opened = journal_.open(options_.journal_directory_, options_.sync_journal_);
+        if (opened.failed()) {
+            return opened;
+        }
+
+        //各分库已写入的代数：代数不大于它的日志记录已包含在该分库的引用数中
+        std::vector<uint64_t> applied(store_.shard_count());
+        uint64_t latest = 0;
+        for (uint32_t shard = 0; shard < store_.shard_count(); ++shard) {
+            auto epoch = DataBase::MetadataRepository::load_ref_count_epoch(store_, shard);
+            if (epoch.failed()) {
+                return Common::Result<bool>::Error(epoch.status_code(), "读取引用数日志代数失败：" + epoch.message());
+            }
+            applied[shard] = epoch.value();
+            latest = std::max(latest, epoch.value());
+        }
+
+        //重放尚未写入的记录：并入增量表，下一次 checkpoint 写入（并推进代数），此前的日志文件保留到那时
+        size_t replayed = 0;
+        std::vector<bool> recovered(store_.shard_count(), false);
+        for (auto epoch : journal_.existing_epochs()) {
+            latest = std::max(latest, epoch);
+            auto result = journal_.replay(epoch, [&](const RefCountRecord& record) {
+                auto shard = store_.shard_of(record.hash_);
+                if (epoch <= applied[shard] || record.target_ > static_cast<uint8_t>(RefTarget::Chunk)) {
+                    return;
+                }
+                auto& stripe = stripe_for(record.hash_);
+                std::lock_guard lock(stripe.mutex_);
+                merge_locked(stripe, Key{static_cast<RefTarget>(record.target_), record.hash_}, record.delta_);
+                recovered[shard] = true;
+                ++replayed;
+            });
+            if (result.failed()) {
+                return result;
+            }
+        }
+
+        //没有待重放增量的分库已包含全部旧日志
+        durable_epochs_.assign(store_.shard_count(), latest);
+        for (uint32_t shard = 0; shard < store_.shard_count(); ++shard) {
+            if (recovered[shard]) {
+                durable_epochs_[shard] = applied[shard];
+            }
+        }
+
+        auto started = journal_.start_epoch(latest + 1);
+        if (started.failed()) {
+            return started;
+        }
+        journaled_ = true;
+        journal_.remove_through(*std::min_element(durable_epochs_.begin(), durable_epochs_.end()));
+
+        if (replayed > 0) {
+            LOG_WARN_FMT("引用数增量上次未完全写入，已从日志重放 {0} 条", replayed);
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    void RefCountLog::start() {
+        std::lock_guard lock(run_mutex_);
+        if (running_) {
+            return;
+        }
+        running_       = true;
+        worker_thread_ = std::thread(&RefCountLog::run, this);
+    }
+
+    void RefCountLog::stop() {
+        {
+            std::lock_guard lock(run_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        run_cv_.notify_all();
+        worker_thread_.join();
+
+        auto applied = checkpoint();
+        if (applied.failed()) {
+            LOG_WARN_FMT("停止时写入引用数增量失败：{0}", applied.message());
+        }
+    }
+
+    RefCountLog::Stripe& RefCountLog::stripe_for(const HashValue& hash) const {
+        return stripes_[std::hash<HashValue>{}(hash) % kStripes];
+    }
+
+    size_t RefCountLog::merge_locked(Stripe& stripe, const Key& key, int64_t delta) {
+        auto [it, inserted] = stripe.pending_.try_emplace(key, 0);
+        it->second += delta;
+        //一增一减相互抵消后不再需要写入
+        if (it->second == 0) {
+            stripe.pending_.erase(it);
+            if (!inserted) {
+                pending_count_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return 0;
+        }
+        if (!inserted) {
+            return 0;
+        }
+        return pending_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    Common::Result<bool> RefCountLog::add(RefTarget target, const HashValue& hash, int64_t delta) {
+        if (delta == 0) {
+            return Common::Result<bool>::Success(true);
+        }
+
+        if (journaled_) {
+            //加入当前批，再由先拿到日志锁的线程整批写入并合并；
+            //写入与合并都在日志锁内，checkpoint 轮换日志时换出的增量与旧文件中的记录一致
+            std::shared_ptr<JournalBatch> batch;
+            {
+                std::lock_guard lock(batch_mutex_);
+                auto encoded = RefCountJournal::encode(RefCountRecord{static_cast<uint8_t>(target), delta, hash}, open_batch_->data_);
+                if (encoded.failed()) {
+                    return encoded;
+                }
+                open_batch_->entries_.push_back(Applied{Key{target, hash}, delta});
+                batch = open_batch_;
+            }
+
+            std::lock_guard journal_lock(journal_mutex_);
+            if (!batch->done_) {
+                flush_journal_locked();
+            }
+            return batch->result_;
+        }
+
+        auto& stripe = stripe_for(hash);
+        size_t count = 0;
+        {
+            std::lock_guard lock(stripe.mutex_);
+            count = merge_locked(stripe, Key{target, hash}, delta);
+        }
+        appended_.fetch_add(1, std::memory_order_relaxed);
+
+        if (count == options_.max_pending_) {
+            request_apply();
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    void RefCountLog::flush_journal_locked() {
+        std::shared_ptr<JournalBatch> batch;
+        {
+            std::lock_guard lock(batch_mutex_);
+            if (open_batch_->entries_.empty()) {
+                return;
+            }
+            batch = std::exchange(open_batch_, std::make_shared<JournalBatch>());
+        }
+
+        batch->result_ = journal_.write(batch->data_);
+        batch->done_   = true;
+        journal_writes_.fetch_add(1, std::memory_order_relaxed);
+        if (batch->result_.failed()) {
+            return;
+        }
+
+        bool full = false;
+        for (const auto& entry : batch->entries_) {
+            auto& stripe = stripe_for(entry.key_.hash_);
+            std::lock_guard lock(stripe.mutex_);
+            full |= merge_locked(stripe, entry.key_, entry.delta_) == options_.max_pending_;
+        }
+        appended_.fetch_add(batch->entries_.size(), std::memory_order_relaxed);
+
+        if (full) {
+            request_apply();
+        }
+    }
+
+    void RefCountLog::request_apply() {
+        {
+            std::lock_guard lock(run_mutex_);
+            apply_requested_ = true;
+        }
+        run_cv_.notify_all();
+    }
+
+    int64_t RefCountLog::pending(RefTarget target, const HashValue& hash) const {
+        Key key{target, hash};
+        auto& stripe = stripe_for(hash);
+
+        std::lock_guard lock(stripe.mutex_);
+        int64_t delta = 0;
+        if (auto it = stripe.pending_.find(key); it != stripe.pending_.end()) {
+            delta += it->second;
+        }
+        if (auto it = stripe.in_flight_.find(key); it != stripe.in_flight_.end()) {
+            delta += it->second;
+        }
+        return delta;
+    }
+
+    Common::Result<uint64_t> RefCountLog::references(RefTarget target, const HashValue& hash) const {
+        Key key{target, hash};
+        auto& stripe = stripe_for(hash);
+
+        //该哈希的增量正在写入时，数据库中的值可能已经包含它：等写入结束再读。
+        //读取基准值时不持有条带锁（不阻塞同条带的 add）；读取期间条带的增量被换出写入过（代数变化）时，
+        //基准值可能已含其中一部分，重新读取
+        std::unique_lock lock(stripe.mutex_);
+        while (true) {
+            stripe.applied_cv_.wait(lock, [&] { return !stripe.in_flight_.contains(key); });
+            auto generation = stripe.generation_;
+            lock.unlock();
+
+            auto base = target == RefTarget::File ? DataBase::MetadataRepository::load_file_references(store_, hash)
+                                                  : DataBase::MetadataRepository::load_chunk_references(store_, hash);
+            if (base.failed()) {
+                return base;
+            }
+
+            lock.lock();
+            if (stripe.generation_ != generation) {
+                continue;
+            }
+
+            int64_t count = static_cast<int64_t>(base.value());
+            if (auto it = stripe.pending_.find(key); it != stripe.pending_.end()) {
+                count += it->second;
+            }
+            return Common::Result<uint64_t>::Success(static_cast<uint64_t>(std::max<int64_t>(count, 0)));
+        }
+    }
+
+    Common::Result<size_t> RefCountLog::checkpoint() {
+        std::lock_guard checkpoint_lock(checkpoint_mutex_);
+
+        //把各条带的增量整体换到“正在写入”，按分库分组。
+        //有日志时在日志锁内先写完当前批，再轮换到下一个代数：换出的增量恰好是不大于 epoch 的日志文件中尚未写入的部分
+        std::unique_lock<std::mutex> journal_lock;
+        uint64_t epoch = 0;
+        if (journaled_) {
+            journal_lock = std::unique_lock(journal_mutex_);
+            flush_journal_locked();
+            if (pending_count_.load(std::memory_order_relaxed) == 0) {
+                return Common::Result<size_t>::Success(0);
+            }
+            epoch = journal_.current_epoch();
+            auto rotated = journal_.start_epoch(epoch + 1);
+            if (rotated.failed()) {
+                return Common::Result<size_t>::Error(rotated);
+            }
+        }
+
+        std::vector<std::vector<Applied>> writes(store_.shard_count());
+        size_t total = 0;
+        for (auto& stripe : stripes_) {
+            DeltaMap taken;
+            {
+                std::lock_guard lock(stripe.mutex_);
+                if (stripe.pending_.empty()) {
+                    continue;
+                }
+                taken.swap(stripe.pending_);
+                stripe.in_flight_ = taken;
+                ++stripe.generation_;
+                pending_count_.fetch_sub(taken.size(), std::memory_order_relaxed);
+            }
+            total += taken.size();
+            for (auto& [key, delta] : taken) {
+                auto shard = store_.shard_of(key.hash_);
+                writes[shard].push_back(Applied{key, delta});
+            }
+        }
+        if (journal_lock.owns_lock()) {
+            journal_lock.unlock();
+        }
+        if (total == 0) {
+            return Common::Result<size_t>::Success(0);
+        }
+
+        auto now = std::chrono::system_clock::now();
+        std::vector<std::pair<uint32_t, std::future<Common::Result<bool>>>> futures;
+        for (uint32_t shard = 0; shard < writes.size(); ++shard) {
+            if (writes[shard].empty()) {
+                continue;
+            }
+            //增量与日志代数在同一事务中写入，重放时据此跳过已写入的记录
+            futures.emplace_back(shard, store_.submit_to(shard, [entries = &writes[shard], now, epoch](DataBase::DatabaseConnector& connector) {
+                for (const auto& entry : *entries) {
+                    auto result = entry.key_.target_ == RefTarget::File
+                        ? DataBase::MetadataRepository::adjust_file_references(connector, entry.key_.hash_, entry.delta_)
+                        : DataBase::MetadataRepository::adjust_chunk_references(connector, entry.key_.hash_, entry.delta_, now);
+                    if (result.failed()) {
+                        return result;
+                    }
+                }
+                if (epoch > 0) {
+                    return DataBase::MetadataRepository::save_ref_count_epoch(connector, epoch);
+                }
+                return Common::Result<bool>::Success(true);
+            }));
+        }
+
+        auto   result  = Common::Result<size_t>::Success(0);
+        size_t written = 0;
+        for (auto& [shard, future] : futures) {
+            auto shard_result = future.get();
+            settle(writes[shard], shard_result.success());
+            if (shard_result.failed()) {
+                if (result.success()) {
+                    result = Common::Result<size_t>::Error(shard_result);
+                }
+                continue;
+            }
+            written += writes[shard].size();
+            if (journaled_) {
+                durable_epochs_[shard] = epoch;
+            }
+            if (listener_) {
+                for (const auto& entry : writes[shard]) {
+                    listener_(entry.key_.target_, entry.key_.hash_, entry.delta_);
+                }
+            }
+        }
+        applied_rows_.fetch_add(written, std::memory_order_relaxed);
+
+        //本次没有增量的分库也已包含到 epoch 为止的全部记录（失败并回的增量总会进入下一次换出）
+        if (journaled_) {
+            for (uint32_t shard = 0; shard < writes.size(); ++shard) {
+                if (writes[shard].empty()) {
+                    durable_epochs_[shard] = epoch;
+                }
+            }
+            std::lock_guard lock(journal_mutex_);
+            journal_.remove_through(*std::min_element(durable_epochs_.begin(), durable_epochs_.end()));
+        }
+
+        if (result.failed()) {
+            return result;
+        }
+        LOG_DEBUG_FMT("引用数增量写入完成：{0} 行", written);
+        return Common::Result<size_t>::Success(written);
+    }
+
+    void RefCountLog::settle(const std::vector<Applied>& entries, bool applied) {
+        //按条带分批处理，每个条带只加锁一次
+        std::array<std::vector<const Applied*>, kStripes> by_stripe;
+        for (const auto& entry : entries) {
+            by_stripe[&stripe_for(entry.key_.hash_) - stripes_.data()].push_back(&entry);
+        }
+
+        for (size_t i = 0; i < kStripes; ++i) {
+            if (by_stripe[i].empty()) {
+                continue;
+            }
+            auto& stripe = stripes_[i];
+            {
+                std::lock_guard lock(stripe.mutex_);
+                for (const auto* entry : by_stripe[i]) {
+                    stripe.in_flight_.erase(entry->key_);
+                    if (applied) {
+                        continue;
+                    }
+                    //写入失败：并回增量表，期间新追加的增量与之合并
+                    merge_locked(stripe, entry->key_, entry->delta_);
+                }
+            }
+            stripe.applied_cv_.notify_all();
+        }
+    }
+
+    void RefCountLog::run() {
+        std::unique_lock lock(run_mutex_);
+        while (running_) {
+            run_cv_.wait_for(lock, options_.apply_interval_, [this] { return !running_ || apply_requested_; });
+            if (!running_) {
+                break;
+            }
+            apply_requested_ = false;
+
+            lock.unlock();
+            auto applied = checkpoint();
+            if (applied.failed()) {
+                LOG_WARN_FMT("写入引用数增量失败，下个周期重试：{0}", applied.message());
+            }
+            lock.lock();
+        }
+    }
+
+}
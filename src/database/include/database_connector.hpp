@@ -6,8 +6,10 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.hpp"
+#include "sql_profiler.hpp"
 
 
 // SQLite3前向声明
@@ -23,6 +25,10 @@ namespace RefStorage::DataBase {
 
     class DatabaseConnector {
     public:
+        //参数绑定、逐行读取回调
+        using StatementBinder = std::function<void(sqlite3_stmt*)>;
+        using RowCallback     = std::function<void(sqlite3_stmt*)>;
+
         explicit DatabaseConnector(const std::string& database_path = ":memory:");
         ~DatabaseConnector();
 
@@ -63,13 +69,36 @@ namespace RefStorage::DataBase {
         //准备预处理数据
         Common::Result<std::unique_ptr<sqlite3_stmt, void(*)(sqlite3_stmt*)>> prepare_statement(const std::string& sql);
 
+        //执行带参数的语句，预处理语句按SQL文本缓存复用；每返回一行调用一次row_callback
+        //（row_callback 中不得再执行同一条SQL）
+        Common::Result<bool> execute_statement(const std::string& sql,
+                                               const StatementBinder& binder,
+                                               const RowCallback& row_callback = nullptr);
+
+        //删除数据库文件及其 -wal / -shm 文件（文件不存在时忽略，调用前须关闭所有连接）
+        static void remove_database_files(const std::filesystem::path& path);
+
+        //底层SQLite句柄（注册自定义函数、在线备份等）
+        sqlite3* native_handle() const { return database_; }
+
+        //挂载SQL性能分析器（可多个连接共享同一个），传入nullptr关闭
+        void set_profiler(std::shared_ptr<SqlProfiler> profiler);
+        std::shared_ptr<SqlProfiler> profiler() const { return profiler_; }
+
     private:
         void handle_sqlite_error(int error_code, const std::string& operation);
 
+        //释放缓存的预处理语句
+        void clear_statement_cache();
+
         sqlite3*    database_;
         std::string database_path_;
         bool        in_transaction_;
 
+        std::shared_ptr<SqlProfiler> profiler_;
+
+        std::unordered_map<std::string, sqlite3_stmt*> statement_cache_;
+
     };
 
 }
@@ -0,0 +1,58 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include "common/metadata_arena.hpp"
+#include "sharded_metadata_store.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    //批量写入的元数据：文件与分片对象及其字符串、数组全部从批次内存池分配，
+    //提交时按分库分组，每个分库只提交一个变更（同一事务），全部持久化后一次性释放内存池。
+    //每个写入线程使用自己的批次，非线程安全。
+    class MetadataBatch {
+    public:
+        using FileList  = std::pmr::deque<Common::ArenaFileMataData>;
+        using ChunkList = std::pmr::deque<Common::ArenaChunkInfo>;
+
+        explicit MetadataBatch(size_t initial_arena_size = Common::MetadataArena::kDefaultInitialSize);
+
+        MetadataBatch(const MetadataBatch&) = delete;
+        MetadataBatch& operator=(const MetadataBatch&) = delete;
+
+        //新增文件/分片，返回的引用在提交或清空前有效
+        Common::ArenaFileMataData& add_file() { return files_->emplace_back(); }
+        Common::ArenaFileMataData& add_file(const Common::FileMataData& file) { return files_->emplace_back(file); }
+        Common::ArenaChunkInfo& add_chunk() { return chunks_->emplace_back(); }
+        Common::ArenaChunkInfo& add_chunk(const Common::ChunkInfo& chunk) { return chunks_->emplace_back(chunk); }
+
+        [[nodiscard]] size_t file_count() const { return files_->size(); }
+        [[nodiscard]] size_t chunk_count() const { return chunks_->size(); }
+        [[nodiscard]] bool empty() const { return files_->empty() && chunks_->empty(); }
+
+        [[nodiscard]] const FileList& files() const { return *files_; }
+        [[nodiscard]] const ChunkList& chunks() const { return *chunks_; }
+        [[nodiscard]] Common::MetadataArena& arena() { return arena_; }
+
+        //写入全部文件与分片并等待持久化，之后清空批次（无论成功与否）。
+        //同一分库的变更在一个SAVEPOINT中执行，其中任一条失败则该分库的整组回滚，返回第一个错误
+        Common::Result<bool> commit(ShardedMetadataStore& store);
+
+        //丢弃批次内容并释放内存池
+        void clear();
+
+    private:
+        //按分库分组提交并等待全部完成（分组数组也在内存池中，须在重置内存池前析构）
+        Common::Result<bool> write_all(ShardedMetadataStore& store);
+
+        Common::MetadataArena     arena_;
+        //deque 构造时即从内存池分配，重置内存池前须先析构，故用 optional 持有
+        std::optional<FileList>   files_;
+        std::optional<ChunkList>  chunks_;
+    };
+
+}
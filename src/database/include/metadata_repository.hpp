@@ -0,0 +1,87 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <vector>
+#include "common/metadata_arena.hpp"
+#include "database_connector.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    class ShardedMetadataStore;
+
+    //垃圾回收候选（引用数为0的分片）
+    struct GcCandidate {
+        HashValue hash_;
+        FileSize  size_;
+        int64_t   updated_at_;                                                  //引用数最后变化或分片重新写入的时间（毫秒）
+    };
+
+    //垃圾回收进度检查点（每个分库一行）
+    struct GcProgress {
+        int64_t   cursor_time_;                                                 //本轮已处理到的候选 (updated_at, hash)
+        HashValue cursor_hash_;
+        uint64_t  passes_;
+        uint64_t  reclaimed_chunks_;
+        uint64_t  reclaimed_bytes_;
+    };
+
+    //元数据表与 FileMataData / ChunkInfo 之间的读写映射
+    //写入函数在 MetadataWriter 的批量事务中调用；批量读取按分库分散-聚合
+    class MetadataRepository {
+    public:
+        //时间点与毫秒时间戳互转（表中时间字段统一为Unix毫秒）
+        static int64_t to_millis(const TimePoint& time_point);
+        static TimePoint from_millis(int64_t millis);
+
+        //写入文件元数据及其分片列表（已存在则覆盖，引用数除外），并回填 file_id_ 与数据库中的 reference_count_
+        static Common::Result<bool> save_file(DatabaseConnector& connector, Common::FileMataData& file);
+        static Common::Result<bool> save_file(DatabaseConnector& connector, Common::ArenaFileMataData& file);
+
+        //把文件的最近访问时间推进到 access_time（不会回退）
+        static Common::Result<bool> touch_file(DatabaseConnector& connector, const HashValue& hash, const TimePoint& access_time);
+
+        //删除文件元数据及其分片列表
+        static Common::Result<bool> remove_file(DatabaseConnector& connector, const HashValue& hash);
+
+        //写入分片信息及副本位置；新分片的引用数为1，已存在的分片保留原引用数，
+        //updated_at 推进到当前时间（重新写入的分片重新计算宽限期，已选出的回收候选不再匹配）
+        static Common::Result<bool> save_chunk(DatabaseConnector& connector, const Common::ChunkInfo& chunk);
+        static Common::Result<bool> save_chunk(DatabaseConnector& connector, const Common::ArenaChunkInfo& chunk);
+
+        //按增量调整引用数（结果不小于0）；分片同时把 updated_at 推进到 time（引用数最后变化时间）
+        static Common::Result<bool> adjust_file_references(DatabaseConnector& connector, const HashValue& hash, int64_t delta);
+        static Common::Result<bool> adjust_chunk_references(DatabaseConnector& connector, const HashValue& hash, int64_t delta,
+                                                            const TimePoint& time);
+
+        //读取引用数，记录不存在时为0
+        static Common::Result<uint64_t> load_file_references(ShardedMetadataStore& store, const HashValue& hash);
+        static Common::Result<uint64_t> load_chunk_references(ShardedMetadataStore& store, const HashValue& hash);
+
+        //删除分片信息及副本位置
+        static Common::Result<bool> remove_chunk(DatabaseConnector& connector, const HashValue& hash);
+
+        //从部分索引 idx_chunks_unreferenced 按 (updated_at, hash) 顺序读取游标之后、引用数为0且在 cutoff 之前变为0的分片
+        static Common::Result<std::vector<GcCandidate>> load_gc_candidates(ShardedMetadataStore& store, uint32_t shard,
+                                                                           const TimePoint& cutoff, int64_t after_time,
+                                                                           const HashValue& after_hash, size_t limit);
+        //删除仍未被引用、且引用数自选出后未再变化的分片（含副本位置），返回是否删除
+        static Common::Result<bool> remove_unreferenced_chunk(DatabaseConnector& connector, const GcCandidate& candidate);
+
+        //读取/写入分库的垃圾回收进度
+        static Common::Result<GcProgress> load_gc_progress(ShardedMetadataStore& store, uint32_t shard);
+        static Common::Result<bool> save_gc_progress(DatabaseConnector& connector, const GcProgress& progress);
+
+        //读取/写入分库已合并的引用数增量日志代数
+        static Common::Result<uint64_t> load_ref_count_epoch(ShardedMetadataStore& store, uint32_t shard);
+        static Common::Result<bool> save_ref_count_epoch(DatabaseConnector& connector, uint64_t epoch);
+
+        //从所有分库读取全部分片（含副本位置）
+        static Common::Result<std::vector<Common::ChunkInfo>> load_all_chunks(ShardedMetadataStore& store);
+
+        //从所有分库读取全部文件；分片列表只填充哈希、大小与序号，完整分片信息由调用方按哈希补全
+        static Common::Result<std::vector<Common::FileMataData>> load_all_files(ShardedMetadataStore& store);
+    };
+
+}
@@ -0,0 +1,69 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <string>
+#include "common/common_types.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    //快照配置
+    struct SnapshotOptions {
+        int                       pages_per_step_ = 256;                        //每步复制的页数
+        std::chrono::milliseconds step_pause_     = std::chrono::milliseconds(5); //两步之间的停顿，让出磁盘与锁
+        bool                      verify_         = true;                       //完成后校验快照
+    };
+
+    //快照进度
+    struct SnapshotProgress {
+        int total_pages_;
+        int remaining_pages_;
+
+        [[nodiscard]] double ratio() const {
+            return total_pages_ > 0 ? static_cast<double>(total_pages_ - remaining_pages_) / total_pages_ : 1.0;
+        }
+    };
+
+    //进度回调，返回false取消
+    using SnapshotProgressCallback = std::function<bool(const SnapshotProgress&)>;
+
+    //基于 sqlite3_backup_step 的在线增量快照：
+    //每步只复制有限页数并在步间停顿，不会长时间占用源库。源库为WAL模式时，快照连接在整个
+    //过程中持有一个读事务，得到的是开始时刻的一致视图，写入方不受阻塞，快照也不会因写入而重新开始。
+    class MetadataSnapshot {
+    public:
+        //对数据库文件做快照，先写入 <snapshot_path>.partial，完成并校验后再改名
+        static Common::Result<bool> create(const std::filesystem::path& source_path,
+                                           const std::filesystem::path& snapshot_path,
+                                           const SnapshotOptions& options = {},
+                                           const SnapshotProgressCallback& progress = nullptr);
+
+        //在后台线程中做快照
+        static std::future<Common::Result<bool>> create_async(std::filesystem::path source_path,
+                                                              std::filesystem::path snapshot_path,
+                                                              SnapshotOptions options = {},
+                                                              SnapshotProgressCallback progress = nullptr);
+
+        //对分库存储的每个分库依次做快照（各分库的快照时刻不同）
+        static Common::Result<bool> create_sharded(const std::filesystem::path& store_directory,
+                                                   uint32_t shard_count,
+                                                   const std::filesystem::path& snapshot_directory,
+                                                   const SnapshotOptions& options = {},
+                                                   const SnapshotProgressCallback& progress = nullptr);
+
+        //校验快照：完整性检查通过且表结构版本不高于程序支持的版本
+        static Common::Result<bool> verify(const std::filesystem::path& snapshot_path);
+
+        //从快照恢复（目标库上不能有打开的连接）：先恢复到临时文件，校验内容与快照一致后替换目标库
+        static Common::Result<bool> restore(const std::filesystem::path& snapshot_path,
+                                            const std::filesystem::path& target_path,
+                                            const SnapshotOptions& options = {},
+                                            const SnapshotProgressCallback& progress = nullptr);
+    };
+
+}
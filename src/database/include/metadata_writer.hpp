@@ -0,0 +1,96 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "database_connector.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    //后台写入线程配置
+    struct MetadataWriterOptions {
+        size_t                    max_batch_size_  = 256;                        //单个事务最多合并的变更数
+        std::chrono::microseconds max_batch_delay_ = std::chrono::microseconds(2000); //合并窗口（自第一条变更入队起计）
+        size_t                    max_queue_size_  = 65536;                      //队列上限，队列满时提交方阻塞
+        bool                      enable_wal_      = true;                       //启用WAL，提交时读者不被阻塞
+    };
+
+    //元数据组提交写入器：
+    //多个线程提交的变更经队列交给唯一的后台线程，按时间/数量窗口合并到同一个事务中提交，
+    //一次提交（一次fsync）即可让整批变更持久化。每条变更在独立的SAVEPOINT中执行，
+    //单条失败只回滚自身，不影响同批其他变更。
+    class MetadataWriter {
+    public:
+        //变更在后台线程中以独占方式访问连接，不得自行开启/提交事务
+        using Mutation = std::function<Common::Result<bool>(DatabaseConnector&)>;
+
+        struct Stats {
+            uint64_t committed_batches_;                                         //已提交的事务数
+            uint64_t committed_mutations_;                                       //已持久化的变更数
+            uint64_t failed_mutations_;                                          //失败的变更数
+            size_t   queue_size_;                                                //当前排队数
+        };
+
+        explicit MetadataWriter(const std::string& database_path, MetadataWriterOptions options = {});
+        ~MetadataWriter();
+
+        //禁止复制、移动（后台线程持有this）
+        MetadataWriter(const MetadataWriter&) = delete;
+        MetadataWriter& operator=(const MetadataWriter&) = delete;
+
+        //提交变更，所在批次持久化（或失败）后future就绪
+        std::future<Common::Result<bool>> submit(Mutation mutation);
+
+        //提交变更并等待其所在批次持久化
+        Common::Result<bool> execute(Mutation mutation);
+
+        //等待当前已入队的变更全部处理完毕
+        void flush();
+
+        //处理完剩余变更后停止后台线程，之后的submit直接返回错误
+        void stop();
+
+        [[nodiscard]] bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+        [[nodiscard]] Stats stats() const;
+
+    private:
+        struct Pending {
+            Mutation                           mutation_;
+            std::promise<Common::Result<bool>> promise_;
+        };
+
+        //后台线程主循环
+        void run();
+
+        //将一批变更合并到一个事务中执行并提交
+        void commit_batch(std::deque<Pending>& batch);
+
+        DatabaseConnector        connector_;
+        MetadataWriterOptions    options_;
+
+        mutable std::mutex       queue_mutex_;
+        std::condition_variable  queue_cv_;                                     //通知后台线程有新变更
+        std::condition_variable  space_cv_;                                     //通知提交方队列有空位
+        std::condition_variable  idle_cv_;                                      //通知flush队列已处理完
+        std::deque<Pending>      queue_;
+        size_t                   in_flight_ = 0;                                //后台线程正在处理的变更数
+
+        std::atomic<bool>        running_{ false };
+        std::atomic<uint64_t>    committed_batches_{ 0 };
+        std::atomic<uint64_t>    committed_mutations_{ 0 };
+        std::atomic<uint64_t>    failed_mutations_{ 0 };
+
+        std::thread              worker_thread_;
+    };
+
+}
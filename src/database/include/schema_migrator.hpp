@@ -0,0 +1,43 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <vector>
+#include "database_connector.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    //单个版本迁移
+    struct Migration {
+        int         version_;                                                   //迁移完成后的版本号（从1开始连续递增）
+        const char* description_;                                               //迁移文件名（scripts/migrations 下，不含扩展名）
+        const char* sql_;
+    };
+
+    //元数据库表结构迁移器：
+    //版本号记录在 PRAGMA user_version 中，每个迁移与版本号更新在同一个事务内执行，
+    //迁移中途失败时数据库保持在上一个版本。
+    class SchemaMigrator {
+    public:
+        explicit SchemaMigrator(DatabaseConnector& connector);
+
+        //读取数据库当前表结构版本（新建数据库为0）
+        Common::Result<int> current_version();
+
+        //依次执行所有未应用的迁移，直到 target_version（默认最新版本），返回迁移后的版本
+        Common::Result<int> migrate(int target_version = latest_version());
+
+        //程序内置的全部迁移
+        static const std::vector<Migration>& migrations();
+
+        //程序支持的最新表结构版本
+        static int latest_version();
+
+    private:
+        Common::Result<bool> apply(const Migration& migration);
+
+        DatabaseConnector& connector_;
+    };
+
+}
@@ -0,0 +1,193 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "database_connector.hpp"
+#include "metadata_writer.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    //分库配置
+    struct ShardedStoreOptions {
+        std::filesystem::path directory_;                                       //分库文件所在目录
+        uint32_t              shard_count_ = 4;                                 //分库数量
+        MetadataWriterOptions writer_options_;                                  //每个分库写入线程的配置
+    };
+
+    //按哈希前缀分库的元数据存储：
+    //N个SQLite数据库按哈希前32位的取值区间划分（分库i负责 [i*2^32/N, (i+1)*2^32/N)），
+    //每个分库有独立的组提交写入线程和只读连接，写入吞吐随分库数近似线性增长。
+    //文件及其分片列表按文件哈希路由，分片与副本位置按分片哈希路由，储存节点等全局表放在 kGlobalShard。
+    class ShardedMetadataStore {
+    public:
+        using Reader = std::function<Common::Result<bool>(DatabaseConnector&)>;
+
+        //全局表（storage_nodes）所在分库
+        static constexpr uint32_t kGlobalShard = 0;
+
+        explicit ShardedMetadataStore(ShardedStoreOptions options);
+        ~ShardedMetadataStore();
+
+        ShardedMetadataStore(const ShardedMetadataStore&) = delete;
+        ShardedMetadataStore& operator=(const ShardedMetadataStore&) = delete;
+
+        //打开（必要时创建并迁移）全部分库
+        Common::Result<bool> open();
+        //等待未完成的写入后关闭
+        void close();
+        [[nodiscard]] bool is_open() const { return !shards_.empty(); }
+
+        [[nodiscard]] uint32_t shard_count() const { return options_.shard_count_; }
+        [[nodiscard]] uint32_t shard_of(std::string_view hash) const { return shard_of(hash, options_.shard_count_); }
+        [[nodiscard]] const std::filesystem::path& directory() const { return options_.directory_; }
+
+        //哈希所属分库
+        static uint32_t shard_of(std::string_view hash, uint32_t shard_count);
+        //哈希前缀（十六进制哈希取前8位，其他哈希取其 FNV-1a 散列值，与平台无关）
+        static uint32_t hash_prefix(std::string_view hash);
+        //分库文件路径
+        static std::filesystem::path shard_path(const std::filesystem::path& directory, uint32_t index, uint32_t shard_count);
+
+        //写入：按哈希路由到对应分库的写入线程
+        std::future<Common::Result<bool>> submit(const HashValue& key, MetadataWriter::Mutation mutation);
+        std::future<Common::Result<bool>> submit_to(uint32_t shard, MetadataWriter::Mutation mutation);
+        //在所有分库上执行同一变更
+        std::vector<std::future<Common::Result<bool>>> broadcast(const MetadataWriter::Mutation& mutation);
+        //等待所有分库已入队的变更持久化
+        void flush();
+
+        //读取：在指定分库的只读连接上执行
+        Common::Result<bool> read(uint32_t shard, const Reader& reader);
+
+        //按哈希路由的查询
+        template <typename T>
+        Common::Result<std::vector<T>> query(const HashValue& key,
+                                             const std::string& sql,
+                                             const DatabaseConnector::StatementBinder& binder,
+                                             const std::function<T(sqlite3_stmt*)>& row_mapper);
+
+        //分散-聚合查询：在所有分库上并行执行（调用线程与固定的查询线程池分担），结果按分库顺序拼接
+        template <typename T>
+        Common::Result<std::vector<T>> query_all(const std::string& sql,
+                                                 const DatabaseConnector::StatementBinder& binder,
+                                                 const std::function<T(sqlite3_stmt*)>& row_mapper);
+
+        //离线重新切分：把 old_count 个分库的数据按新的分库数重新分布（需在存储关闭时执行）。
+        //文件ID在分库内分配，切分后会重新编号；稳定的标识是哈希。
+        static Common::Result<bool> reshard(const std::filesystem::path& directory, uint32_t old_count, uint32_t new_count);
+
+    private:
+        struct Shard {
+            std::unique_ptr<MetadataWriter>    writer_;
+            std::unique_ptr<DatabaseConnector> reader_;
+            std::mutex                         reader_mutex_;
+        };
+
+        template <typename T>
+        Common::Result<std::vector<T>> query_shard(uint32_t shard,
+                                                   const std::string& sql,
+                                                   const DatabaseConnector::StatementBinder& binder,
+                                                   const std::function<T(sqlite3_stmt*)>& row_mapper);
+
+        //查询线程池：open 时启动 min(分库数 - 1, CPU数) 个线程，query_all 把分库查询投递到这里
+        void start_query_workers();
+        void stop_query_workers();
+        void post_query(std::function<void()> task);
+        void query_worker();
+
+        //把一个旧分库中属于新分库 target_index 的数据复制到 target
+        static Common::Result<bool> copy_shard_rows(DatabaseConnector& target,
+                                                    const std::filesystem::path& source_path,
+                                                    bool copy_global_tables,
+                                                    uint32_t target_index,
+                                                    uint32_t target_count);
+
+        ShardedStoreOptions                 options_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        std::mutex                          query_mutex_;
+        std::condition_variable             query_cv_;
+        std::deque<std::function<void()>>   query_tasks_;
+        bool                                query_stopping_ = false;
+        std::vector<std::thread>            query_workers_;
+    };
+
+    template <typename T>
+    Common::Result<std::vector<T>> ShardedMetadataStore::query(const HashValue& key,
+                                                               const std::string& sql,
+                                                               const DatabaseConnector::StatementBinder& binder,
+                                                               const std::function<T(sqlite3_stmt*)>& row_mapper) {
+        return query_shard<T>(shard_of(key), sql, binder, row_mapper);
+    }
+
+    template <typename T>
+    Common::Result<std::vector<T>> ShardedMetadataStore::query_all(const std::string& sql,
+                                                                   const DatabaseConnector::StatementBinder& binder,
+                                                                   const std::function<T(sqlite3_stmt*)>& row_mapper) {
+        using Partial = Common::Result<std::vector<T>>;
+
+        //分库1..N-1投递到查询线程池，分库0在调用线程上执行；
+        //等待全部完成后再返回，任务引用的 sql / binder / row_mapper 在此期间有效
+        std::vector<std::future<Partial>> partials;
+        partials.reserve(shards_.size());
+        for (uint32_t i = 1; i < shards_.size(); ++i) {
+            auto task = std::make_shared<std::packaged_task<Partial()>>([this, i, &sql, &binder, &row_mapper] {
+                return query_shard<T>(i, sql, binder, row_mapper);
+            });
+            partials.push_back(task->get_future());
+            post_query([task] { (*task)(); });
+        }
+
+        auto first = query_shard<T>(0, sql, binder, row_mapper);
+        std::vector<Partial> results;
+        results.reserve(shards_.size());
+        results.push_back(std::move(first));
+        for (auto& partial : partials) {
+            results.push_back(partial.get());
+        }
+
+        std::vector<T> rows;
+        for (auto& result : results) {
+            if (result.failed()) {
+                return result;
+            }
+            rows.insert(rows.end(), std::make_move_iterator(result.value().begin()), std::make_move_iterator(result.value().end()));
+        }
+
+        return Common::Result<std::vector<T>>::Success(std::move(rows));
+    }
+
+    template <typename T>
+    Common::Result<std::vector<T>> ShardedMetadataStore::query_shard(uint32_t shard,
+                                                                     const std::string& sql,
+                                                                     const DatabaseConnector::StatementBinder& binder,
+                                                                     const std::function<T(sqlite3_stmt*)>& row_mapper) {
+        if (shard >= shards_.size()) {
+            return Common::Result<std::vector<T>>::Error(Common::StatusCode::DATABASE_ERROR, "分库未打开");
+        }
+
+        std::vector<T> rows;
+        auto result = read(shard, [&](DatabaseConnector& connector) {
+            return connector.execute_statement(sql, binder, [&](sqlite3_stmt* stmt) {
+                rows.push_back(row_mapper(stmt));
+            });
+        });
+
+        if (result.failed()) {
+            return Common::Result<std::vector<T>>::Error(result);
+        }
+
+        return Common::Result<std::vector<T>>::Success(std::move(rows));
+    }
+
+}
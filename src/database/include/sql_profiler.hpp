@@ -0,0 +1,97 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// SQLite3前向声明
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace RefStorage::DataBase {
+
+    //SQL性能分析配置
+    struct SqlProfilerOptions {
+        std::chrono::microseconds slow_query_threshold_ = std::chrono::milliseconds(100); //慢查询阈值，0表示不记录慢查询
+        bool                      count_rows_           = true;                          //统计返回行数（每行触发一次回调）
+    };
+
+    //单条（归一化后）SQL语句的统计
+    struct StatementProfile {
+        //延迟直方图：第0桶为 <1µs，第i桶为 [2^(i-1), 2^i) µs，最后一桶收纳更慢的执行
+        static constexpr size_t kBucketCount = 24;
+
+        std::string                          sql_;                              //归一化SQL（字面量替换为?）
+        uint64_t                             calls_     = 0;
+        uint64_t                             rows_      = 0;
+        uint64_t                             vm_steps_  = 0;
+        uint64_t                             total_ns_  = 0;
+        uint64_t                             max_ns_    = 0;
+        std::array<uint64_t, kBucketCount>   histogram_{};
+
+        //按直方图估算分位延迟（返回所在桶的上界，纳秒）
+        [[nodiscard]] uint64_t percentile_ns(double percentile) const;
+    };
+
+    //基于 sqlite3_trace_v2 的SQL性能分析器：
+    //按归一化语句聚合延迟直方图、返回行数与虚拟机步数，超过阈值的执行记入慢查询日志。
+    //可同时挂到多个连接上（如分库后的各个连接），统计合并在一起。
+    class SqlProfiler {
+    public:
+        explicit SqlProfiler(SqlProfilerOptions options = {});
+
+        SqlProfiler(const SqlProfiler&) = delete;
+        SqlProfiler& operator=(const SqlProfiler&) = delete;
+
+        //挂载/卸载到连接上（由 DatabaseConnector 调用）
+        void attach(sqlite3* database);
+        static void detach(sqlite3* database);
+
+        //当前统计快照，按总耗时降序；不含尚未执行完一次的语句
+        [[nodiscard]] std::vector<StatementProfile> snapshot() const;
+
+        //文本报告
+        [[nodiscard]] std::string dump(size_t max_statements = 50) const;
+
+        //清空统计
+        void reset();
+
+        void set_slow_query_threshold(std::chrono::microseconds threshold);
+
+        //SQL归一化：合并空白，字符串与数字字面量替换为?
+        static std::string normalize(std::string_view sql);
+
+    private:
+        static int trace_callback(unsigned type, void* context, void* p, void* x);
+
+        //每个预编译语句的状态：第一次见到时归一化并缓存对应的统计项，之后的执行不再处理SQL文本；
+        //保存原始SQL用于识别语句释放后地址被新语句复用的情况
+        struct StatementState {
+            std::string                           raw_sql_;
+            StatementProfile*                     profile_ = nullptr;
+            std::chrono::steady_clock::time_point start_;                    //本次执行的开始时间
+            uint64_t                              rows_ = 0;
+        };
+
+        void on_statement(sqlite3_stmt* stmt);
+        void on_row(sqlite3_stmt* stmt);
+        void on_profile(sqlite3_stmt* stmt, uint64_t sqlite_elapsed_ns);
+
+        //取语句状态，SQL文本变化时重新归一化（调用方持有 mutex_）
+        StatementState& state_for(sqlite3_stmt* stmt);
+
+        SqlProfilerOptions                                 options_;
+        mutable std::mutex                                 mutex_;
+        std::unordered_map<std::string, StatementProfile>  statements_;
+        std::unordered_map<sqlite3_stmt*, StatementState>  states_;   //profile_ 指向 statements_ 的节点，reset 时一起清空
+    };
+
+}
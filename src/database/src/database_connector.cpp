@@ -24,7 +24,9 @@ namespace RefStorage::DataBase {
     DatabaseConnector::DatabaseConnector(DatabaseConnector &&other) noexcept
         : database_(other.database_)
         , database_path_(std::move(other.database_path_))
-        , in_transaction_(other.in_transaction_) {
+        , in_transaction_(other.in_transaction_)
+        , profiler_(std::move(other.profiler_))
+        , statement_cache_(std::move(other.statement_cache_)) {
         other.database_       = nullptr;
         other.in_transaction_ = false;
     }
@@ -35,6 +37,8 @@ namespace RefStorage::DataBase {
             database_             = other.database_;
             database_path_        = std::move(other.database_path_);
             in_transaction_       = other.in_transaction_;
+            profiler_             = std::move(other.profiler_);
+            statement_cache_      = std::move(other.statement_cache_);
             other.database_       = nullptr;
             other.in_transaction_ = false;
         }
@@ -63,7 +67,11 @@ namespace RefStorage::DataBase {
 
         sqlite3_busy_timeout(database_, 5000);
 
-        LOG_INFO_FMT("已连接到数据库：{1}", database_path_);
+        if (profiler_) {
+            profiler_->attach(database_);
+        }
+
+        LOG_INFO_FMT("已连接到数据库：{0}", database_path_);
         return true;
     }
 
@@ -73,6 +81,7 @@ namespace RefStorage::DataBase {
                 DatabaseConnector::rollback_transaction();
             }
 
+            clear_statement_cache();
             sqlite3_close(database_);
             database_ = nullptr;
             LOG_INFO("已断开连接数据库");
@@ -93,6 +102,7 @@ namespace RefStorage::DataBase {
 
         if (rc != SQLITE_OK) {
             std::string error = error_msg ? error_msg : "未知错误";
+            sqlite3_free(error_msg);
             handle_sqlite_error(rc,"执行：" + sql);
 
             return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "SQL执行时错误：" + error);
@@ -134,13 +144,20 @@ namespace RefStorage::DataBase {
         }
 
         sqlite3_finalize(stmt);
-        return Common::Result<std::vector<T>>::Success(results);
+        return Common::Result<std::vector<T>>::Success(std::move(results));
     }
 
     // 显式实例化常用类型
     template Common::Result<std::vector<int> > DatabaseConnector::query<int>(const std::string& sql, std::function<int(sqlite3_stmt*)> row_mapper);
     template Common::Result<std::vector<std::string> > DatabaseConnector::query<std::string>(const std::string& sql, std::function<std::string(sqlite3_stmt*)> row_mapper);
 
+    void DatabaseConnector::remove_database_files(const std::filesystem::path& path) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        std::filesystem::remove(path.string() + "-wal", ec);
+        std::filesystem::remove(path.string() + "-shm", ec);
+    }
+
     Common::Result<bool> DatabaseConnector::begin_transaction() {
         if (in_transaction_) {
             return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "事务已开始");
@@ -213,6 +230,74 @@ namespace RefStorage::DataBase {
         return Common::Result<std::unique_ptr<sqlite3_stmt, void(*)(sqlite3_stmt*)> >::Success(std::move(stmt));
     }
 
+    Common::Result<bool> DatabaseConnector::execute_statement(const std::string& sql,
+                                                              const StatementBinder& binder,
+                                                              const RowCallback& row_callback) {
+        if (!is_connected()) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "数据库未连接");
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+        auto it = statement_cache_.find(sql);
+        if (it != statement_cache_.end()) {
+            stmt = it->second;
+        } else {
+            int rc = sqlite3_prepare_v3(database_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+            if (rc != SQLITE_OK) {
+                handle_sqlite_error(rc, "准备语句：" + sql);
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "准备语句失败");
+            }
+            statement_cache_.emplace(sql, stmt);
+        }
+
+        int rc = SQLITE_OK;
+        try {
+            if (binder) {
+                binder(stmt);
+            }
+
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                if (row_callback) {
+                    row_callback(stmt);
+                }
+            }
+        } catch (const std::exception& e) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, std::string(e.what()));
+        }
+
+        if (rc != SQLITE_DONE) {
+            handle_sqlite_error(rc, "执行语句：" + sql);
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+
+        if (rc != SQLITE_DONE) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "执行语句失败");
+        }
+
+        return Common::Result<bool>::Success(true);
+    }
+
+    void DatabaseConnector::clear_statement_cache() {
+        for (auto& [sql, stmt] : statement_cache_) {
+            sqlite3_finalize(stmt);
+        }
+        statement_cache_.clear();
+    }
+
+    void DatabaseConnector::set_profiler(std::shared_ptr<SqlProfiler> profiler) {
+        if (is_connected()) {
+            if (profiler) {
+                profiler->attach(database_);
+            } else {
+                SqlProfiler::detach(database_);
+            }
+        }
+        profiler_ = std::move(profiler);
+    }
+
     void DatabaseConnector::handle_sqlite_error(int error_code, const std::string& operation) {
         std::string error_msg = sqlite3_errmsg(database_);
         std::stringstream ss;
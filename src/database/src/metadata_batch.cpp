@@ -0,0 +1,85 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/metadata_batch.hpp"
+#include "../include/metadata_repository.hpp"
+#include <vector>
+
+
+namespace RefStorage::DataBase {
+
+    MetadataBatch::MetadataBatch(size_t initial_arena_size)
+        : arena_(initial_arena_size) {
+        files_.emplace(arena_.allocator());
+        chunks_.emplace(arena_.allocator());
+    }
+
+    Common::Result<bool> MetadataBatch::commit(ShardedMetadataStore& store) {
+        if (empty()) {
+            return Common::Result<bool>::Success(true);
+        }
+
+        auto result = write_all(store);
+        clear();
+        return result;
+    }
+
+    Common::Result<bool> MetadataBatch::write_all(ShardedMetadataStore& store) {
+        //按分库分组（分组数组同样从内存池分配）
+        using FileGroup  = std::pmr::vector<Common::ArenaFileMataData*>;
+        using ChunkGroup = std::pmr::vector<const Common::ArenaChunkInfo*>;
+        std::pmr::vector<FileGroup>  shard_files(store.shard_count(), arena_.allocator());
+        std::pmr::vector<ChunkGroup> shard_chunks(store.shard_count(), arena_.allocator());
+        for (auto& file : *files_) {
+            shard_files[store.shard_of(file.hash_value_)].push_back(&file);
+        }
+        for (const auto& chunk : *chunks_) {
+            shard_chunks[store.shard_of(chunk.hash_value_)].push_back(&chunk);
+        }
+
+        std::vector<std::future<Common::Result<bool>>> futures;
+        futures.reserve(store.shard_count());
+        for (uint32_t shard = 0; shard < store.shard_count(); ++shard) {
+            if (shard_files[shard].empty() && shard_chunks[shard].empty()) {
+                continue;
+            }
+
+            auto* files  = &shard_files[shard];
+            auto* chunks = &shard_chunks[shard];
+            futures.push_back(store.submit_to(shard, [files, chunks](DatabaseConnector& connector) {
+                for (const auto* chunk : *chunks) {
+                    auto result = MetadataRepository::save_chunk(connector, *chunk);
+                    if (result.failed()) {
+                        return result;
+                    }
+                }
+                for (auto* file : *files) {
+                    auto result = MetadataRepository::save_file(connector, *file);
+                    if (result.failed()) {
+                        return result;
+                    }
+                }
+                return Common::Result<bool>::Success(true);
+            }));
+        }
+
+        //变更引用了内存池中的对象，必须等全部完成后才能释放
+        auto result = Common::Result<bool>::Success(true);
+        for (auto& future : futures) {
+            auto shard_result = future.get();
+            if (shard_result.failed() && result.success()) {
+                result = std::move(shard_result);
+            }
+        }
+        return result;
+    }
+
+    void MetadataBatch::clear() {
+        files_.reset();
+        chunks_.reset();
+        arena_.release();
+        files_.emplace(arena_.allocator());
+        chunks_.emplace(arena_.allocator());
+    }
+
+}
@@ -0,0 +1,431 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/metadata_repository.hpp"
+#include "../include/sharded_metadata_store.hpp"
+#include <sqlite3.h>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace RefStorage::DataBase {
+
+    namespace {
+
+        std::string column_text(sqlite3_stmt* stmt, int column) {
+            const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            return text ? std::string(text, static_cast<size_t>(sqlite3_column_bytes(stmt, column))) : std::string();
+        }
+
+        void bind_text(sqlite3_stmt* stmt, int index, std::string_view value) {
+            sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+        }
+
+        //写入文件行（已存在则覆盖）并回填 file_id_ 与 reference_count_，随后清空其分片列表。
+        //引用数只在插入时取 file.reference_count_ 作为初值，之后只由增量（adjust_file_references）修改，
+        //覆盖已存在的行不会冲掉尚未合并或已合并的增量。File 为 FileMataData 或 ArenaFileMataData
+        template <typename File>
+        Common::Result<bool> upsert_file(DatabaseConnector& connector, File& file) {
+            auto result = connector.execute_statement(
+                "INSERT INTO files (hash, filename, path, size, mime_type, reference_count, created_at, last_accessed_at) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?) "
+                "ON CONFLICT(hash) DO UPDATE SET filename = excluded.filename, path = excluded.path, size = excluded.size, "
+                "mime_type = excluded.mime_type, last_accessed_at = excluded.last_accessed_at",
+                [&file](sqlite3_stmt* stmt) {
+                    bind_text(stmt, 1, file.hash_value_);
+                    bind_text(stmt, 2, file.file_name_);
+                    bind_text(stmt, 3, file.path);
+                    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(file.file_size_));
+                    bind_text(stmt, 5, file.mime_type_);
+                    sqlite3_bind_int64(stmt, 6, file.reference_count_);
+                    sqlite3_bind_int64(stmt, 7, MetadataRepository::to_millis(file.creat_time_));
+                    sqlite3_bind_int64(stmt, 8, MetadataRepository::to_millis(file.last_access_time_));
+                });
+            if (result.failed()) {
+                return result;
+            }
+
+            result = connector.execute_statement("SELECT id, reference_count FROM files WHERE hash = ?",
+                [&file](sqlite3_stmt* stmt) { bind_text(stmt, 1, file.hash_value_); },
+                [&file](sqlite3_stmt* stmt) {
+                    file.file_id_         = static_cast<FileID>(sqlite3_column_int64(stmt, 0));
+                    file.reference_count_ = static_cast<uint32_t>(sqlite3_column_int64(stmt, 1));
+                });
+            if (result.failed()) {
+                return result;
+            }
+
+            return connector.execute_statement("DELETE FROM file_chunks WHERE file_id = ?",
+                [&file](sqlite3_stmt* stmt) { sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(file.file_id_)); });
+        }
+
+        Common::Result<bool> insert_file_chunk(DatabaseConnector& connector, FileID file_id, size_t index,
+                                               std::string_view hash, FileSize offset, FileSize size) {
+            return connector.execute_statement(
+                "INSERT INTO file_chunks (file_id, chunk_index, chunk_hash, chunk_offset, chunk_size) VALUES (?, ?, ?, ?, ?)",
+                [&](sqlite3_stmt* stmt) {
+                    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(file_id));
+                    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(index));
+                    bind_text(stmt, 3, hash);
+                    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(offset));
+                    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(size));
+                });
+        }
+
+        //写入分片行与副本位置，Chunk 为 ChunkInfo 或 ArenaChunkInfo
+        template <typename Chunk>
+        Common::Result<bool> upsert_chunk(DatabaseConnector& connector, const Chunk& chunk) {
+            auto now = MetadataRepository::to_millis(std::chrono::system_clock::now());
+
+            auto result = connector.execute_statement(
+                "INSERT INTO chunks (hash, chunk_id, size, replica_count, reference_count, created_at, updated_at) "
+                "VALUES (?, ?, ?, ?, 1, ?, ?) "
+                "ON CONFLICT(hash) DO UPDATE SET chunk_id = excluded.chunk_id, size = excluded.size, "
+                "replica_count = excluded.replica_count, updated_at = excluded.updated_at",
+                [&](sqlite3_stmt* stmt) {
+                    bind_text(stmt, 1, chunk.hash_value_);
+                    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(chunk.chunk_id_));
+                    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(chunk.file_size_));
+                    sqlite3_bind_int64(stmt, 4, chunk.replica_count_);
+                    sqlite3_bind_int64(stmt, 5, MetadataRepository::to_millis(chunk.creat_time_));
+                    sqlite3_bind_int64(stmt, 6, now);
+                });
+            if (result.failed()) {
+                return result;
+            }
+
+            result = connector.execute_statement("DELETE FROM chunk_replicas WHERE chunk_hash = ?",
+                [&chunk](sqlite3_stmt* stmt) { bind_text(stmt, 1, chunk.hash_value_); });
+
+            for (size_t i = 0; i < chunk.storage_node_.size() && result.success(); ++i) {
+                result = connector.execute_statement(
+                    "INSERT INTO chunk_replicas (chunk_hash, node_id, stored_at) VALUES (?, ?, ?)",
+                    [&](sqlite3_stmt* stmt) {
+                        bind_text(stmt, 1, chunk.hash_value_);
+                        sqlite3_bind_int64(stmt, 2, chunk.storage_node_[i]);
+                        sqlite3_bind_int64(stmt, 3, now);
+                    });
+            }
+
+            return result;
+        }
+
+        //分片查询的一行（分片与副本左连接，每个副本一行）
+        struct ChunkRow {
+            Common::ChunkInfo chunk_;
+            bool              has_node_;
+            NodeID            node_;
+        };
+
+        //文件分片列表的一行
+        struct FileChunkRow {
+            HashValue file_hash_;
+            HashValue chunk_hash_;
+            FileSize  chunk_size_;
+        };
+
+    }
+
+    int64_t MetadataRepository::to_millis(const TimePoint& time_point) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
+    }
+
+    TimePoint MetadataRepository::from_millis(int64_t millis) {
+        return TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::milliseconds(millis)));
+    }
+
+    Common::Result<bool> MetadataRepository::save_file(DatabaseConnector& connector, Common::FileMataData& file) {
+        auto result = upsert_file(connector, file);
+        for (size_t i = 0; i < file.chunks_.size() && result.success(); ++i) {
+            result = insert_file_chunk(connector, file.file_id_, i, file.chunks_.hash(i), file.chunks_.offset(i), file.chunks_.chunk_size(i));
+        }
+        return result;
+    }
+
+    Common::Result<bool> MetadataRepository::save_file(DatabaseConnector& connector, Common::ArenaFileMataData& file) {
+        auto result = upsert_file(connector, file);
+
+        FileSize offset = 0;
+        for (size_t i = 0; i < file.chunks_.size() && result.success(); ++i) {
+            const auto& chunk = file.chunks_[i];
+            result = insert_file_chunk(connector, file.file_id_, i, chunk.hash_value_, offset, chunk.file_size_);
+            offset += chunk.file_size_;
+        }
+        return result;
+    }
+
+    Common::Result<bool> MetadataRepository::touch_file(DatabaseConnector& connector, const HashValue& hash, const TimePoint& access_time) {
+        return connector.execute_statement("UPDATE files SET last_accessed_at = MAX(last_accessed_at, ?) WHERE hash = ?",
+            [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int64(stmt, 1, to_millis(access_time));
+                bind_text(stmt, 2, hash);
+            });
+    }
+
+    Common::Result<bool> MetadataRepository::remove_file(DatabaseConnector& connector, const HashValue& hash) {
+        auto result = connector.execute_statement(
+            "DELETE FROM file_chunks WHERE file_id = (SELECT id FROM files WHERE hash = ?)",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); });
+        if (result.failed()) {
+            return result;
+        }
+
+        return connector.execute_statement("DELETE FROM files WHERE hash = ?",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); });
+    }
+
+    Common::Result<bool> MetadataRepository::save_chunk(DatabaseConnector& connector, const Common::ChunkInfo& chunk) {
+        return upsert_chunk(connector, chunk);
+    }
+
+    Common::Result<bool> MetadataRepository::save_chunk(DatabaseConnector& connector, const Common::ArenaChunkInfo& chunk) {
+        return upsert_chunk(connector, chunk);
+    }
+
+    Common::Result<bool> MetadataRepository::adjust_file_references(DatabaseConnector& connector, const HashValue& hash, int64_t delta) {
+        return connector.execute_statement("UPDATE files SET reference_count = MAX(reference_count + ?, 0) WHERE hash = ?",
+            [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int64(stmt, 1, delta);
+                bind_text(stmt, 2, hash);
+            });
+    }
+
+    Common::Result<bool> MetadataRepository::adjust_chunk_references(DatabaseConnector& connector, const HashValue& hash, int64_t delta,
+                                                                     const TimePoint& time) {
+        return connector.execute_statement(
+            "UPDATE chunks SET reference_count = MAX(reference_count + ?, 0), updated_at = ? WHERE hash = ?",
+            [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int64(stmt, 1, delta);
+                sqlite3_bind_int64(stmt, 2, to_millis(time));
+                bind_text(stmt, 3, hash);
+            });
+    }
+
+    Common::Result<uint64_t> MetadataRepository::load_file_references(ShardedMetadataStore& store, const HashValue& hash) {
+        auto rows = store.query<uint64_t>(hash, "SELECT reference_count FROM files WHERE hash = ?",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); },
+            [](sqlite3_stmt* stmt) { return static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)); });
+        if (rows.failed()) {
+            return Common::Result<uint64_t>::Error(rows);
+        }
+        return Common::Result<uint64_t>::Success(rows.value().empty() ? 0 : rows.value().front());
+    }
+
+    Common::Result<uint64_t> MetadataRepository::load_chunk_references(ShardedMetadataStore& store, const HashValue& hash) {
+        auto rows = store.query<uint64_t>(hash, "SELECT reference_count FROM chunks WHERE hash = ?",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); },
+            [](sqlite3_stmt* stmt) { return static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)); });
+        if (rows.failed()) {
+            return Common::Result<uint64_t>::Error(rows);
+        }
+        return Common::Result<uint64_t>::Success(rows.value().empty() ? 0 : rows.value().front());
+    }
+
+    Common::Result<bool> MetadataRepository::remove_chunk(DatabaseConnector& connector, const HashValue& hash) {
+        auto result = connector.execute_statement("DELETE FROM chunk_replicas WHERE chunk_hash = ?",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); });
+        if (result.failed()) {
+            return result;
+        }
+
+        return connector.execute_statement("DELETE FROM chunks WHERE hash = ?",
+            [&hash](sqlite3_stmt* stmt) { bind_text(stmt, 1, hash); });
+    }
+
+    Common::Result<std::vector<GcCandidate>> MetadataRepository::load_gc_candidates(ShardedMetadataStore& store, uint32_t shard,
+                                                                                    const TimePoint& cutoff, int64_t after_time,
+                                                                                    const HashValue& after_hash, size_t limit) {
+        std::vector<GcCandidate> candidates;
+        auto result = store.read(shard, [&](DatabaseConnector& connector) {
+            return connector.execute_statement(
+                "SELECT hash, size, updated_at FROM chunks "
+                "WHERE reference_count = 0 AND updated_at <= ? AND (updated_at, hash) > (?, ?) "
+                "ORDER BY updated_at, hash LIMIT ?",
+                [&](sqlite3_stmt* stmt) {
+                    sqlite3_bind_int64(stmt, 1, to_millis(cutoff));
+                    sqlite3_bind_int64(stmt, 2, after_time);
+                    bind_text(stmt, 3, after_hash);
+                    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(limit));
+                },
+                [&candidates](sqlite3_stmt* stmt) {
+                    candidates.push_back(GcCandidate{column_text(stmt, 0),
+                                                     static_cast<FileSize>(sqlite3_column_int64(stmt, 1)),
+                                                     sqlite3_column_int64(stmt, 2)});
+                });
+        });
+        if (result.failed()) {
+            return Common::Result<std::vector<GcCandidate>>::Error(result);
+        }
+        return Common::Result<std::vector<GcCandidate>>::Success(std::move(candidates));
+    }
+
+    Common::Result<bool> MetadataRepository::remove_unreferenced_chunk(DatabaseConnector& connector, const GcCandidate& candidate) {
+        //条件删除：选出后被重新引用（或引用数再次变化）的分片保留
+        auto result = connector.execute_statement("DELETE FROM chunks WHERE hash = ? AND reference_count = 0 AND updated_at = ?",
+            [&candidate](sqlite3_stmt* stmt) {
+                bind_text(stmt, 1, candidate.hash_);
+                sqlite3_bind_int64(stmt, 2, candidate.updated_at_);
+            });
+        if (result.failed()) {
+            return result;
+        }
+        if (connector.get_changes_count() == 0) {
+            return Common::Result<bool>::Success(false);
+        }
+
+        result = connector.execute_statement("DELETE FROM chunk_replicas WHERE chunk_hash = ?",
+            [&candidate](sqlite3_stmt* stmt) { bind_text(stmt, 1, candidate.hash_); });
+        if (result.failed()) {
+            return result;
+        }
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<GcProgress> MetadataRepository::load_gc_progress(ShardedMetadataStore& store, uint32_t shard) {
+        GcProgress progress{};
+        auto result = store.read(shard, [&progress](DatabaseConnector& connector) {
+            return connector.execute_statement(
+                "SELECT cursor_time, cursor_hash, passes, reclaimed_chunks, reclaimed_bytes FROM gc_progress WHERE id = 1",
+                nullptr,
+                [&progress](sqlite3_stmt* stmt) {
+                    progress.cursor_time_      = sqlite3_column_int64(stmt, 0);
+                    progress.cursor_hash_      = column_text(stmt, 1);
+                    progress.passes_           = static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+                    progress.reclaimed_chunks_ = static_cast<uint64_t>(sqlite3_column_int64(stmt, 3));
+                    progress.reclaimed_bytes_  = static_cast<uint64_t>(sqlite3_column_int64(stmt, 4));
+                });
+        });
+        if (result.failed()) {
+            return Common::Result<GcProgress>::Error(result);
+        }
+        return Common::Result<GcProgress>::Success(std::move(progress));
+    }
+
+    Common::Result<bool> MetadataRepository::save_gc_progress(DatabaseConnector& connector, const GcProgress& progress) {
+        return connector.execute_statement(
+            "INSERT INTO gc_progress (id, cursor_time, cursor_hash, passes, reclaimed_chunks, reclaimed_bytes, updated_at) "
+            "VALUES (1, ?, ?, ?, ?, ?, ?) "
+            "ON CONFLICT(id) DO UPDATE SET cursor_time = excluded.cursor_time, cursor_hash = excluded.cursor_hash, "
+            "passes = excluded.passes, reclaimed_chunks = excluded.reclaimed_chunks, "
+            "reclaimed_bytes = excluded.reclaimed_bytes, updated_at = excluded.updated_at",
+            [&progress](sqlite3_stmt* stmt) {
+                sqlite3_bind_int64(stmt, 1, progress.cursor_time_);
+                bind_text(stmt, 2, progress.cursor_hash_);
+                sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(progress.passes_));
+                sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(progress.reclaimed_chunks_));
+                sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(progress.reclaimed_bytes_));
+                sqlite3_bind_int64(stmt, 6, to_millis(std::chrono::system_clock::now()));
+            });
+    }
+
+    Common::Result<uint64_t> MetadataRepository::load_ref_count_epoch(ShardedMetadataStore& store, uint32_t shard) {
+        uint64_t epoch = 0;
+        auto result = store.read(shard, [&epoch](DatabaseConnector& connector) {
+            return connector.execute_statement("SELECT epoch FROM ref_count_journal WHERE id = 1", nullptr,
+                [&epoch](sqlite3_stmt* stmt) { epoch = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)); });
+        });
+        if (result.failed()) {
+            return Common::Result<uint64_t>::Error(result);
+        }
+        return Common::Result<uint64_t>::Success(epoch);
+    }
+
+    Common::Result<bool> MetadataRepository::save_ref_count_epoch(DatabaseConnector& connector, uint64_t epoch) {
+        return connector.execute_statement(
+            "INSERT INTO ref_count_journal (id, epoch, updated_at) VALUES (1, ?, ?) "
+            "ON CONFLICT(id) DO UPDATE SET epoch = MAX(epoch, excluded.epoch), updated_at = excluded.updated_at",
+            [epoch](sqlite3_stmt* stmt) {
+                sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(epoch));
+                sqlite3_bind_int64(stmt, 2, to_millis(std::chrono::system_clock::now()));
+            });
+    }
+
+    Common::Result<std::vector<Common::ChunkInfo>> MetadataRepository::load_all_chunks(ShardedMetadataStore& store) {
+        auto rows = store.query_all<ChunkRow>(
+            "SELECT c.hash, c.chunk_id, c.size, c.replica_count, c.created_at, r.node_id "
+            "FROM chunks c LEFT JOIN chunk_replicas r ON r.chunk_hash = c.hash ORDER BY c.hash",
+            nullptr,
+            [](sqlite3_stmt* stmt) {
+                ChunkRow row{};
+                row.chunk_.hash_value_    = column_text(stmt, 0);
+                row.chunk_.chunk_id_      = static_cast<ChunkID>(sqlite3_column_int64(stmt, 1));
+                row.chunk_.file_size_     = static_cast<FileSize>(sqlite3_column_int64(stmt, 2));
+                row.chunk_.replica_count_ = static_cast<uint32_t>(sqlite3_column_int64(stmt, 3));
+                row.chunk_.creat_time_    = from_millis(sqlite3_column_int64(stmt, 4));
+                row.has_node_             = sqlite3_column_type(stmt, 5) != SQLITE_NULL;
+                row.node_                 = static_cast<NodeID>(sqlite3_column_int64(stmt, 5));
+                return row;
+            });
+        if (rows.failed()) {
+            return Common::Result<std::vector<Common::ChunkInfo>>::Error(rows);
+        }
+
+        //同一分片的多行（每个副本一行）在各分库内按哈希相邻，合并为一条
+        std::vector<Common::ChunkInfo> chunks;
+        for (auto& row : rows.value()) {
+            if (chunks.empty() || chunks.back().hash_value_ != row.chunk_.hash_value_) {
+                chunks.push_back(std::move(row.chunk_));
+            }
+            if (row.has_node_) {
+                chunks.back().storage_node_.push_back(row.node_);
+            }
+        }
+
+        return Common::Result<std::vector<Common::ChunkInfo>>::Success(std::move(chunks));
+    }
+
+    Common::Result<std::vector<Common::FileMataData>> MetadataRepository::load_all_files(ShardedMetadataStore& store) {
+        auto files = store.query_all<Common::FileMataData>(
+            "SELECT id, hash, filename, path, size, mime_type, reference_count, created_at, last_accessed_at FROM files",
+            nullptr,
+            [](sqlite3_stmt* stmt) {
+                Common::FileMataData file{};
+                file.file_id_          = static_cast<FileID>(sqlite3_column_int64(stmt, 0));
+                file.hash_value_       = column_text(stmt, 1);
+                file.file_name_        = column_text(stmt, 2);
+                file.path              = column_text(stmt, 3);
+                file.file_size_        = static_cast<FileSize>(sqlite3_column_int64(stmt, 4));
+                file.mime_type_        = column_text(stmt, 5);
+                file.reference_count_  = static_cast<uint32_t>(sqlite3_column_int64(stmt, 6));
+                file.creat_time_       = from_millis(sqlite3_column_int64(stmt, 7));
+                file.last_access_time_ = from_millis(sqlite3_column_int64(stmt, 8));
+                return file;
+            });
+        if (files.failed()) {
+            return files;
+        }
+
+        auto file_chunks = store.query_all<FileChunkRow>(
+            "SELECT f.hash, fc.chunk_hash, fc.chunk_size "
+            "FROM file_chunks fc JOIN files f ON f.id = fc.file_id ORDER BY fc.file_id, fc.chunk_index",
+            nullptr,
+            [](sqlite3_stmt* stmt) {
+                return FileChunkRow{column_text(stmt, 0), column_text(stmt, 1),
+                                    static_cast<FileSize>(sqlite3_column_int64(stmt, 2))};
+            });
+        if (file_chunks.failed()) {
+            return Common::Result<std::vector<Common::FileMataData>>::Error(file_chunks);
+        }
+
+        std::unordered_map<HashValue, size_t> file_index;
+        file_index.reserve(files.value().size());
+        for (size_t i = 0; i < files.value().size(); ++i) {
+            file_index.emplace(files.value()[i].hash_value_, i);
+        }
+
+        for (auto& row : file_chunks.value()) {
+            auto it = file_index.find(row.file_hash_);
+            if (it == file_index.end()) {
+                continue;
+            }
+
+            Common::ChunkInfo chunk{};
+            chunk.hash_value_ = std::move(row.chunk_hash_);
+            chunk.file_size_  = row.chunk_size_;
+            files.value()[it->second].chunks_.push_back(std::move(chunk));
+        }
+
+        return files;
+    }
+
+}
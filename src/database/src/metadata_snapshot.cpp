@@ -0,0 +1,285 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/metadata_snapshot.hpp"
+#include "../include/database_connector.hpp"
+#include "../include/schema_migrator.hpp"
+#include "../include/sharded_metadata_store.hpp"
+#include <sqlite3.h>
+#include <map>
+#include <thread>
+#include "Log.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    namespace {
+
+        //分步复制 source 的主库到 dest
+        Common::Result<bool> copy_database(DatabaseConnector& source,
+                                           DatabaseConnector& dest,
+                                           const SnapshotOptions& options,
+                                           const SnapshotProgressCallback& progress) {
+            sqlite3_backup* backup = sqlite3_backup_init(dest.native_handle(), "main", source.native_handle(), "main");
+            if (backup == nullptr) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR,
+                                                   std::string("初始化备份失败：") + sqlite3_errmsg(dest.native_handle()));
+            }
+
+            int pages = options.pages_per_step_ > 0 ? options.pages_per_step_ : -1;
+            int rc = SQLITE_OK;
+
+            while (true) {
+                rc = sqlite3_backup_step(backup, pages);
+
+                if (rc == SQLITE_DONE) {
+                    break;
+                }
+                if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED) {
+                    break;
+                }
+
+                if (progress) {
+                    SnapshotProgress current{sqlite3_backup_pagecount(backup), sqlite3_backup_remaining(backup)};
+                    if (!progress(current)) {
+                        sqlite3_backup_finish(backup);
+                        return Common::Result<bool>::Error(Common::StatusCode::ERROR, "快照已取消");
+                    }
+                }
+
+                std::this_thread::sleep_for(options.step_pause_);
+            }
+
+            int total = sqlite3_backup_pagecount(backup);
+            sqlite3_backup_finish(backup);
+
+            if (rc != SQLITE_DONE) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR,
+                                                   std::string("复制数据库页失败：") + sqlite3_errstr(rc));
+            }
+
+            if (progress) {
+                progress(SnapshotProgress{total, 0});
+            }
+            return Common::Result<bool>::Success(true);
+        }
+
+        //表结构版本与各表行数，用于比对恢复结果
+        Common::Result<std::map<std::string, int64_t>> fingerprint(DatabaseConnector& connector) {
+            std::map<std::string, int64_t> counts;
+
+            std::vector<std::string> tables;
+            auto listed = connector.execute_statement(
+                "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%'", nullptr,
+                [&tables](sqlite3_stmt* stmt) {
+                    tables.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+                });
+            if (listed.failed()) {
+                return Common::Result<std::map<std::string, int64_t>>::Error(listed);
+            }
+
+            for (const auto& table : tables) {
+                auto counted = connector.execute_statement("SELECT count(*) FROM \"" + table + "\"", nullptr,
+                    [&counts, &table](sqlite3_stmt* stmt) {
+                        counts[table] = sqlite3_column_int64(stmt, 0);
+                    });
+                if (counted.failed()) {
+                    return Common::Result<std::map<std::string, int64_t>>::Error(counted);
+                }
+            }
+
+            SchemaMigrator migrator(connector);
+            auto version = migrator.current_version();
+            if (version.failed()) {
+                return Common::Result<std::map<std::string, int64_t>>::Error(version);
+            }
+            counts["#user_version"] = version.value();
+
+            return Common::Result<std::map<std::string, int64_t>>::Success(std::move(counts));
+        }
+
+    }
+
+    Common::Result<bool> MetadataSnapshot::create(const std::filesystem::path& source_path,
+                                                  const std::filesystem::path& snapshot_path,
+                                                  const SnapshotOptions& options,
+                                                  const SnapshotProgressCallback& progress) {
+        if (!std::filesystem::exists(source_path)) {
+            return Common::Result<bool>::Error(Common::StatusCode::FILE_NOT_FOUND, "源数据库不存在：" + source_path.string());
+        }
+
+        auto partial_path = snapshot_path;
+        partial_path += ".partial";
+        DatabaseConnector::remove_database_files(partial_path);
+
+        auto started = std::chrono::steady_clock::now();
+        {
+            DatabaseConnector source(source_path.string());
+            DatabaseConnector dest(partial_path.string());
+            if (!source.is_connected() || !dest.is_connected()) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法打开快照所需的数据库连接");
+            }
+
+            //WAL模式下持有读事务固定快照视图；回滚日志模式下长读事务会阻塞写入，只能逐步加锁（写入时会重新开始复制）
+            bool wal = false;
+            source.execute_statement("PRAGMA journal_mode", nullptr, [&wal](sqlite3_stmt* stmt) {
+                wal = sqlite3_stricmp(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), "wal") == 0;
+            });
+
+            if (wal) {
+                auto begin = source.begin_transaction();
+                auto pinned = source.execute("SELECT count(*) FROM sqlite_master");
+                if (begin.failed() || pinned.failed()) {
+                    return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法在源数据库上开启读事务");
+                }
+            }
+
+            auto copied = copy_database(source, dest, options, progress);
+
+            if (wal) {
+                source.commit_transaction();
+            }
+
+            if (copied.failed()) {
+                dest.disconnect();
+                DatabaseConnector::remove_database_files(partial_path);
+                return copied;
+            }
+        }
+
+        if (options.verify_) {
+            auto verified = verify(partial_path);
+            if (verified.failed()) {
+                DatabaseConnector::remove_database_files(partial_path);
+                return verified;
+            }
+        }
+
+        std::error_code ec;
+        DatabaseConnector::remove_database_files(snapshot_path);
+        std::filesystem::rename(partial_path, snapshot_path, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "快照文件改名失败：" + ec.message());
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO_FMT("元数据快照完成：{0} -> {1}，耗时 {2} ms", source_path.string(), snapshot_path.string(), elapsed.count());
+        return Common::Result<bool>::Success(true);
+    }
+
+    std::future<Common::Result<bool>> MetadataSnapshot::create_async(std::filesystem::path source_path,
+                                                                     std::filesystem::path snapshot_path,
+                                                                     SnapshotOptions options,
+                                                                     SnapshotProgressCallback progress) {
+        return std::async(std::launch::async,
+                          [source = std::move(source_path), snapshot = std::move(snapshot_path), options, progress = std::move(progress)] {
+                              return create(source, snapshot, options, progress);
+                          });
+    }
+
+    Common::Result<bool> MetadataSnapshot::create_sharded(const std::filesystem::path& store_directory,
+                                                          uint32_t shard_count,
+                                                          const std::filesystem::path& snapshot_directory,
+                                                          const SnapshotOptions& options,
+                                                          const SnapshotProgressCallback& progress) {
+        std::error_code ec;
+        std::filesystem::create_directories(snapshot_directory, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "无法创建快照目录：" + ec.message());
+        }
+
+        for (uint32_t i = 0; i < shard_count; ++i) {
+            auto source = ShardedMetadataStore::shard_path(store_directory, i, shard_count);
+            auto target = ShardedMetadataStore::shard_path(snapshot_directory, i, shard_count);
+
+            auto result = create(source, target, options, progress);
+            if (result.failed()) {
+                return result;
+            }
+        }
+
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> MetadataSnapshot::verify(const std::filesystem::path& snapshot_path) {
+        if (!std::filesystem::exists(snapshot_path)) {
+            return Common::Result<bool>::Error(Common::StatusCode::FILE_NOT_FOUND, "快照不存在：" + snapshot_path.string());
+        }
+
+        DatabaseConnector connector(snapshot_path.string());
+        if (!connector.is_connected()) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法打开快照：" + snapshot_path.string());
+        }
+
+        std::string integrity;
+        auto checked = connector.execute_statement("PRAGMA integrity_check(1)", nullptr, [&integrity](sqlite3_stmt* stmt) {
+            integrity = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        });
+        if (checked.failed() || integrity != "ok") {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "快照完整性检查失败：" + integrity);
+        }
+
+        SchemaMigrator migrator(connector);
+        auto version = migrator.current_version();
+        if (version.failed() || version.value() > SchemaMigrator::latest_version()) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "快照表结构版本无效");
+        }
+
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> MetadataSnapshot::restore(const std::filesystem::path& snapshot_path,
+                                                   const std::filesystem::path& target_path,
+                                                   const SnapshotOptions& options,
+                                                   const SnapshotProgressCallback& progress) {
+        auto verified = verify(snapshot_path);
+        if (verified.failed()) {
+            return verified;
+        }
+
+        auto restoring_path = target_path;
+        restoring_path += ".restoring";
+        DatabaseConnector::remove_database_files(restoring_path);
+
+        {
+            DatabaseConnector snapshot(snapshot_path.string());
+            DatabaseConnector restored(restoring_path.string());
+            if (!snapshot.is_connected() || !restored.is_connected()) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法打开恢复所需的数据库连接");
+            }
+
+            auto copied = copy_database(snapshot, restored, options, progress);
+            if (copied.failed()) {
+                restored.disconnect();
+                DatabaseConnector::remove_database_files(restoring_path);
+                return copied;
+            }
+
+            //恢复结果必须与快照的表结构版本和各表行数一致
+            auto expected = fingerprint(snapshot);
+            auto actual   = fingerprint(restored);
+            if (expected.failed() || actual.failed() || expected.value() != actual.value()) {
+                restored.disconnect();
+                DatabaseConnector::remove_database_files(restoring_path);
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "恢复结果与快照不一致");
+            }
+        }
+
+        auto checked = verify(restoring_path);
+        if (checked.failed()) {
+            DatabaseConnector::remove_database_files(restoring_path);
+            return checked;
+        }
+
+        std::error_code ec;
+        DatabaseConnector::remove_database_files(target_path);
+        std::filesystem::rename(restoring_path, target_path, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "恢复文件改名失败：" + ec.message());
+        }
+
+        LOG_INFO_FMT("已从快照 {0} 恢复元数据库 {1}", snapshot_path.string(), target_path.string());
+        return Common::Result<bool>::Success(true);
+    }
+
+}
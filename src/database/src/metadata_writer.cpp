@@ -0,0 +1,197 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/metadata_writer.hpp"
+#include <algorithm>
+#include "Log.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    MetadataWriter::MetadataWriter(const std::string& database_path, MetadataWriterOptions options)
+        : connector_(database_path)
+        , options_(options) {
+        if (options_.max_batch_size_ == 0) {
+            options_.max_batch_size_ = 1;
+        }
+
+        if (!connector_.is_connected()) {
+            LOG_ERROR_FMT("元数据写入器无法连接数据库：{0}", database_path);
+            return;
+        }
+
+        if (options_.enable_wal_) {
+            auto result = connector_.execute("PRAGMA journal_mode=WAL");
+            if (result.failed()) {
+                LOG_WARN_FMT("启用WAL失败，继续使用默认日志模式：{0}", result.message());
+            }
+        }
+
+        running_.store(true, std::memory_order_release);
+        worker_thread_ = std::thread(&MetadataWriter::run, this);
+    }
+
+    MetadataWriter::~MetadataWriter() {
+        stop();
+    }
+
+    std::future<Common::Result<bool>> MetadataWriter::submit(Mutation mutation) {
+        Pending pending{std::move(mutation), {}};
+        auto future = pending.promise_.get_future();
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            space_cv_.wait(lock, [this] {
+                return queue_.size() < options_.max_queue_size_ || !running_.load(std::memory_order_acquire);
+            });
+
+            if (!running_.load(std::memory_order_acquire)) {
+                pending.promise_.set_value(Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "元数据写入器未运行"));
+                return future;
+            }
+
+            queue_.push_back(std::move(pending));
+        }
+
+        queue_cv_.notify_one();
+        return future;
+    }
+
+    Common::Result<bool> MetadataWriter::execute(Mutation mutation) {
+        return submit(std::move(mutation)).get();
+    }
+
+    void MetadataWriter::flush() {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        idle_cv_.wait(lock, [this] { return (queue_.empty() && in_flight_ == 0) || !worker_thread_.joinable(); });
+    }
+
+    void MetadataWriter::stop() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (!running_.exchange(false, std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+
+        queue_cv_.notify_all();
+        space_cv_.notify_all();
+
+        if (worker_thread_.joinable()) {
+            worker_thread_.join();
+        }
+        idle_cv_.notify_all();
+    }
+
+    MetadataWriter::Stats MetadataWriter::stats() const {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return {committed_batches_.load(std::memory_order_relaxed),
+                committed_mutations_.load(std::memory_order_relaxed),
+                failed_mutations_.load(std::memory_order_relaxed),
+                queue_.size()};
+    }
+
+    void MetadataWriter::run() {
+        std::deque<Pending> batch;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                queue_cv_.wait(lock, [this] { return !queue_.empty() || !running_.load(std::memory_order_acquire); });
+
+                if (queue_.empty()) {
+                    //已停止且队列已清空
+                    break;
+                }
+
+                //第一条变更到达后，在合并窗口内继续收集，直到凑满一批或窗口结束
+                auto deadline = std::chrono::steady_clock::now() + options_.max_batch_delay_;
+                queue_cv_.wait_until(lock, deadline, [this] {
+                    return queue_.size() >= options_.max_batch_size_ || !running_.load(std::memory_order_acquire);
+                });
+
+                size_t count = std::min(queue_.size(), options_.max_batch_size_);
+                for (size_t i = 0; i < count; ++i) {
+                    batch.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+                in_flight_ = count;
+            }
+            space_cv_.notify_all();
+
+            commit_batch(batch);
+            batch.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                in_flight_ = 0;
+            }
+            idle_cv_.notify_all();
+        }
+    }
+
+    void MetadataWriter::commit_batch(std::deque<Pending>& batch) {
+        auto fail_all = [this, &batch](std::string message) {
+            //同一错误交付给整批，各结果共享说明文字
+            Common::ErrorInfo error(Common::StatusCode::DATABASE_ERROR, std::move(message));
+            for (auto& pending : batch) {
+                pending.promise_.set_value(Common::Result<bool>::Error(error));
+            }
+            failed_mutations_.fetch_add(batch.size(), std::memory_order_relaxed);
+        };
+
+        auto begin = connector_.begin_transaction();
+        if (begin.failed()) {
+            fail_all("开启批量事务失败：" + begin.message());
+            return;
+        }
+
+        //每条变更的执行结果，事务提交后再交付给提交方
+        std::vector<Common::Result<bool>> results;
+        results.reserve(batch.size());
+
+        for (auto& pending : batch) {
+            auto savepoint = connector_.execute("SAVEPOINT metadata_mutation");
+            if (savepoint.failed()) {
+                results.push_back(std::move(savepoint));
+                continue;
+            }
+
+            Common::Result<bool> result;
+            try {
+                result = pending.mutation_(connector_);
+            } catch (const std::exception& e) {
+                result = Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, std::string("变更执行异常：") + e.what());
+            }
+
+            if (result.failed()) {
+                connector_.execute("ROLLBACK TO metadata_mutation");
+            }
+            connector_.execute("RELEASE metadata_mutation");
+
+            results.push_back(std::move(result));
+        }
+
+        auto commit = connector_.commit_transaction();
+        if (commit.failed()) {
+            connector_.rollback_transaction();
+            fail_all("提交批量事务失败：" + commit.message());
+            return;
+        }
+
+        uint64_t committed = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (results[i].success()) {
+                ++committed;
+            }
+            batch[i].promise_.set_value(std::move(results[i]));
+        }
+
+        committed_batches_.fetch_add(1, std::memory_order_relaxed);
+        committed_mutations_.fetch_add(committed, std::memory_order_relaxed);
+        failed_mutations_.fetch_add(batch.size() - committed, std::memory_order_relaxed);
+
+        LOG_DEBUG_FMT("元数据批量提交完成：{0} 条变更，{1} 条失败", batch.size(), batch.size() - committed);
+    }
+
+}
@@ -0,0 +1,92 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/schema_migrator.hpp"
+#include <sqlite3.h>
+#include "Log.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    namespace {
+
+        //各版本的迁移SQL来自 scripts/migrations/*.sql，由 CMake 生成
+#include "schema_migrations.inc"
+
+    }
+
+    SchemaMigrator::SchemaMigrator(DatabaseConnector& connector)
+        : connector_(connector) {
+    }
+
+    const std::vector<Migration>& SchemaMigrator::migrations() {
+        static const std::vector<Migration> all_migrations(std::begin(kEmbeddedMigrations), std::end(kEmbeddedMigrations));
+        return all_migrations;
+    }
+
+    int SchemaMigrator::latest_version() {
+        return migrations().empty() ? 0 : migrations().back().version_;
+    }
+
+    Common::Result<int> SchemaMigrator::current_version() {
+        auto result = connector_.query<int>("PRAGMA user_version", [](sqlite3_stmt* stmt) {
+            return sqlite3_column_int(stmt, 0);
+        });
+
+        if (result.failed()) {
+            return Common::Result<int>::Error(result.status_code(), "读取表结构版本失败：" + result.message());
+        }
+
+        return Common::Result<int>::Success(result.value().empty() ? 0 : result.value().front());
+    }
+
+    Common::Result<int> SchemaMigrator::migrate(int target_version) {
+        auto version = current_version();
+        if (version.failed()) {
+            return version;
+        }
+
+        int current = version.value();
+        if (current > latest_version()) {
+            LOG_ERROR_FMT("数据库表结构版本 {0} 高于程序支持的版本 {1}", current, latest_version());
+            return Common::Result<int>::Error(Common::StatusCode::DATABASE_ERROR, "数据库表结构版本高于程序支持的版本");
+        }
+
+        for (const auto& migration : migrations()) {
+            if (migration.version_ <= current || migration.version_ > target_version) {
+                continue;
+            }
+
+            auto applied = apply(migration);
+            if (applied.failed()) {
+                return Common::Result<int>::Error(applied);
+            }
+
+            current = migration.version_;
+            LOG_INFO_FMT("数据库表结构已迁移到版本 {0}（{1}）", current, migration.description_);
+        }
+
+        return Common::Result<int>::Success(current);
+    }
+
+    Common::Result<bool> SchemaMigrator::apply(const Migration& migration) {
+        auto begin = connector_.begin_transaction();
+        if (begin.failed()) {
+            return begin;
+        }
+
+        auto result = connector_.execute(migration.sql_);
+        if (result.success()) {
+            result = connector_.execute("PRAGMA user_version = " + std::to_string(migration.version_));
+        }
+
+        if (result.failed()) {
+            connector_.rollback_transaction();
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR,
+                                               "迁移到版本 " + std::to_string(migration.version_) + " 失败：" + result.message());
+        }
+
+        return connector_.commit_transaction();
+    }
+
+}
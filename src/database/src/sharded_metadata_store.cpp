@@ -0,0 +1,364 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/sharded_metadata_store.hpp"
+#include "../include/schema_migrator.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include "Log.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    namespace {
+
+        //SQL函数 refstorage_shard(hash, shard_count)，重新切分时在SQL中计算行所属分库
+        void sql_shard_function(sqlite3_context* context, int argc, sqlite3_value** argv) {
+            if (argc != 2 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+                sqlite3_result_null(context);
+                return;
+            }
+
+            const auto* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+            HashValue hash(text, static_cast<size_t>(sqlite3_value_bytes(argv[0])));
+            auto shard_count = static_cast<uint32_t>(sqlite3_value_int64(argv[1]));
+
+            sqlite3_result_int64(context, ShardedMetadataStore::shard_of(hash, shard_count));
+        }
+
+        //分库i负责的前缀区间 [first, last]
+        std::pair<uint64_t, uint64_t> prefix_range(uint32_t index, uint32_t shard_count) {
+            auto first = ((uint64_t{index} << 32) + shard_count - 1) / shard_count;
+            auto last  = ((uint64_t{index + 1} << 32) + shard_count - 1) / shard_count - 1;
+            return {first, last};
+        }
+
+    }
+
+    ShardedMetadataStore::ShardedMetadataStore(ShardedStoreOptions options)
+        : options_(std::move(options)) {
+        if (options_.shard_count_ == 0) {
+            options_.shard_count_ = 1;
+        }
+    }
+
+    ShardedMetadataStore::~ShardedMetadataStore() {
+        close();
+    }
+
+    Common::Result<bool> ShardedMetadataStore::open() {
+        if (is_open()) {
+            return Common::Result<bool>::Success(true);
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(options_.directory_, ec);
+        if (ec) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法创建分库目录：" + ec.message());
+        }
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        shards.reserve(options_.shard_count_);
+
+        for (uint32_t i = 0; i < options_.shard_count_; ++i) {
+            auto path = shard_path(options_.directory_, i, options_.shard_count_).string();
+            auto shard = std::make_unique<Shard>();
+
+            //先在只读连接上完成表结构迁移，再启动写入线程
+            shard->reader_ = std::make_unique<DatabaseConnector>(path);
+            if (!shard->reader_->is_connected()) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法打开分库：" + path);
+            }
+
+            SchemaMigrator migrator(*shard->reader_);
+            auto migrated = migrator.migrate();
+            if (migrated.failed()) {
+                return Common::Result<bool>::Error(migrated.status_code(), "分库 " + path + " 迁移失败：" + migrated.message());
+            }
+            shard->reader_->execute("PRAGMA query_only = 1");
+
+            shard->writer_ = std::make_unique<MetadataWriter>(path, options_.writer_options_);
+            if (!shard->writer_->is_running()) {
+                return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "分库写入线程启动失败：" + path);
+            }
+
+            shards.push_back(std::move(shard));
+        }
+
+        shards_ = std::move(shards);
+        start_query_workers();
+        LOG_INFO_FMT("已打开 {0} 个元数据分库：{1}", options_.shard_count_, options_.directory_.string());
+        return Common::Result<bool>::Success(true);
+    }
+
+    void ShardedMetadataStore::close() {
+        stop_query_workers();
+        for (auto& shard : shards_) {
+            shard->writer_->stop();
+        }
+        shards_.clear();
+    }
+
+    uint32_t ShardedMetadataStore::hash_prefix(std::string_view hash) {
+        uint32_t prefix = 0;
+        if (hash.size() >= 8) {
+            auto [ptr, ec] = std::from_chars(hash.data(), hash.data() + 8, prefix, 16);
+            if (ec == std::errc() && ptr == hash.data() + 8) {
+                return prefix;
+            }
+        }
+
+        //非十六进制哈希：退化为 FNV-1a 散列值。路由结果会写入分库文件，
+        //不能用 std::hash（其取值由标准库实现决定，不同编译器构建的程序会把同一哈希路由到不同分库）
+        uint64_t value = 14695981039346656037ULL;
+        for (char c : hash) {
+            value ^= static_cast<unsigned char>(c);
+            value *= 1099511628211ULL;
+        }
+        return static_cast<uint32_t>(value ^ (value >> 32));
+    }
+
+    uint32_t ShardedMetadataStore::shard_of(std::string_view hash, uint32_t shard_count) {
+        if (shard_count <= 1) {
+            return 0;
+        }
+        return static_cast<uint32_t>((uint64_t{hash_prefix(hash)} * shard_count) >> 32);
+    }
+
+    std::filesystem::path ShardedMetadataStore::shard_path(const std::filesystem::path& directory, uint32_t index, uint32_t shard_count) {
+        return directory / ("metadata-" + std::to_string(index) + "-of-" + std::to_string(shard_count) + ".db");
+    }
+
+    std::future<Common::Result<bool>> ShardedMetadataStore::submit(const HashValue& key, MetadataWriter::Mutation mutation) {
+        return submit_to(shard_of(key), std::move(mutation));
+    }
+
+    std::future<Common::Result<bool>> ShardedMetadataStore::submit_to(uint32_t shard, MetadataWriter::Mutation mutation) {
+        if (shard >= shards_.size()) {
+            std::promise<Common::Result<bool>> promise;
+            promise.set_value(Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "分库未打开"));
+            return promise.get_future();
+        }
+        return shards_[shard]->writer_->submit(std::move(mutation));
+    }
+
+    std::vector<std::future<Common::Result<bool>>> ShardedMetadataStore::broadcast(const MetadataWriter::Mutation& mutation) {
+        std::vector<std::future<Common::Result<bool>>> futures;
+        futures.reserve(shards_.size());
+        for (uint32_t i = 0; i < shards_.size(); ++i) {
+            futures.push_back(submit_to(i, mutation));
+        }
+        return futures;
+    }
+
+    void ShardedMetadataStore::flush() {
+        for (auto& shard : shards_) {
+            shard->writer_->flush();
+        }
+    }
+
+    Common::Result<bool> ShardedMetadataStore::read(uint32_t shard, const Reader& reader) {
+        if (shard >= shards_.size()) {
+            return Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "分库未打开");
+        }
+
+        std::lock_guard<std::mutex> lock(shards_[shard]->reader_mutex_);
+        return reader(*shards_[shard]->reader_);
+    }
+
+    void ShardedMetadataStore::start_query_workers() {
+        uint32_t workers = options_.shard_count_ - 1;
+        workers = std::min(workers, std::max(1u, std::thread::hardware_concurrency()));
+
+        query_stopping_ = false;
+        query_workers_.reserve(workers);
+        for (uint32_t i = 0; i < workers; ++i) {
+            query_workers_.emplace_back(&ShardedMetadataStore::query_worker, this);
+        }
+    }
+
+    void ShardedMetadataStore::stop_query_workers() {
+        {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            query_stopping_ = true;
+        }
+        query_cv_.notify_all();
+        for (auto& worker : query_workers_) {
+            worker.join();
+        }
+        query_workers_.clear();
+    }
+
+    void ShardedMetadataStore::post_query(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            if (!query_workers_.empty()) {
+                query_tasks_.push_back(std::move(task));
+                task = nullptr;
+            }
+        }
+
+        //没有查询线程（单分库或已关闭）时在调用线程上执行
+        if (task) {
+            task();
+            return;
+        }
+        query_cv_.notify_one();
+    }
+
+    void ShardedMetadataStore::query_worker() {
+        std::unique_lock<std::mutex> lock(query_mutex_);
+        for (;;) {
+            query_cv_.wait(lock, [this] { return query_stopping_ || !query_tasks_.empty(); });
+            if (query_tasks_.empty()) {
+                break;
+            }
+
+            auto task = std::move(query_tasks_.front());
+            query_tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    Common::Result<bool> ShardedMetadataStore::reshard(const std::filesystem::path& directory, uint32_t old_count, uint32_t new_count) {
+        if (old_count == 0 || new_count == 0 || old_count == new_count) {
+            return Common::Result<bool>::Error(Common::StatusCode::INVALID_ARGUMENT, "分库数量无效");
+        }
+
+        for (uint32_t i = 0; i < old_count; ++i) {
+            if (!std::filesystem::exists(shard_path(directory, i, old_count))) {
+                return Common::Result<bool>::Error(Common::StatusCode::FILE_NOT_FOUND,
+                                                   "旧分库不存在：" + shard_path(directory, i, old_count).string());
+            }
+        }
+        for (uint32_t j = 0; j < new_count; ++j) {
+            if (std::filesystem::exists(shard_path(directory, j, new_count))) {
+                return Common::Result<bool>::Error(Common::StatusCode::DUPLICATE_FILE,
+                                                   "目标分库已存在：" + shard_path(directory, j, new_count).string());
+            }
+        }
+
+        //旧分库先升级到当前表结构，保证列一致
+        for (uint32_t i = 0; i < old_count; ++i) {
+            DatabaseConnector source(shard_path(directory, i, old_count).string());
+            SchemaMigrator migrator(source);
+            auto migrated = migrator.migrate();
+            if (migrated.failed()) {
+                return Common::Result<bool>::Error(migrated);
+            }
+        }
+
+        auto abort_reshard = [&](Common::Result<bool> error) {
+            for (uint32_t j = 0; j < new_count; ++j) {
+                DatabaseConnector::remove_database_files(shard_path(directory, j, new_count));
+            }
+            return error;
+        };
+
+        for (uint32_t j = 0; j < new_count; ++j) {
+            auto target_path = shard_path(directory, j, new_count);
+            DatabaseConnector target(target_path.string());
+            if (!target.is_connected()) {
+                return abort_reshard(Common::Result<bool>::Error(Common::StatusCode::DATABASE_ERROR, "无法创建分库：" + target_path.string()));
+            }
+
+            sqlite3_create_function_v2(target.native_handle(), "refstorage_shard", 2,
+                                       SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr,
+                                       &sql_shard_function, nullptr, nullptr, nullptr);
+
+            SchemaMigrator migrator(target);
+            auto migrated = migrator.migrate();
+            if (migrated.failed()) {
+                return abort_reshard(Common::Result<bool>::Error(migrated));
+            }
+
+            auto [target_first, target_last] = prefix_range(j, new_count);
+            for (uint32_t i = 0; i < old_count; ++i) {
+                //前缀区间不相交的旧分库中不会有属于该分库的数据
+                auto [source_first, source_last] = prefix_range(i, old_count);
+                bool overlaps = source_first <= target_last && target_first <= source_last;
+                bool global   = (i == kGlobalShard && j == kGlobalShard);
+                if (!overlaps && !global) {
+                    continue;
+                }
+
+                auto copied = copy_shard_rows(target, shard_path(directory, i, old_count), global, j, new_count);
+                if (copied.failed()) {
+                    return abort_reshard(std::move(copied));
+                }
+            }
+
+            LOG_INFO_FMT("分库 {0}/{1} 重新切分完成", j + 1, new_count);
+        }
+
+        for (uint32_t i = 0; i < old_count; ++i) {
+            DatabaseConnector::remove_database_files(shard_path(directory, i, old_count));
+        }
+
+        LOG_INFO_FMT("元数据分库已从 {0} 个重新切分为 {1} 个", old_count, new_count);
+        return Common::Result<bool>::Success(true);
+    }
+
+    Common::Result<bool> ShardedMetadataStore::copy_shard_rows(DatabaseConnector& target,
+                                                               const std::filesystem::path& source_path,
+                                                               bool copy_global_tables,
+                                                               uint32_t target_index,
+                                                               uint32_t target_count) {
+        auto attached = target.execute_statement("ATTACH DATABASE ? AS source", [&](sqlite3_stmt* stmt) {
+            sqlite3_bind_text(stmt, 1, source_path.string().c_str(), -1, SQLITE_TRANSIENT);
+        });
+        if (attached.failed()) {
+            return attached;
+        }
+
+        const std::string belongs = "refstorage_shard(%1, " + std::to_string(target_count) + ") = " + std::to_string(target_index);
+        auto where = [&belongs](const std::string& column) {
+            std::string condition = belongs;
+            condition.replace(condition.find("%1"), 2, column);
+            return " WHERE " + condition;
+        };
+
+        std::vector<std::string> statements = {
+            "INSERT INTO main.files (hash, filename, path, size, mime_type, reference_count, deduplication_enabled, "
+            "created_at, last_accessed_at, metadata) "
+            "SELECT hash, filename, path, size, mime_type, reference_count, deduplication_enabled, "
+            "created_at, last_accessed_at, metadata FROM source.files" + where("hash"),
+
+            //文件ID重新分配，按哈希对应新旧文件
+            "INSERT INTO main.file_chunks (file_id, chunk_index, chunk_hash, chunk_offset, chunk_size) "
+            "SELECT nf.id, fc.chunk_index, fc.chunk_hash, fc.chunk_offset, fc.chunk_size "
+            "FROM source.file_chunks fc "
+            "JOIN source.files sf ON sf.id = fc.file_id "
+            "JOIN main.files nf ON nf.hash = sf.hash" + where("sf.hash"),
+
+            "INSERT INTO main.chunks SELECT * FROM source.chunks" + where("hash"),
+
+            "INSERT INTO main.chunk_replicas SELECT * FROM source.chunk_replicas" + where("chunk_hash"),
+        };
+
+        if (copy_global_tables) {
+            statements.emplace_back("INSERT INTO main.storage_nodes SELECT * FROM source.storage_nodes");
+        }
+
+        auto result = target.begin_transaction();
+        for (const auto& sql : statements) {
+            if (result.failed()) {
+                break;
+            }
+            result = target.execute(sql);
+        }
+
+        if (result.success()) {
+            result = target.commit_transaction();
+        } else {
+            target.rollback_transaction();
+        }
+
+        target.execute("DETACH DATABASE source");
+        return result;
+    }
+
+}
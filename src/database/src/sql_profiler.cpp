@@ -0,0 +1,289 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+#include "../include/sql_profiler.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include "Log.hpp"
+
+
+namespace RefStorage::DataBase {
+
+    uint64_t StatementProfile::percentile_ns(double percentile) const {
+        if (calls_ == 0) {
+            return 0;
+        }
+
+        auto target = static_cast<uint64_t>(percentile * static_cast<double>(calls_));
+        target = std::clamp<uint64_t>(target, 1, calls_);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += histogram_[i];
+            if (seen >= target) {
+                return i + 1 == kBucketCount ? max_ns_ : (uint64_t{1} << i) * 1000;
+            }
+        }
+        return max_ns_;
+    }
+
+    SqlProfiler::SqlProfiler(SqlProfilerOptions options)
+        : options_(options) {
+    }
+
+    void SqlProfiler::attach(sqlite3* database) {
+        if (database == nullptr) {
+            return;
+        }
+
+        //SQLITE_TRACE_PROFILE 自带的耗时在部分平台上只有毫秒精度，开始时间由 SQLITE_TRACE_STMT 自行记录
+        unsigned mask = SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE;
+        if (options_.count_rows_) {
+            mask |= SQLITE_TRACE_ROW;
+        }
+        sqlite3_trace_v2(database, mask, &SqlProfiler::trace_callback, this);
+    }
+
+    void SqlProfiler::detach(sqlite3* database) {
+        if (database != nullptr) {
+            sqlite3_trace_v2(database, 0, nullptr, nullptr);
+        }
+    }
+
+    int SqlProfiler::trace_callback(unsigned type, void* context, void* p, void* x) {
+        auto* profiler = static_cast<SqlProfiler*>(context);
+        auto* stmt = static_cast<sqlite3_stmt*>(p);
+
+        if (type == SQLITE_TRACE_STMT) {
+            //以"--"开头的是触发器子程序，不单独计时
+            const char* text = static_cast<const char*>(x);
+            if (text == nullptr || text[0] != '-' || text[1] != '-') {
+                profiler->on_statement(stmt);
+            }
+        }
+        else if (type == SQLITE_TRACE_ROW) {
+            profiler->on_row(stmt);
+        }
+        else if (type == SQLITE_TRACE_PROFILE) {
+            //x 指向以纳秒计的执行耗时
+            profiler->on_profile(stmt, static_cast<uint64_t>(*static_cast<sqlite3_int64*>(x)));
+        }
+        return 0;
+    }
+
+    SqlProfiler::StatementState& SqlProfiler::state_for(sqlite3_stmt* stmt) {
+        auto& state = states_[stmt];
+
+        const char* raw_sql = sqlite3_sql(stmt);
+        std::string_view raw = raw_sql ? raw_sql : "";
+        if (state.profile_ == nullptr || state.raw_sql_ != raw) {
+            state.raw_sql_ = raw;
+
+            std::string sql = normalize(raw);
+            auto& profile = statements_[sql];
+            if (profile.calls_ == 0) {
+                profile.sql_ = std::move(sql);
+            }
+            state.profile_ = &profile;
+        }
+        return state;
+    }
+
+    void SqlProfiler::on_statement(sqlite3_stmt* stmt) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& state = state_for(stmt);
+        state.start_ = now;
+        state.rows_  = 0;
+    }
+
+    void SqlProfiler::on_row(sqlite3_stmt* stmt) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = states_.find(stmt); it != states_.end()) {
+            ++it->second.rows_;
+        }
+    }
+
+    void SqlProfiler::on_profile(sqlite3_stmt* stmt, uint64_t sqlite_elapsed_ns) {
+        auto now = std::chrono::steady_clock::now();
+
+        //重置计数，使下一次执行重新从0开始统计
+        auto vm_steps = static_cast<uint64_t>(sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1));
+
+        bool        slow       = false;
+        uint64_t    elapsed_ns = sqlite_elapsed_ns;
+        uint64_t    elapsed_us = 0;
+        std::string sql;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto& state = state_for(stmt);
+            uint64_t rows = state.rows_;
+            if (state.start_ != std::chrono::steady_clock::time_point{}) {
+                elapsed_ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.start_).count());
+            }
+            state.start_ = {};
+            state.rows_  = 0;
+
+            elapsed_us = elapsed_ns / 1000;
+            size_t bucket = std::min<size_t>(std::bit_width(elapsed_us), StatementProfile::kBucketCount - 1);
+
+            auto& profile = *state.profile_;
+            ++profile.calls_;
+            profile.rows_     += rows;
+            profile.vm_steps_ += vm_steps;
+            profile.total_ns_ += elapsed_ns;
+            profile.max_ns_    = std::max(profile.max_ns_, elapsed_ns);
+            ++profile.histogram_[bucket];
+
+            auto threshold = static_cast<uint64_t>(options_.slow_query_threshold_.count());
+            slow = threshold > 0 && elapsed_us >= threshold;
+            if (slow) {
+                sql = profile.sql_;
+            }
+        }
+
+        if (slow) {
+            char* expanded = sqlite3_expanded_sql(stmt);
+            LOG_WARN_FMT("慢查询 {0} µs，虚拟机步数 {1}：{2}", elapsed_us, vm_steps, expanded ? expanded : sql);
+            sqlite3_free(expanded);
+        }
+    }
+
+    std::vector<StatementProfile> SqlProfiler::snapshot() const {
+        std::vector<StatementProfile> profiles;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            profiles.reserve(statements_.size());
+            for (const auto& [sql, profile] : statements_) {
+                //首次执行尚未结束的语句还没有统计
+                if (profile.calls_ > 0) {
+                    profiles.push_back(profile);
+                }
+            }
+        }
+
+        std::sort(profiles.begin(), profiles.end(), [](const StatementProfile& a, const StatementProfile& b) {
+            return a.total_ns_ > b.total_ns_;
+        });
+        return profiles;
+    }
+
+    std::string SqlProfiler::dump(size_t max_statements) const {
+        auto profiles = snapshot();
+
+        std::ostringstream oss;
+        oss << std::left << std::setw(10) << "calls"
+            << std::setw(12) << "total(ms)"
+            << std::setw(10) << "avg(µs)"
+            << std::setw(10) << "p50(µs)"
+            << std::setw(10) << "p99(µs)"
+            << std::setw(10) << "max(µs)"
+            << std::setw(12) << "rows"
+            << std::setw(14) << "vm_steps"
+            << "sql\n";
+
+        size_t count = std::min(max_statements, profiles.size());
+        for (size_t i = 0; i < count; ++i) {
+            const auto& p = profiles[i];
+            oss << std::left << std::setw(10) << p.calls_
+                << std::setw(12) << p.total_ns_ / 1000000
+                << std::setw(10) << p.total_ns_ / p.calls_ / 1000
+                << std::setw(10) << p.percentile_ns(0.50) / 1000
+                << std::setw(10) << p.percentile_ns(0.99) / 1000
+                << std::setw(10) << p.max_ns_ / 1000
+                << std::setw(12) << p.rows_
+                << std::setw(14) << p.vm_steps_
+                << p.sql_ << '\n';
+        }
+
+        return oss.str();
+    }
+
+    void SqlProfiler::reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        states_.clear();
+        statements_.clear();
+    }
+
+    void SqlProfiler::set_slow_query_threshold(std::chrono::microseconds threshold) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_.slow_query_threshold_ = threshold;
+    }
+
+    std::string SqlProfiler::normalize(std::string_view sql) {
+        std::string result;
+        result.reserve(sql.size());
+
+        auto is_identifier = [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+        };
+
+        size_t i = 0;
+        while (i < sql.size()) {
+            char c = sql[i];
+
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                //合并连续空白
+                while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+                    ++i;
+                }
+                if (!result.empty() && result.back() != ' ' && i < sql.size()) {
+                    result.push_back(' ');
+                }
+                continue;
+            }
+
+            if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+                //行注释
+                while (i < sql.size() && sql[i] != '\n') {
+                    ++i;
+                }
+                continue;
+            }
+
+            if (c == '\'') {
+                //字符串字面量（''为转义的单引号）
+                ++i;
+                while (i < sql.size()) {
+                    if (sql[i] == '\'') {
+                        if (i + 1 < sql.size() && sql[i + 1] == '\'') {
+                            i += 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    ++i;
+                }
+                ++i;
+                result.push_back('?');
+                continue;
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(c)) && (result.empty() || !is_identifier(result.back()))) {
+                //数字字面量
+                while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) {
+                    ++i;
+                }
+                result.push_back('?');
+                continue;
+            }
+
+            result.push_back(c);
+            ++i;
+        }
+
+        //去掉结尾空白与分号
+        while (!result.empty() && (result.back() == ' ' || result.back() == ';')) {
+            result.pop_back();
+        }
+
+        return result;
+    }
+
+}
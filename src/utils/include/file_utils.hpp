@@ -47,18 +47,18 @@ namespace RefStorage::Utils {
 
         //类方法：
         //读取文件
-        static std::vector<char> read_file(const std::filesystem::path& filepath);
+        static Common::Result<std::vector<char>> read_file(const std::filesystem::path& filepath);
 
-        // 创建目录（包括父目录）
-        static bool create_directory(const std::filesystem::path& dirpath);
+        // 创建目录（包括父目录），value() 表示是否新建了目录
+        static Common::Result<bool> create_directory(const std::filesystem::path& dirpath);
         // 向文件写入数据
-        static bool write_file(const std::filesystem::path& filepath, const void* data, size_t length);
+        static Common::Result<bool> write_file(const std::filesystem::path& filepath, const void* data, size_t length);
 
         // 追加数据到文件
-        static bool append_file(const std::filesystem::path& filepath, const void* data, size_t length);
+        static Common::Result<bool> append_file(const std::filesystem::path& filepath, const void* data, size_t length);
 
-        // 删除文件
-        static bool delete_file(const std::filesystem::path& filepath);
+        // 删除文件，value() 表示文件是否存在
+        static Common::Result<bool> delete_file(const std::filesystem::path& filepath);
 
         // 获取文件的MIME类型
         static std::string get_mime_type(const std::filesystem::path& filepath);
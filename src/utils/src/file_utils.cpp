@@ -10,17 +10,17 @@
 
 namespace RefStorage::Utils {
 
-    std::vector<char> FileUtils::read_file(const std::filesystem::path& filepath) {
+    Common::Result<std::vector<char>> FileUtils::read_file(const std::filesystem::path& filepath) {
         if (!std::filesystem::exists(filepath)) {
-            LOG_ERROR_FMT("文件不存在：{1}",  filepath.string());
-            return {};
+            LOG_ERROR_FMT("文件不存在：{0}", filepath.string());
+            return Common::Result<std::vector<char>>::Error(Common::StatusCode::FILE_NOT_FOUND, "文件不存在：" + filepath.string());
         }
 
         std::ifstream ifs(filepath, std::ios::binary | std::ios::ate);
 
         if (!ifs.is_open()) {
-            LOG_ERROR_FMT("文件无法打开：{1}",  filepath.string());
-            return {};
+            LOG_ERROR_FMT("文件无法打开：{0}", filepath.string());
+            return Common::Result<std::vector<char>>::Error(Common::StatusCode::PERMISSION_DENIED, "文件无法打开：" + filepath.string());
         }
 
         std::streamsize size = ifs.tellg();
@@ -28,77 +28,81 @@ namespace RefStorage::Utils {
 
         std::vector<char> buffer(size);
         if (!ifs.read(buffer.data(), size)) {
-            LOG_ERROR_FMT("文件读取失败：{1}",  filepath.string());
-            return {};
+            LOG_ERROR_FMT("文件读取失败：{0}", filepath.string());
+            return Common::Result<std::vector<char>>::Error(Common::StatusCode::ERROR, "文件读取失败：" + filepath.string());
         }
 
-        return buffer;
+        return Common::Result<std::vector<char>>::Success(std::move(buffer));
     }
 
-    bool FileUtils::create_directory(const std::filesystem::path& dirpath) {
+    Common::Result<bool> FileUtils::create_directory(const std::filesystem::path& dirpath) {
         if (dirpath.empty()) {
-            return true;
+            return Common::Result<bool>::Success(false);
         }
 
         try {
-            return std::filesystem::create_directory(dirpath);
+            return Common::Result<bool>::Success(std::filesystem::create_directories(dirpath));
         }catch(const std::filesystem::filesystem_error& e) {
             LOG_ERROR_FMT("创建目录失败：{0}，错误：{1}", dirpath.string(), e.what());
-            return false;
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "创建目录失败：" + dirpath.string() + "，错误：" + e.what());
         }catch (...) {
             LOG_ERROR_FMT("创建目录失败：{0}，未知错误", dirpath.string());
-            return false;
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "创建目录失败：" + dirpath.string());
         }
     }
 
-    bool FileUtils::write_file(const std::filesystem::path& filepath, const void* data, size_t length) {
-        std::string dir = filepath.parent_path().string();
-        if (!dir.empty() && !create_directory(dir)) {
-            LOG_ERROR_FMT("无法为文件创建目录：{0}", dir);
-            return false;
+    Common::Result<bool> FileUtils::write_file(const std::filesystem::path& filepath, const void* data, size_t length) {
+        auto dir = filepath.parent_path();
+        if (!dir.empty()) {
+            auto created = create_directory(dir);
+            if (created.failed()) {
+                LOG_ERROR_FMT("无法为文件创建目录：{0}", dir.string());
+                return created;
+            }
         }
 
         std::ofstream ofs(filepath, std::ios::binary);
         if (!ofs.is_open()) {
             LOG_ERROR_FMT("无法打开文件进行写入：{0}", filepath.string());
-            return false;
+            return Common::Result<bool>::Error(Common::StatusCode::PERMISSION_DENIED, "无法打开文件进行写入：" + filepath.string());
         }
 
         ofs.write(static_cast<const char*>(data), length);
         if (!ofs.good()) {
             LOG_ERROR_FMT("写入数据到文件失败：{0}", filepath.string());
-            return false;
+            return Common::Result<bool>::Error(Common::StatusCode::STORAGE_FULL, "写入数据到文件失败：" + filepath.string());
         }
 
-        LOG_INFO_FMT("成功将数据写入文件：{0}", filepath.string());
-        return true;
+        //批量写入时每条都记录会占满日志，限制为每秒一条（附带期间省略的条数）
+        LOG_INFO_EVERY_MS(1000, Log::Format("成功将数据写入文件：{0}", filepath.string()));
+        return Common::Result<bool>::Success(true);
     }
 
-    bool FileUtils::append_file(const std::filesystem::path& filepath, const void* data, size_t length) {
+    Common::Result<bool> FileUtils::append_file(const std::filesystem::path& filepath, const void* data, size_t length) {
 
         std::ofstream file(filepath, std::ios::binary | std::ios::app);
         if (!file.is_open()) {
-            LOG_ERROR("无法打开文件以追加内容：{0} " + filepath.string());
-            return false;
+            LOG_ERROR_FMT("无法打开文件以追加内容：{0}", filepath.string());
+            return Common::Result<bool>::Error(Common::StatusCode::PERMISSION_DENIED, "无法打开文件以追加内容：" + filepath.string());
         }
 
         file.write(static_cast<const char*>(data), length);
         if (!file.good()) {
-            LOG_ERROR("无法向文件追加数据：{0} " + filepath.string());
-            return false;
+            LOG_ERROR_FMT("无法向文件追加数据：{0}", filepath.string());
+            return Common::Result<bool>::Error(Common::StatusCode::STORAGE_FULL, "无法向文件追加数据：" + filepath.string());
         }
 
-        LOG_INFO_FMT("成功向文件将追加数据：{0}", filepath.string());
-        return true;
+        LOG_INFO_EVERY_MS(1000, Log::Format("成功向文件将追加数据：{0}", filepath.string()));
+        return Common::Result<bool>::Success(true);
 
     }
 
-    bool FileUtils::delete_file(const std::filesystem::path& filepath) {
+    Common::Result<bool> FileUtils::delete_file(const std::filesystem::path& filepath) {
         try {
-            return std::filesystem::remove(filepath);
+            return Common::Result<bool>::Success(std::filesystem::remove(filepath));
         } catch (const std::filesystem::filesystem_error& e) {
             LOG_ERROR_FMT("删除文件失败：{0}，错误：{1}", filepath.string(), e.what());
-            return false;
+            return Common::Result<bool>::Error(Common::StatusCode::ERROR, "删除文件失败：" + filepath.string() + "，错误：" + e.what());
         }
     }
 
@@ -168,7 +172,7 @@ namespace RefStorage::Utils {
                                           std::set<FileInfo>& file_infos,
                                      std::set<DirectoryInfo>& dir_infos) {
         if (!std::filesystem::exists(base_dir) || !std::filesystem::is_directory(base_dir)) {
-            LOG_ERROR_FMT("目录不存在或不是文件夹: {0}", base_dir);
+            LOG_ERROR_FMT("目录不存在或不是文件夹: {0}", base_dir.string());
             throw std::runtime_error("目录不存在或不是文件夹: " + base_dir.string());
         }
 
@@ -205,7 +209,8 @@ namespace RefStorage::Utils {
                 //暂时只考虑文件和文件夹
 
             }catch (std::exception& e) {
-                LOG_ERROR_FMT("警告: 跳过无法访问的条目: {0} ({1})", entry.path(), e.what());
+                //大量条目无法访问时限流：允许突发 20 条，之后平均每秒 5 条
+                LOG_ERROR_RATE(5, 20, Log::Format("警告: 跳过无法访问的条目: {0} ({1})", entry.path().string(), e.what()));
                 continue;
             }
 
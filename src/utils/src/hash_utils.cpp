@@ -118,11 +118,11 @@ namespace RefStorage::Utils {
         HashUtils hashUtils;
 
         if (std::filesystem::is_directory(path)) {
-            LOG_DEBUG("执行了计算文件夹哈希函数");
+            LOG_DEBUG_EVERY_N(1000, "执行了计算文件夹哈希函数");
             return hashUtils.calculateFolderHash(path);
         }
         else if (std::filesystem::is_regular_file(path)) {
-            LOG_DEBUG("执行了计算文件哈希值函数");
+            LOG_DEBUG_EVERY_N(1000, "执行了计算文件哈希值函数");
             return hashUtils.calculateFileHash(path);
         }
         else {
@@ -0,0 +1,35 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//进程退出时的日志库析构顺序：主线程的线程局部 Sink 缓存先于静态 Logger 销毁，
+//Logger 析构中的报告与刷新不得再访问该缓存。添加 Sink 之后立即退出，不再写日志。
+//用法：log_exit_test [sync|async]；以 -fsanitize=address 构建时可检出释放后使用
+
+#include "Log.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+    class NullSink : public Log::Sink {
+    public:
+        void Write(const Log::Message&) override {}
+        void Flush() override {}
+        bool ShouldLog(Log::Level) const override { return true; }
+        void SetFormatter(std::unique_ptr<Log::Formatter>) override {}
+    };
+
+}
+
+int main(int argc, char* argv[])
+{
+    bool async = argc > 1 && std::strcmp(argv[1], "async") == 0;
+
+    auto& logger = Log::Logger::Instance();
+    logger.Initialize(Log::Level::LVL_DEBUG);
+    if (async) {
+        logger.StartAsync();
+    }
+    logger.AddSink(std::make_unique<NullSink>());
+    return 0;
+}
@@ -0,0 +1,124 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//日志基准工具：线程数从 1 倍增到给定的最大值，分别在同步与异步模式下写日志，
+//每一轮报告总吞吐与生产者一侧每次调用的延迟分位数。
+//Sink 丢弃所有记录，只衡量日志库自身（入队、格式化、分发）的开销，不含磁盘 I/O。
+//用法：refstorage_logbench [最大线程数] [每线程条数]
+
+#include "Log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+    //只计数的 Sink
+    class CountingSink : public Log::Sink {
+    public:
+        void Write(const Log::Message&) override { count_.fetch_add(1, std::memory_order_relaxed); }
+        void Flush() override {}
+        bool ShouldLog(Log::Level) const override { return true; }
+        void SetFormatter(std::unique_ptr<Log::Formatter>) override {}
+
+    private:
+        std::atomic<uint64_t> count_{ 0 };
+    };
+
+    //每次调用前后各取一次时钟，结果包含约两次 steady_clock::now() 的开销
+    void produce(int thread, int count, std::vector<uint64_t>& latencies) {
+        latencies.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            auto begin = std::chrono::steady_clock::now();
+            LOG_INFO_FMT("bench thread {0} message {1}", thread, i);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+        }
+    }
+
+    uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+        auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    //跑一轮并打印一行结果；异步模式的吞吐包含等待后台线程写完队列的时间
+    void run(bool async, int threads, int count) {
+        auto& logger = Log::Logger::Instance();
+        if (async) {
+            logger.StartAsync({ 1 << 16, Log::OverflowPolicy::BLOCK });
+        }
+
+        std::vector<std::vector<uint64_t>> latencies(threads);
+        std::vector<std::thread> workers;
+        auto begin = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back(produce, t, count, std::ref(latencies[t]));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        logger.Flush();
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        uint64_t dropped = 0;
+        if (async) {
+            dropped = logger.GetAsyncStats().dropped_messages;
+            logger.StopAsync();
+        }
+
+        std::vector<uint64_t> all;
+        for (auto& list : latencies) {
+            all.insert(all.end(), list.begin(), list.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        auto total = static_cast<double>(threads) * count;
+        std::printf("%-6s %7d %10.2f %8llu %8llu %9llu %10llu %8llu\n", async ? "async" : "sync", threads, total / seconds / 1e6,
+            static_cast<unsigned long long>(percentile(all, 0.50)), static_cast<unsigned long long>(percentile(all, 0.99)),
+            static_cast<unsigned long long>(percentile(all, 0.999)), static_cast<unsigned long long>(all.back()),
+            static_cast<unsigned long long>(dropped));
+    }
+
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    if (argc > 3) {
+        std::cerr << "用法: " << argv[0] << " [最大线程数] [每线程条数]\n";
+        return 2;
+    }
+    int threads = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int count   = argc > 2 ? std::stoi(argv[2]) : 200000;
+    if (threads <= 0 || count <= 0) {
+        std::cerr << "线程数与条数必须为正数\n";
+        return 2;
+    }
+
+    auto& logger = Log::Logger::Instance();
+    logger.Initialize(Log::Level::LVL_INFO);
+    logger.AddSink(std::make_unique<CountingSink>());
+
+    std::printf("%-6s %7s %10s %8s %8s %9s %10s %8s\n", "mode", "threads", "M msg/s", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "dropped");
+    for (bool async : { false, true }) {
+        for (int n = 1; ; n = std::min(n * 2, threads)) {
+            run(async, n, count);
+            if (n == threads) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//二进制日志解码工具：把 BinaryLogSink 写出的文件还原为文本（格式与默认文本日志相同）
+//用法：refstorage_logdecode <二进制日志文件> [输出文件]
+
+#include "Log.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+    //文件中的描述符（与进程内的 LogDescriptor 对应，字符串自行保存）
+    struct DecodedDescriptor {
+        Log::Level  level;
+        uint32_t    line;
+        std::string file;
+        std::string function;
+        std::string format;
+        std::string arg_types;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::istream& input) : input_(input) {}
+
+        template<typename T>
+        bool read(T& value) {
+            return static_cast<bool>(input_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        bool read_string(std::string& value) {
+            uint32_t size = 0;
+            if (!read(size)) {
+                return false;
+            }
+            value.resize(size);
+            return size == 0 || static_cast<bool>(input_.read(value.data(), size));
+        }
+
+        bool read_bytes(std::string& value, uint32_t size) {
+            value.resize(size);
+            return size == 0 || static_cast<bool>(input_.read(value.data(), size));
+        }
+
+        int peek() { return input_.peek(); }
+
+    private:
+        std::istream& input_;
+    };
+
+    //单个文件头之后的时间基准：steady 纳秒换算为 system_clock 纳秒
+    struct TimeBase {
+        uint64_t system_ns = 0;
+        uint64_t steady_ns = 0;
+
+        int64_t to_system(uint64_t steady) const {
+            return static_cast<int64_t>(system_ns) + (static_cast<int64_t>(steady) - static_cast<int64_t>(steady_ns));
+        }
+    };
+
+    void write_line(std::ostream& out, int64_t system_ns, Log::Level level, uint32_t thread,
+                    const std::string& file, uint32_t line, const std::string& function, const std::string& content) {
+        auto seconds     = system_ns / 1000000000;
+        auto millisecond = (system_ns / 1000000) % 1000;
+        if (millisecond < 0) {
+            --seconds;
+            millisecond += 1000;
+        }
+
+        auto   time = static_cast<std::time_t>(seconds);
+        std::tm tm_buf;
+#ifdef _WIN32
+        localtime_s(&tm_buf, &time);
+#else
+        localtime_r(&time, &tm_buf);
+#endif
+        char stamp[32];
+        auto length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        std::snprintf(stamp + length, sizeof(stamp) - length, ".%03d", static_cast<int>(millisecond));
+
+        out << Log::Format("{} [{}] [{}] [{}:{}:{}] {}\n", stamp, Log::LevelToString(level), thread,
+                           Log::SourceFileName(file.c_str()), line, function, content);
+    }
+
+    //返回 0 成功，1 文件格式错误
+    int decode(std::istream& input, std::ostream& out) {
+        Reader   reader(input);
+        TimeBase time_base;
+        bool     has_header = false;
+        std::unordered_map<uint32_t, DecodedDescriptor> descriptors;
+        std::vector<std::string> args;
+        std::string payload;
+
+        while (reader.peek() != std::char_traits<char>::eof()) {
+            //文件头：每次打开文件时写入，之后的描述符编号与时间基准重新开始
+            if (reader.peek() == Log::binary::kMagic[0]) {
+                char     magic[sizeof(Log::binary::kMagic)];
+                uint32_t byte_order = 0;
+                if (!reader.read(magic) || std::memcmp(magic, Log::binary::kMagic, sizeof(magic)) != 0
+                    || !reader.read(byte_order) || !reader.read(time_base.system_ns) || !reader.read(time_base.steady_ns)) {
+                    std::cerr << "文件头损坏\n";
+                    return 1;
+                }
+                if (byte_order != Log::binary::kByteOrderMark) {
+                    std::cerr << "文件由字节序不同的机器写出，无法解码\n";
+                    return 1;
+                }
+                descriptors.clear();
+                has_header = true;
+                continue;
+            }
+            if (!has_header) {
+                std::cerr << "不是二进制日志文件\n";
+                return 1;
+            }
+
+            Log::binary::RecordType type;
+            if (!reader.read(type)) {
+                break;
+            }
+
+            if (type == Log::binary::RecordType::DESCRIPTOR) {
+                uint32_t          id = 0;
+                DecodedDescriptor descriptor;
+                if (!reader.read(id) || !reader.read(descriptor.level) || !reader.read(descriptor.line)
+                    || !reader.read_string(descriptor.file) || !reader.read_string(descriptor.function)
+                    || !reader.read_string(descriptor.format) || !reader.read_string(descriptor.arg_types)) {
+                    std::cerr << "描述符记录不完整（文件可能被截断）\n";
+                    return 1;
+                }
+                descriptors[id] = std::move(descriptor);
+            } else if (type == Log::binary::RecordType::EVENT) {
+                uint32_t id = 0, thread = 0, size = 0;
+                uint64_t steady_ns = 0;
+                if (!reader.read(id) || !reader.read(steady_ns) || !reader.read(thread) || !reader.read(size)
+                    || !reader.read_bytes(payload, size)) {
+                    std::cerr << "事件记录不完整（文件可能被截断）\n";
+                    return 1;
+                }
+
+                auto it = descriptors.find(id);
+                if (it == descriptors.end()) {
+                    std::cerr << "未知的描述符编号：" << id << '\n';
+                    return 1;
+                }
+                const auto& descriptor = it->second;
+                std::string content;
+                if (Log::binary::DecodeArgs(descriptor.arg_types, payload, args)) {
+                    content = Log::binary::Render(descriptor.format, args);
+                } else {
+                    content = "<参数解码失败> " + descriptor.format;
+                }
+                write_line(out, time_base.to_system(steady_ns), descriptor.level, thread, descriptor.file,
+                           descriptor.line, descriptor.function, content);
+            } else if (type == Log::binary::RecordType::TEXT) {
+                Log::Level  level;
+                uint64_t    steady_ns = 0;
+                uint32_t    thread = 0, line = 0;
+                std::string file, function;
+                if (!reader.read(level) || !reader.read(steady_ns) || !reader.read(thread) || !reader.read(line)
+                    || !reader.read_string(file) || !reader.read_string(function) || !reader.read_string(payload)) {
+                    std::cerr << "文本记录不完整（文件可能被截断）\n";
+                    return 1;
+                }
+                write_line(out, time_base.to_system(steady_ns), level, thread, file, line, function, payload);
+            } else {
+                std::cerr << "未知的记录类型：" << static_cast<int>(type) << '\n';
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    if (argc != 2 && argc != 3) {
+        std::cerr << "用法: " << argv[0] << " <二进制日志文件> [输出文件]\n";
+        return 2;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "无法打开文件: " << argv[1] << '\n';
+        return 1;
+    }
+
+    if (argc == 3) {
+        std::ofstream output(argv[2]);
+        if (!output.is_open()) {
+            std::cerr << "无法创建文件: " << argv[2] << '\n';
+            return 1;
+        }
+        return decode(input, output);
+    }
+    return decode(input, std::cout);
+}
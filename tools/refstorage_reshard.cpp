@@ -0,0 +1,48 @@
+//Copyright (c) 2026 Liu Kaizhi
+//Licensed under the Apache License, Version 2.0.
+
+//元数据分库重新切分工具（需在服务停止时运行）
+//用法：refstorage_reshard <分库目录> <旧分库数> <新分库数>
+
+#include "Log.hpp"
+#include "sharded_metadata_store.hpp"
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    auto& logger = Log::Logger::Instance();
+    logger.Initialize(Log::Level::LVL_INFO);
+    logger.AddConsoleSink(Log::Level::LVL_INFO, true);
+
+    if (argc != 4) {
+        std::cerr << "用法: " << argv[0] << " <分库目录> <旧分库数> <新分库数>\n";
+        return 2;
+    }
+
+    int exitCode = 0;
+
+    try {
+        std::filesystem::path directory = argv[1];
+        auto old_count = static_cast<uint32_t>(std::stoul(argv[2]));
+        auto new_count = static_cast<uint32_t>(std::stoul(argv[3]));
+
+        auto result = RefStorage::DataBase::ShardedMetadataStore::reshard(directory, old_count, new_count);
+        if (result.failed()) {
+            std::cerr << "重新切分失败: " << result.message() << '\n';
+            exitCode = 1;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "标准异常: " << e.what() << '\n';
+        exitCode = 100;
+    }
+
+    return exitCode;
+}